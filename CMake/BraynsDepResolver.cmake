@@ -13,6 +13,7 @@ endif()
 # ZeroEQ and HTTP messaging
 if(BRAYNS_NETWORKING_ENABLED)
   common_find_package(LibJpegTurbo REQUIRED)
+  common_find_package(ZLIB SYSTEM)
 endif()
 
 # Streaming to display walls
@@ -0,0 +1,87 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CameraPath.h"
+
+#include <brayns/common/log.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace brayns
+{
+bool CameraPath::load(const std::string& filename)
+{
+    _keyframes.clear();
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        BRAYNS_ERROR << "Failed to open camera path " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream stream(line);
+        CameraKeyframe keyframe;
+        stream >> keyframe.position.x() >> keyframe.position.y() >>
+            keyframe.position.z() >> keyframe.target.x() >>
+            keyframe.target.y() >> keyframe.target.z() >> keyframe.up.x() >>
+            keyframe.up.y() >> keyframe.up.z();
+        if (!stream)
+        {
+            BRAYNS_ERROR << "Invalid camera keyframe at line " << lineNumber
+                         << " of " << filename << std::endl;
+            _keyframes.clear();
+            return false;
+        }
+        _keyframes.push_back(keyframe);
+    }
+
+    BRAYNS_INFO << "Loaded " << _keyframes.size() << " camera keyframes from "
+                << filename << std::endl;
+    return !_keyframes.empty();
+}
+
+CameraKeyframe CameraPath::get(const float t) const
+{
+    if (_keyframes.size() < 2)
+        return _keyframes.empty() ? CameraKeyframe() : _keyframes[0];
+
+    const float position =
+        std::min(std::max(t, 0.f), 1.f) * (_keyframes.size() - 1);
+    const size_t index = std::min(size_t(position), _keyframes.size() - 2);
+    const float alpha = position - index;
+
+    const auto& k0 = _keyframes[index];
+    const auto& k1 = _keyframes[index + 1];
+    CameraKeyframe keyframe;
+    keyframe.position = k0.position * (1.f - alpha) + k1.position * alpha;
+    keyframe.target = k0.target * (1.f - alpha) + k1.target * alpha;
+    keyframe.up = k0.up * (1.f - alpha) + k1.up * alpha;
+    return keyframe;
+}
+}
@@ -0,0 +1,66 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CAMERAPATH_H
+#define CAMERAPATH_H
+
+#include <brayns/common/types.h>
+
+namespace brayns
+{
+struct CameraKeyframe
+{
+    Vector3f position;
+    Vector3f target;
+    Vector3f up;
+};
+
+/**
+   Camera path defined by a list of keyframes. Keyframes are read from a text
+   file containing one keyframe per line, in the form of 9 floats: position,
+   target and up vector. Empty lines and lines starting with # are ignored.
+ */
+class CameraPath
+{
+public:
+    /**
+     * @brief Loads the keyframes from a file
+     * @return True if at least one keyframe was loaded, false otherwise
+     */
+    bool load(const std::string& filename);
+
+    bool empty() const { return _keyframes.empty(); }
+    const std::vector<CameraKeyframe>& getKeyframes() const
+    {
+        return _keyframes;
+    }
+
+    /**
+     * @brief Returns the camera at the given position of the path. Keyframes
+     *        are evenly distributed along the path and linearly interpolated
+     * @param t Position along the path, between 0 and 1
+     */
+    CameraKeyframe get(float t) const;
+
+private:
+    std::vector<CameraKeyframe> _keyframes;
+};
+}
+#endif // CAMERAPATH_H
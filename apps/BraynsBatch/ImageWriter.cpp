@@ -0,0 +1,320 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ImageWriter.h"
+
+#include <brayns/common/log.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+
+#if BRAYNS_USE_LIBJPEGTURBO
+#include <turbojpeg.h>
+#endif
+
+namespace brayns
+{
+namespace
+{
+std::string getPPMHeader(const Vector2ui& size)
+{
+    std::ostringstream header;
+    header << "P6\n" << size.x() << " " << size.y() << "\n255\n";
+    return header.str();
+}
+
+/** Converts the y-th row from the top of the image to packed RGB */
+template <typename Image>
+void convertRowToRGB(const Image& image, const size_t pixelSize,
+                     const size_t y, std::vector<char>& row)
+{
+    const size_t width = image.size.x();
+    const bool bgr = image.format == FrameBufferFormat::FBF_BGRA_I8;
+
+    // Frame buffer rows are stored bottom-up
+    const uint8_t* src =
+        image.data.data() + (image.size.y() - 1 - y) * width * pixelSize;
+    for (size_t x = 0; x < width; ++x)
+    {
+        const uint8_t* pixel = src + x * pixelSize;
+        row[x * 3] = pixel[bgr ? 2 : 0];
+        row[x * 3 + 1] = pixel[1];
+        row[x * 3 + 2] = pixel[bgr ? 0 : 2];
+    }
+}
+}
+
+ImageWriter::ImageWriter(const size_t nbThreads, const size_t maxQueuedImages,
+                         const size_t jpegQuality)
+    : _maxQueuedImages(std::max(maxQueuedImages, size_t(1)))
+    , _jpegQuality(jpegQuality)
+    , _nbBusyThreads(0)
+    , _nbErrors(0)
+    , _stop(false)
+{
+    for (size_t i = 0; i < std::max(nbThreads, size_t(1)); ++i)
+        _threads.push_back(std::thread(&ImageWriter::_run, this));
+}
+
+ImageWriter::~ImageWriter()
+{
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+void ImageWriter::write(const std::string& filename, uint8_ts data,
+                        const Vector2ui& size, const FrameBufferFormat format)
+{
+    _push(Image{filename, std::move(data), size, format, Vector2ui(),
+                Vector2ui()});
+}
+
+bool ImageWriter::createPPM(const std::string& filename, const Vector2ui& size)
+{
+    {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open())
+        {
+            BRAYNS_ERROR << "Failed to create " << filename << std::endl;
+            return false;
+        }
+        file << getPPMHeader(size);
+        if (!file.good())
+            return false;
+    }
+
+    // Pixels are left as a sparse region of the file, filled tile by tile
+    boost::system::error_code error;
+    boost::filesystem::resize_file(filename,
+                                   getPPMHeader(size).size() +
+                                       size_t(size.x()) * size.y() * 3,
+                                   error);
+    if (error)
+    {
+        BRAYNS_ERROR << "Failed to allocate " << filename << ": "
+                     << error.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ImageWriter::writeTile(const std::string& filename, uint8_ts data,
+                            const Vector2ui& size, const Vector2ui& origin,
+                            const Vector2ui& imageSize,
+                            const FrameBufferFormat format)
+{
+    _push(Image{filename, std::move(data), size, format, origin, imageSize});
+}
+
+void ImageWriter::_push(Image image)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock,
+                    [this] { return _images.size() < _maxQueuedImages; });
+    _images.push_back(std::move(image));
+    _condition.notify_all();
+}
+
+void ImageWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock,
+                    [this] { return _images.empty() && _nbBusyThreads == 0; });
+}
+
+void ImageWriter::_run()
+{
+    for (;;)
+    {
+        Image image;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this] { return _stop || !_images.empty(); });
+            if (_images.empty())
+                return;
+            image = std::move(_images.front());
+            _images.pop_front();
+            ++_nbBusyThreads;
+        }
+        _condition.notify_all();
+
+        const bool success = _write(image);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_nbBusyThreads;
+            if (!success)
+                ++_nbErrors;
+        }
+        _condition.notify_all();
+    }
+}
+
+bool ImageWriter::_write(const Image& image)
+{
+    size_t pixelSize = 0;
+    switch (image.format)
+    {
+    case FrameBufferFormat::FBF_RGBA_I8:
+    case FrameBufferFormat::FBF_BGRA_I8:
+        pixelSize = 4;
+        break;
+    case FrameBufferFormat::FBF_RGB_I8:
+        pixelSize = 3;
+        break;
+    default:
+        BRAYNS_ERROR << "Unsupported frame buffer format for "
+                     << image.filename << std::endl;
+        return false;
+    }
+
+    if (image.data.size() < image.size.x() * image.size.y() * pixelSize)
+    {
+        BRAYNS_ERROR << "Invalid image size for " << image.filename
+                     << std::endl;
+        return false;
+    }
+
+    const bool tile = image.imageSize.x() != 0;
+    if (tile)
+    {
+        if (image.origin.x() + image.size.x() > image.imageSize.x() ||
+            image.origin.y() + image.size.y() > image.imageSize.y())
+        {
+            BRAYNS_ERROR << "Tile outside of " << image.filename << std::endl;
+            return false;
+        }
+        return _writePPMTile(image, pixelSize);
+    }
+
+    if (boost::algorithm::iends_with(image.filename, ".jpg") ||
+        boost::algorithm::iends_with(image.filename, ".jpeg"))
+    {
+#if BRAYNS_USE_LIBJPEGTURBO
+        return _writeJPEG(image, pixelSize);
+#else
+        BRAYNS_ERROR << "libjpeg-turbo is required to write "
+                     << image.filename << std::endl;
+        return false;
+#endif
+    }
+    return _writePPM(image, pixelSize);
+}
+
+bool ImageWriter::_writePPM(const Image& image, const size_t pixelSize)
+{
+    std::ofstream file(image.filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        BRAYNS_ERROR << "Failed to open " << image.filename << std::endl;
+        return false;
+    }
+
+    file << getPPMHeader(image.size);
+
+    const size_t width = image.size.x();
+    const size_t height = image.size.y();
+    std::vector<char> row(width * 3);
+    for (size_t y = 0; y < height; ++y)
+    {
+        convertRowToRGB(image, pixelSize, y, row);
+        file.write(row.data(), row.size());
+    }
+    return file.good();
+}
+
+bool ImageWriter::_writePPMTile(const Image& image, const size_t pixelSize)
+{
+    std::fstream file(image.filename,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.is_open())
+    {
+        BRAYNS_ERROR << "Failed to open " << image.filename << std::endl;
+        return false;
+    }
+
+    const size_t headerSize = getPPMHeader(image.imageSize).size();
+    const size_t imageWidth = image.imageSize.x();
+    std::vector<char> row(image.size.x() * 3);
+    for (size_t y = 0; y < image.size.y(); ++y)
+    {
+        convertRowToRGB(image, pixelSize, y, row);
+        const size_t offset =
+            headerSize +
+            ((image.origin.y() + y) * imageWidth + image.origin.x()) * 3;
+        file.seekp(offset);
+        file.write(row.data(), row.size());
+    }
+    return file.good();
+}
+
+#if BRAYNS_USE_LIBJPEGTURBO
+bool ImageWriter::_writeJPEG(const Image& image, const size_t pixelSize)
+{
+    int32_t pixelFormat = TJPF_RGBA;
+    switch (image.format)
+    {
+    case FrameBufferFormat::FBF_BGRA_I8:
+        pixelFormat = TJPF_BGRA;
+        break;
+    case FrameBufferFormat::FBF_RGB_I8:
+        pixelFormat = TJPF_RGB;
+        break;
+    default:
+        pixelFormat = TJPF_RGBA;
+    }
+
+    tjhandle compressor = tjInitCompress();
+    uint8_t* jpegData = nullptr;
+    unsigned long jpegSize = 0;
+    const int32_t success =
+        tjCompress2(compressor, const_cast<uint8_t*>(image.data.data()),
+                    image.size.x(), image.size.x() * pixelSize,
+                    image.size.y(), pixelFormat, &jpegData, &jpegSize,
+                    TJSAMP_444, _jpegQuality, TJFLAG_BOTTOMUP);
+    tjDestroy(compressor);
+    if (success != 0)
+    {
+        BRAYNS_ERROR << "libjpeg-turbo image conversion failure" << std::endl;
+        return false;
+    }
+
+    std::ofstream file(image.filename, std::ios::binary);
+    if (file.is_open())
+        file.write(reinterpret_cast<const char*>(jpegData), jpegSize);
+    tjFree(jpegData);
+    if (!file.good())
+    {
+        BRAYNS_ERROR << "Failed to write " << image.filename << std::endl;
+        return false;
+    }
+    return true;
+}
+#endif
+}
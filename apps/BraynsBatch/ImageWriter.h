@@ -0,0 +1,122 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGEWRITER_H
+#define IMAGEWRITER_H
+
+#include <brayns/common/types.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace brayns
+{
+/**
+   Writes images to disk from a pool of background threads, so that
+   rendering is not slowed down by compression and file system accesses. The
+   file format is deduced from the file extension: .ppm is always supported,
+   .jpg requires libjpeg-turbo. Images too large to be held in memory can be
+   assembled tile by tile into a PPM file.
+ */
+class ImageWriter
+{
+public:
+    /**
+     * @param nbThreads Number of writer threads
+     * @param maxQueuedImages Maximum number of images waiting to be written.
+     *        write() blocks when this limit is reached
+     * @param jpegQuality Quality of JPEG images, between 0 and 100
+     */
+    ImageWriter(size_t nbThreads, size_t maxQueuedImages, size_t jpegQuality);
+
+    /** Waits for all queued images to be written */
+    ~ImageWriter();
+
+    /**
+     * @brief Queues an image for writing
+     * @param filename Destination file
+     * @param data Pixels, with rows stored bottom-up as in frame buffers
+     * @param size Image size in pixels
+     * @param format Pixel format of data
+     */
+    void write(const std::string& filename, uint8_ts data,
+               const Vector2ui& size, FrameBufferFormat format);
+
+    /**
+     * @brief Creates a PPM image of the given size, to be filled by
+     *        writeTile(). Pixels are not initialized.
+     * @return True if the file was created, false otherwise
+     */
+    static bool createPPM(const std::string& filename, const Vector2ui& size);
+
+    /**
+     * @brief Queues a tile for writing into an image created by createPPM()
+     * @param filename Destination file
+     * @param data Pixels, with rows stored bottom-up as in frame buffers
+     * @param size Tile size in pixels
+     * @param origin Position of the top left corner of the tile in the image
+     * @param imageSize Size of the full image in pixels
+     * @param format Pixel format of data
+     */
+    void writeTile(const std::string& filename, uint8_ts data,
+                   const Vector2ui& size, const Vector2ui& origin,
+                   const Vector2ui& imageSize, FrameBufferFormat format);
+
+    /** Waits for all queued images to be written */
+    void flush();
+
+    /** Number of images that could not be written */
+    size_t getNbErrors() const { return _nbErrors; }
+
+private:
+    struct Image
+    {
+        std::string filename;
+        uint8_ts data;
+        Vector2ui size;
+        FrameBufferFormat format;
+        // Only set for tiles
+        Vector2ui origin;
+        Vector2ui imageSize;
+    };
+
+    void _push(Image image);
+    void _run();
+    bool _write(const Image& image);
+    bool _writePPM(const Image& image, size_t pixelSize);
+    bool _writePPMTile(const Image& image, size_t pixelSize);
+#if BRAYNS_USE_LIBJPEGTURBO
+    bool _writeJPEG(const Image& image, size_t pixelSize);
+#endif
+
+    const size_t _maxQueuedImages;
+    const size_t _jpegQuality;
+    std::deque<Image> _images;
+    size_t _nbBusyThreads;
+    size_t _nbErrors;
+    bool _stop;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<std::thread> _threads;
+};
+}
+#endif // IMAGEWRITER_H
@@ -0,0 +1,384 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CameraPath.h"
+#include "ImageWriter.h"
+
+#include <brayns/Brayns.h>
+#include <brayns/common/camera/Camera.h>
+#include <brayns/common/engine/Engine.h>
+#include <brayns/common/log.h>
+#include <brayns/common/renderer/FrameBuffer.h>
+#include <brayns/common/types.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <csignal>
+#include <iomanip>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace po = boost::program_options;
+
+namespace
+{
+const std::string PARAM_CAMERA_PATH = "camera-path";
+const std::string PARAM_FRAMES = "frames";
+const std::string PARAM_TIMESTAMP_RANGE = "timestamp-range";
+const std::string PARAM_ACCUMULATION_SAMPLES = "accumulation-samples";
+const std::string PARAM_OUTPUT_FOLDER = "output-folder";
+const std::string PARAM_OUTPUT_FORMAT = "output-format";
+const std::string PARAM_WRITER_THREADS = "writer-threads";
+const std::string PARAM_INSTANCES = "instances";
+const std::string PARAM_TILED_IMAGE_SIZE = "tiled-image-size";
+
+const size_t DEFAULT_ACCUMULATION_SAMPLES = 64;
+const std::string DEFAULT_OUTPUT_FOLDER = ".";
+const std::string DEFAULT_OUTPUT_FORMAT = "ppm";
+const size_t DEFAULT_WRITER_THREADS = 2;
+
+struct BatchParameters
+{
+    std::string cameraPath;
+    size_t firstFrame = 0;
+    size_t lastFrame = 0;
+    bool useTimestampRange = false;
+    float firstTimestamp = 0.f;
+    float lastTimestamp = 0.f;
+    size_t accumulationSamples = DEFAULT_ACCUMULATION_SAMPLES;
+    std::string outputFolder = DEFAULT_OUTPUT_FOLDER;
+    std::string outputFormat = DEFAULT_OUTPUT_FORMAT;
+    size_t writerThreads = DEFAULT_WRITER_THREADS;
+    size_t instances = 1;
+    brayns::Vector2ui tiledImageSize;
+};
+
+bool parseBatchParameters(int argc, const char** argv,
+                          BatchParameters& parameters)
+{
+    po::options_description options("Batch");
+    options.add_options()(PARAM_CAMERA_PATH.c_str(), po::value<std::string>(),
+                          "Camera keyframes file [string]")(
+        PARAM_FRAMES.c_str(), po::value<brayns::uints>()->multitoken(),
+        "First and last frames to render [int int]")(
+        PARAM_TIMESTAMP_RANGE.c_str(),
+        po::value<brayns::floats>()->multitoken(),
+        "Timestamps of the first and last frames, defaults to the frame "
+        "numbers [float float]")(
+        PARAM_ACCUMULATION_SAMPLES.c_str(), po::value<size_t>(),
+        "Samples per pixel accumulated for each frame [int]")(
+        PARAM_OUTPUT_FOLDER.c_str(), po::value<std::string>(),
+        "Folder where frames are written [string]")(
+        PARAM_OUTPUT_FORMAT.c_str(), po::value<std::string>(),
+        "Image format, ppm or jpg [string]")(
+        PARAM_WRITER_THREADS.c_str(), po::value<size_t>(),
+        "Number of threads writing images [int]")(
+        PARAM_INSTANCES.c_str(), po::value<size_t>(),
+        "Number of processes rendering frames in parallel [int]")(
+        PARAM_TILED_IMAGE_SIZE.c_str(),
+        po::value<brayns::uints>()->multitoken(),
+        "Size of images rendered tile by tile, using the window size as tile "
+        "size. Output format must be ppm [int int]");
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv)
+                      .options(options)
+                      .style(po::command_line_style::unix_style ^
+                             po::command_line_style::allow_short)
+                      .allow_unregistered()
+                      .run(),
+                  vm);
+        po::notify(vm);
+
+        if (vm.count(PARAM_CAMERA_PATH))
+            parameters.cameraPath = vm[PARAM_CAMERA_PATH].as<std::string>();
+        if (vm.count(PARAM_FRAMES))
+        {
+            const auto values = vm[PARAM_FRAMES].as<brayns::uints>();
+            if (values.size() != 2 || values[0] > values[1])
+            {
+                BRAYNS_ERROR << "Invalid frame range" << std::endl;
+                return false;
+            }
+            parameters.firstFrame = values[0];
+            parameters.lastFrame = values[1];
+        }
+        if (vm.count(PARAM_TIMESTAMP_RANGE))
+        {
+            const auto values = vm[PARAM_TIMESTAMP_RANGE].as<brayns::floats>();
+            if (values.size() != 2)
+            {
+                BRAYNS_ERROR << "Invalid timestamp range" << std::endl;
+                return false;
+            }
+            parameters.useTimestampRange = true;
+            parameters.firstTimestamp = values[0];
+            parameters.lastTimestamp = values[1];
+        }
+        if (vm.count(PARAM_ACCUMULATION_SAMPLES))
+            parameters.accumulationSamples =
+                vm[PARAM_ACCUMULATION_SAMPLES].as<size_t>();
+        if (vm.count(PARAM_OUTPUT_FOLDER))
+            parameters.outputFolder = vm[PARAM_OUTPUT_FOLDER].as<std::string>();
+        if (vm.count(PARAM_OUTPUT_FORMAT))
+            parameters.outputFormat = vm[PARAM_OUTPUT_FORMAT].as<std::string>();
+        if (vm.count(PARAM_WRITER_THREADS))
+            parameters.writerThreads = vm[PARAM_WRITER_THREADS].as<size_t>();
+        if (vm.count(PARAM_INSTANCES))
+            parameters.instances =
+                std::max(vm[PARAM_INSTANCES].as<size_t>(), size_t(1));
+        if (vm.count(PARAM_TILED_IMAGE_SIZE))
+        {
+            const auto values = vm[PARAM_TILED_IMAGE_SIZE].as<brayns::uints>();
+            if (values.size() != 2 || values[0] == 0 || values[1] == 0)
+            {
+                BRAYNS_ERROR << "Invalid tiled image size" << std::endl;
+                return false;
+            }
+            if (parameters.outputFormat != "ppm")
+            {
+                BRAYNS_ERROR << "Tiled images can only be written as ppm"
+                             << std::endl;
+                return false;
+            }
+            parameters.tiledImageSize =
+                brayns::Vector2ui(values[0], values[1]);
+        }
+    }
+    catch (po::error& e)
+    {
+        BRAYNS_ERROR << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string getFrameFilename(const BatchParameters& parameters,
+                             const size_t frame)
+{
+    std::ostringstream filename;
+    filename << parameters.outputFolder << "/frame_" << std::setw(5)
+             << std::setfill('0') << frame << "." << parameters.outputFormat;
+    return filename.str();
+}
+
+/**
+ * Renders every nbInstances-th tile of the frame range, starting at the given
+ * instance, and writes the converged images to the output folder. Without
+ * tiled images, each frame is a single tile covering the whole window.
+ */
+int renderFrames(int argc, const char** argv,
+                 const BatchParameters& parameters, const size_t instance)
+{
+    brayns::CameraPath cameraPath;
+    if (!parameters.cameraPath.empty() &&
+        !cameraPath.load(parameters.cameraPath))
+        return 1;
+
+    // Batch instances run headless, without any HTTP server or stream that
+    // several of them would otherwise compete for
+    std::vector<const char*> braynsArgv(argv, argv + argc);
+    braynsArgv.push_back("--network-plugins");
+    braynsArgv.push_back("0");
+    brayns::Brayns brayns(int(braynsArgv.size()), braynsArgv.data());
+    auto& engine = brayns.getEngine();
+    auto& parametersManager = brayns.getParametersManager();
+    const auto& applicationParameters =
+        parametersManager.getApplicationParameters();
+    auto& sceneParameters = parametersManager.getSceneParameters();
+
+    const size_t samplesPerPass = std::max(
+        parametersManager.getRenderingParameters().getSamplesPerPixel(),
+        size_t(1));
+    const size_t nbPasses =
+        std::max((parameters.accumulationSamples + samplesPerPass - 1) /
+                     samplesPerPass,
+                 size_t(1));
+
+    brayns::ImageWriter writer(parameters.writerThreads,
+                               2 * parameters.writerThreads,
+                               applicationParameters.getJpegCompression());
+
+    // The frame buffer never exceeds the window size, whatever the size of
+    // tiled images
+    const auto& windowSize = applicationParameters.getWindowSize();
+    const bool tiled = parameters.tiledImageSize.x() != 0;
+    const brayns::Vector2ui imageSize =
+        tiled ? parameters.tiledImageSize : windowSize;
+    const brayns::Vector2ui nbTiles(
+        (imageSize.x() + windowSize.x() - 1) / windowSize.x(),
+        (imageSize.y() + windowSize.y() - 1) / windowSize.y());
+    const size_t nbTilesPerFrame = nbTiles.x() * nbTiles.y();
+
+    brayns::RenderInput renderInput;
+    brayns::RenderOutput renderOutput;
+
+    const size_t nbFrames = parameters.lastFrame - parameters.firstFrame;
+    const size_t nbItems = (nbFrames + 1) * nbTilesPerFrame;
+    for (size_t item = instance; item < nbItems; item += parameters.instances)
+    {
+        const size_t frame = parameters.firstFrame + item / nbTilesPerFrame;
+        const size_t tile = item % nbTilesPerFrame;
+        const float t =
+            nbFrames == 0 ? 0.f : float(frame - parameters.firstFrame) /
+                                      float(nbFrames);
+
+        auto& camera = engine.getCamera();
+        if (cameraPath.empty())
+        {
+            renderInput.position = camera.getPosition();
+            renderInput.target = camera.getTarget();
+            renderInput.up = camera.getUp();
+        }
+        else
+        {
+            const auto keyframe = cameraPath.get(t);
+            renderInput.position = keyframe.position;
+            renderInput.target = keyframe.target;
+            renderInput.up = keyframe.up;
+        }
+
+        // Tile origins are given from the top left corner of the image, the
+        // camera window from the bottom left one
+        const brayns::Vector2ui origin((tile % nbTiles.x()) * windowSize.x(),
+                                       (tile / nbTiles.x()) * windowSize.y());
+        const brayns::Vector2ui tileSize(
+            std::min(windowSize.x(), imageSize.x() - origin.x()),
+            std::min(windowSize.y(), imageSize.y() - origin.y()));
+        const brayns::Vector2f imageSizef(imageSize.x(), imageSize.y());
+        camera.setWindow(
+            brayns::Vector2f(origin.x() / imageSizef.x(),
+                             1.f - (origin.y() + tileSize.y()) /
+                                       imageSizef.y()),
+            brayns::Vector2f((origin.x() + tileSize.x()) / imageSizef.x(),
+                             1.f - origin.y() / imageSizef.y()));
+        renderInput.windowSize = brayns::Vector2i(tileSize.x(), tileSize.y());
+
+        sceneParameters.setTimestamp(
+            parameters.useTimestampRange
+                ? parameters.firstTimestamp +
+                      t * (parameters.lastTimestamp -
+                           parameters.firstTimestamp)
+                : float(frame));
+
+        engine.reshape(tileSize);
+        engine.getFrameBuffer().clear();
+        for (size_t pass = 0; pass < nbPasses; ++pass)
+            brayns.render(renderInput, renderOutput);
+
+        const auto filename = getFrameFilename(parameters, frame);
+        if (tiled)
+        {
+            writer.writeTile(filename, std::move(renderOutput.colorBuffer),
+                             tileSize, origin, imageSize,
+                             renderOutput.colorBufferFormat);
+            BRAYNS_INFO << "Frame " << frame << ", tile " << tile + 1 << "/"
+                        << nbTilesPerFrame << " rendered with "
+                        << nbPasses * samplesPerPass << " samples per pixel"
+                        << std::endl;
+        }
+        else
+        {
+            writer.write(filename, std::move(renderOutput.colorBuffer),
+                         tileSize, renderOutput.colorBufferFormat);
+            BRAYNS_INFO << "Frame " << frame << " rendered with "
+                        << nbPasses * samplesPerPass << " samples per pixel"
+                        << std::endl;
+        }
+        renderOutput.colorBuffer.clear();
+    }
+
+    writer.flush();
+    return writer.getNbErrors() == 0 ? 0 : 1;
+}
+}
+
+int main(int argc, const char** argv)
+{
+    try
+    {
+        BatchParameters parameters;
+        if (!parseBatchParameters(argc, argv, parameters))
+            return 1;
+
+        boost::filesystem::create_directories(parameters.outputFolder);
+
+        // Tiled images are allocated upfront so that all instances can write
+        // their tiles in place
+        if (parameters.tiledImageSize.x() != 0)
+            for (size_t frame = parameters.firstFrame;
+                 frame <= parameters.lastFrame; ++frame)
+                if (!brayns::ImageWriter::createPPM(
+                        getFrameFilename(parameters, frame),
+                        parameters.tiledImageSize))
+                    return 1;
+
+        // Each instance is a separate process owning its own engine, which
+        // renders an interleaved subset of the frames or tiles
+        std::vector<pid_t> children;
+        size_t instance = 0;
+        for (size_t i = 1; i < parameters.instances; ++i)
+        {
+            const pid_t pid = fork();
+            if (pid == 0)
+            {
+                instance = i;
+                children.clear();
+                break;
+            }
+            if (pid < 0)
+            {
+                // The frames of the missing instance would never be rendered
+                BRAYNS_ERROR << "Failed to start batch instance " << i
+                             << std::endl;
+                for (const auto child : children)
+                {
+                    kill(child, SIGTERM);
+                    waitpid(child, nullptr, 0);
+                }
+                return 1;
+            }
+            children.push_back(pid);
+        }
+
+        BRAYNS_INFO << "Initializing batch instance " << instance << "..."
+                    << std::endl;
+        int status = renderFrames(argc, argv, parameters, instance);
+
+        for (const auto pid : children)
+        {
+            int childStatus = 0;
+            waitpid(pid, &childStatus, 0);
+            if (!WIFEXITED(childStatus) || WEXITSTATUS(childStatus) != 0)
+                status = 1;
+        }
+        return status;
+    }
+    catch (const std::runtime_error& e)
+    {
+        BRAYNS_ERROR << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,236 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkScene.h"
+
+#include <brayns/common/geometry/Cone.h>
+#include <brayns/common/geometry/Cylinder.h>
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/common/geometry/TrianglesMesh.h>
+#include <brayns/common/log.h>
+#include <brayns/common/scene/Scene.h>
+#include <brayns/common/simulation/CircuitSimulationHandler.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#include <cmath>
+#include <fstream>
+#include <random>
+
+namespace brayns
+{
+namespace
+{
+// Materials used by the procedural geometry, below the system materials
+const size_t NB_MATERIALS = 64;
+const size_t FIRST_MATERIAL = 1;
+const float SCENE_SIZE = 100.f;
+}
+
+BenchmarkScene::BenchmarkScene(const BenchmarkSceneDescription& description,
+                               const std::string& folder)
+    : _description(description)
+    , _folder(folder)
+{
+}
+
+std::string BenchmarkScene::createVolumeFile() const
+{
+    const size_t size = _description.volumeSize;
+    if (size == 0)
+        return "";
+
+    const std::string filename = _folder + "/volume.raw";
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        BRAYNS_ERROR << "Failed to create " << filename << std::endl;
+        return "";
+    }
+
+    // Concentric shells with some noise, so that rays cross a varying number
+    // of non-empty voxels
+    std::mt19937 generator(_description.seed);
+    std::uniform_int_distribution<int> noise(-16, 16);
+    const float center = 0.5f * size;
+    std::vector<char> slice(size * size);
+    for (size_t z = 0; z < size; ++z)
+    {
+        for (size_t y = 0; y < size; ++y)
+            for (size_t x = 0; x < size; ++x)
+            {
+                const float dx = x - center;
+                const float dy = y - center;
+                const float dz = z - center;
+                const float distance =
+                    std::sqrt(dx * dx + dy * dy + dz * dz) / center;
+                const int value =
+                    int(127.5f * (1.f + std::cos(distance * 12.f))) +
+                    noise(generator);
+                slice[y * size + x] = char(std::min(std::max(value, 0), 255));
+            }
+        file.write(slice.data(), slice.size());
+    }
+    return file.good() ? filename : "";
+}
+
+bool BenchmarkScene::populate(Scene& scene) const
+{
+    _addPrimitives(scene);
+    _addMesh(scene);
+    if (_description.nbSimulationFrames != 0 && _description.nbSpheres != 0)
+        return _attachSimulation(scene);
+    return true;
+}
+
+void BenchmarkScene::_addPrimitives(Scene& scene) const
+{
+    std::mt19937 generator(_description.seed);
+    std::uniform_real_distribution<float> position(0.f, SCENE_SIZE);
+    std::uniform_real_distribution<float> direction(-1.f, 1.f);
+    std::uniform_real_distribution<float> radius(0.05f, 0.5f);
+    std::uniform_int_distribution<size_t> material(
+        FIRST_MATERIAL, FIRST_MATERIAL + NB_MATERIALS - 1);
+
+    auto& bounds = scene.getWorldBounds();
+    auto& spheres = scene.getSpheres();
+    for (size_t i = 0; i < _description.nbSpheres; ++i)
+    {
+        const Vector3f center(position(generator), position(generator),
+                              position(generator));
+        const size_t materialId = material(generator);
+        // The sphere index is the offset of its simulation value
+        spheres[materialId].push_back(SpherePtr(
+            new Sphere(materialId, center, radius(generator), 0.f, i)));
+        bounds.merge(center);
+    }
+
+    auto& cylinders = scene.getCylinders();
+    for (size_t i = 0; i < _description.nbCylinders; ++i)
+    {
+        const Vector3f center(position(generator), position(generator),
+                              position(generator));
+        const Vector3f up =
+            center + Vector3f(direction(generator), direction(generator),
+                              direction(generator));
+        const size_t materialId = material(generator);
+        cylinders[materialId].push_back(CylinderPtr(
+            new Cylinder(materialId, center, up, radius(generator), 0.f, 0.f)));
+        bounds.merge(center);
+        bounds.merge(up);
+    }
+
+    auto& cones = scene.getCones();
+    for (size_t i = 0; i < _description.nbCones; ++i)
+    {
+        const Vector3f center(position(generator), position(generator),
+                              position(generator));
+        const Vector3f up =
+            center + Vector3f(direction(generator), direction(generator),
+                              direction(generator));
+        const size_t materialId = material(generator);
+        cones[materialId].push_back(
+            ConePtr(new Cone(materialId, center, up, radius(generator),
+                             radius(generator), 0.f, 0.f)));
+        bounds.merge(center);
+        bounds.merge(up);
+    }
+}
+
+void BenchmarkScene::_addMesh(Scene& scene) const
+{
+    if (_description.nbTriangles == 0)
+        return;
+
+    // Height field of n x n quads, two triangles each
+    const size_t n = std::max(
+        size_t(std::sqrt(float(_description.nbTriangles) * 0.5f)), size_t(1));
+    const float step = SCENE_SIZE / n;
+
+    auto& mesh = scene.getTriangleMeshes()[FIRST_MATERIAL];
+    auto& vertices = mesh.getVertices();
+    auto& normals = mesh.getNormals();
+    auto& indices = mesh.getIndices();
+    const size_t firstVertex = vertices.size();
+    for (size_t j = 0; j <= n; ++j)
+        for (size_t i = 0; i <= n; ++i)
+        {
+            const float x = i * step;
+            const float z = j * step;
+            const float frequency = 0.1f;
+            const float height = 5.f * std::sin(x * frequency) *
+                                 std::cos(z * frequency);
+            const Vector3f normal(
+                -5.f * frequency * std::cos(x * frequency) *
+                    std::cos(z * frequency),
+                1.f, 5.f * frequency * std::sin(x * frequency) *
+                         std::sin(z * frequency));
+            vertices.push_back(Vector3f(x, height - 10.f, z));
+            normals.push_back(normalize(normal));
+            scene.getWorldBounds().merge(vertices.back());
+        }
+
+    for (size_t j = 0; j < n; ++j)
+        for (size_t i = 0; i < n; ++i)
+        {
+            const uint32_t v = firstVertex + j * (n + 1) + i;
+            indices.push_back(Vector3ui(v, v + n + 1, v + 1));
+            indices.push_back(Vector3ui(v + 1, v + n + 1, v + n + 2));
+        }
+}
+
+bool BenchmarkScene::_attachSimulation(Scene& scene) const
+{
+    const std::string filename = _folder + "/simulation.cache";
+    const auto& geometryParameters =
+        scene.getParametersManager().getGeometryParameters();
+    CircuitSimulationHandlerPtr handler(
+        new CircuitSimulationHandler(geometryParameters));
+
+    {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open())
+        {
+            BRAYNS_ERROR << "Failed to create " << filename << std::endl;
+            return false;
+        }
+
+        // One value per sphere, travelling waves along the sphere indices
+        const size_t frameSize = _description.nbSpheres;
+        handler->setNbFrames(_description.nbSimulationFrames);
+        handler->setFrameSize(frameSize);
+        handler->writeHeader(file);
+        floats values(frameSize);
+        for (size_t frame = 0; frame < _description.nbSimulationFrames;
+             ++frame)
+        {
+            for (size_t i = 0; i < frameSize; ++i)
+                values[i] = std::sin(0.01f * i + 0.1f * frame);
+            handler->writeFrame(file, values);
+        }
+        if (!file.good())
+            return false;
+    }
+
+    if (!handler->attachSimulationToCacheFile(filename))
+        return false;
+    scene.setSimulationHandler(handler);
+    return true;
+}
+}
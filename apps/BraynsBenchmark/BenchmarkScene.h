@@ -0,0 +1,78 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCHMARKSCENE_H
+#define BENCHMARKSCENE_H
+
+#include <brayns/common/types.h>
+
+namespace brayns
+{
+/** Size of the procedural scene built by the benchmark */
+struct BenchmarkSceneDescription
+{
+    size_t nbSpheres = 0;
+    size_t nbCylinders = 0;
+    size_t nbCones = 0;
+    size_t nbTriangles = 0;
+    size_t volumeSize = 0;
+    size_t nbSimulationFrames = 0;
+    uint32_t seed = 0;
+};
+
+/**
+   Builds reproducible procedural scenes: for a given description, the same
+   geometry, volume and simulation values are generated on every run, so
+   that timings of different builds can be compared.
+ */
+class BenchmarkScene
+{
+public:
+    /**
+     * @param description Size of the scene
+     * @param folder Folder where volume and simulation files are generated
+     */
+    BenchmarkScene(const BenchmarkSceneDescription& description,
+                   const std::string& folder);
+
+    /**
+     * @brief Writes the 8bit volume, if any, to a raw file
+     * @return The volume file, empty if the scene has no volume
+     */
+    std::string createVolumeFile() const;
+
+    /**
+     * @brief Adds spheres, cylinders, cones and a triangle mesh to the scene,
+     *        and attaches simulation values to the spheres if requested.
+     *        Geometry is not built nor committed.
+     * @return True on success, false if the simulation could not be attached
+     */
+    bool populate(Scene& scene) const;
+
+private:
+    void _addPrimitives(Scene& scene) const;
+    void _addMesh(Scene& scene) const;
+    bool _attachSimulation(Scene& scene) const;
+
+    const BenchmarkSceneDescription _description;
+    const std::string _folder;
+};
+}
+#endif // BENCHMARKSCENE_H
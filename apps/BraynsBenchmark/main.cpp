@@ -0,0 +1,407 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkScene.h"
+
+#include <brayns/Brayns.h>
+#include <brayns/common/camera/Camera.h>
+#include <brayns/common/engine/Engine.h>
+#include <brayns/common/log.h>
+#include <brayns/common/scene/Scene.h>
+#include <brayns/common/simulation/AbstractSimulationHandler.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <chrono>
+
+#if BRAYNS_USE_LIBJPEGTURBO
+#include <turbojpeg.h>
+#endif
+
+namespace po = boost::program_options;
+namespace pt = boost::property_tree;
+
+using std::chrono::duration;
+using std::chrono::high_resolution_clock;
+
+namespace
+{
+const std::string PARAM_NB_SPHERES = "nb-spheres";
+const std::string PARAM_NB_CYLINDERS = "nb-cylinders";
+const std::string PARAM_NB_CONES = "nb-cones";
+const std::string PARAM_NB_TRIANGLES = "nb-triangles";
+const std::string PARAM_VOLUME_SIZE = "volume-size";
+const std::string PARAM_NB_SIMULATION_FRAMES = "nb-simulation-frames";
+const std::string PARAM_SEED = "seed";
+const std::string PARAM_NB_FRAMES = "nb-frames";
+const std::string PARAM_RESULTS_FILE = "results-file";
+const std::string PARAM_BASELINE_FILE = "baseline-file";
+const std::string PARAM_TOLERANCE = "tolerance";
+
+const size_t DEFAULT_NB_SPHERES = 100000;
+const size_t DEFAULT_NB_CYLINDERS = 100000;
+const size_t DEFAULT_NB_CONES = 100000;
+const size_t DEFAULT_NB_TRIANGLES = 100000;
+const size_t DEFAULT_NB_FRAMES = 20;
+const float DEFAULT_TOLERANCE = 10.f;
+
+struct BenchmarkParameters
+{
+    brayns::BenchmarkSceneDescription scene;
+    size_t nbFrames = DEFAULT_NB_FRAMES;
+    std::string resultsFile;
+    std::string baselineFile;
+    float tolerance = DEFAULT_TOLERANCE;
+};
+
+bool parseBenchmarkParameters(int argc, const char** argv,
+                              BenchmarkParameters& parameters)
+{
+    auto& scene = parameters.scene;
+    scene.nbSpheres = DEFAULT_NB_SPHERES;
+    scene.nbCylinders = DEFAULT_NB_CYLINDERS;
+    scene.nbCones = DEFAULT_NB_CONES;
+    scene.nbTriangles = DEFAULT_NB_TRIANGLES;
+
+    po::options_description options("Benchmark");
+    options.add_options()(PARAM_NB_SPHERES.c_str(), po::value<size_t>(),
+                          "Number of spheres [int]")(
+        PARAM_NB_CYLINDERS.c_str(), po::value<size_t>(),
+        "Number of cylinders [int]")(PARAM_NB_CONES.c_str(),
+                                     po::value<size_t>(),
+                                     "Number of cones [int]")(
+        PARAM_NB_TRIANGLES.c_str(), po::value<size_t>(),
+        "Number of mesh triangles [int]")(
+        PARAM_VOLUME_SIZE.c_str(), po::value<size_t>(),
+        "Size of the cubic 8bit volume, 0 for no volume [int]")(
+        PARAM_NB_SIMULATION_FRAMES.c_str(), po::value<size_t>(),
+        "Number of simulation frames mapped on spheres, 0 for no "
+        "simulation [int]")(PARAM_SEED.c_str(), po::value<uint32_t>(),
+                            "Seed of the procedural scene [int]")(
+        PARAM_NB_FRAMES.c_str(), po::value<size_t>(),
+        "Number of frames measured once the first one is rendered [int]")(
+        PARAM_RESULTS_FILE.c_str(), po::value<std::string>(),
+        "JSON file where results are written [string]")(
+        PARAM_BASELINE_FILE.c_str(), po::value<std::string>(),
+        "JSON results of a previous run to compare with [string]")(
+        PARAM_TOLERANCE.c_str(), po::value<float>(),
+        "Accepted slowdown compared to the baseline, in percent [float]");
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv)
+                      .options(options)
+                      .style(po::command_line_style::unix_style ^
+                             po::command_line_style::allow_short)
+                      .allow_unregistered()
+                      .run(),
+                  vm);
+        po::notify(vm);
+
+        if (vm.count(PARAM_NB_SPHERES))
+            scene.nbSpheres = vm[PARAM_NB_SPHERES].as<size_t>();
+        if (vm.count(PARAM_NB_CYLINDERS))
+            scene.nbCylinders = vm[PARAM_NB_CYLINDERS].as<size_t>();
+        if (vm.count(PARAM_NB_CONES))
+            scene.nbCones = vm[PARAM_NB_CONES].as<size_t>();
+        if (vm.count(PARAM_NB_TRIANGLES))
+            scene.nbTriangles = vm[PARAM_NB_TRIANGLES].as<size_t>();
+        if (vm.count(PARAM_VOLUME_SIZE))
+            scene.volumeSize = vm[PARAM_VOLUME_SIZE].as<size_t>();
+        if (vm.count(PARAM_NB_SIMULATION_FRAMES))
+            scene.nbSimulationFrames =
+                vm[PARAM_NB_SIMULATION_FRAMES].as<size_t>();
+        if (vm.count(PARAM_SEED))
+            scene.seed = vm[PARAM_SEED].as<uint32_t>();
+        if (vm.count(PARAM_NB_FRAMES))
+            parameters.nbFrames =
+                std::max(vm[PARAM_NB_FRAMES].as<size_t>(), size_t(1));
+        if (vm.count(PARAM_RESULTS_FILE))
+            parameters.resultsFile = vm[PARAM_RESULTS_FILE].as<std::string>();
+        if (vm.count(PARAM_BASELINE_FILE))
+            parameters.baselineFile =
+                vm[PARAM_BASELINE_FILE].as<std::string>();
+        if (vm.count(PARAM_TOLERANCE))
+            parameters.tolerance = vm[PARAM_TOLERANCE].as<float>();
+    }
+    catch (po::error& e)
+    {
+        BRAYNS_ERROR << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/** Measures the duration of a function call in milliseconds */
+template <typename F>
+double measure(F function)
+{
+    const auto start = high_resolution_clock::now();
+    function();
+    return duration<double, std::milli>(high_resolution_clock::now() - start)
+        .count();
+}
+
+/** Average and minimum durations of repeated measures */
+struct Statistics
+{
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::max();
+    size_t count = 0;
+
+    void add(const double value)
+    {
+        sum += value;
+        min = std::min(min, value);
+        ++count;
+    }
+    double average() const { return count == 0 ? 0.0 : sum / count; }
+};
+
+#if BRAYNS_USE_LIBJPEGTURBO
+double measureJpegEncoding(const brayns::RenderOutput& output,
+                           const brayns::Vector2ui& size,
+                           const size_t quality, const size_t nbRuns)
+{
+    int32_t pixelFormat = TJPF_RGBA;
+    size_t pixelSize = 4;
+    switch (output.colorBufferFormat)
+    {
+    case brayns::FrameBufferFormat::FBF_BGRA_I8:
+        pixelFormat = TJPF_BGRA;
+        break;
+    case brayns::FrameBufferFormat::FBF_RGB_I8:
+        pixelFormat = TJPF_RGB;
+        pixelSize = 3;
+        break;
+    default:
+        break;
+    }
+    if (output.colorBuffer.size() < size.x() * size.y() * pixelSize)
+        return 0.0;
+
+    tjhandle compressor = tjInitCompress();
+    Statistics statistics;
+    for (size_t i = 0; i < nbRuns; ++i)
+    {
+        uint8_t* jpegData = nullptr;
+        unsigned long jpegSize = 0;
+        statistics.add(measure([&] {
+            tjCompress2(compressor,
+                        const_cast<uint8_t*>(output.colorBuffer.data()),
+                        size.x(), size.x() * pixelSize, size.y(), pixelFormat,
+                        &jpegData, &jpegSize, TJSAMP_444, quality,
+                        TJFLAG_BOTTOMUP);
+        }));
+        tjFree(jpegData);
+    }
+    tjDestroy(compressor);
+    return statistics.average();
+}
+#endif
+
+/**
+ * Compares timings with the baseline ones.
+ * @return The number of timings slower than the baseline by more than the
+ *         tolerance
+ */
+size_t compareWithBaseline(const pt::ptree& results,
+                           const BenchmarkParameters& parameters)
+{
+    pt::ptree baseline;
+    pt::read_json(parameters.baselineFile, baseline);
+
+    if (baseline.get_child("scene") != results.get_child("scene"))
+        BRAYNS_WARN << "Baseline was measured on a different scene"
+                    << std::endl;
+
+    size_t nbRegressions = 0;
+    const float factor = 1.f + parameters.tolerance / 100.f;
+    for (const auto& timing : baseline.get_child("timings"))
+    {
+        const auto value =
+            results.get_optional<double>("timings." + timing.first);
+        if (!value)
+            continue;
+
+        const double reference = timing.second.get_value<double>();
+        if (*value > reference * factor)
+        {
+            BRAYNS_ERROR << timing.first << ": " << *value
+                         << " ms, baseline " << reference << " ms"
+                         << std::endl;
+            ++nbRegressions;
+        }
+        else
+            BRAYNS_INFO << timing.first << ": " << *value << " ms, baseline "
+                        << reference << " ms" << std::endl;
+    }
+    return nbRegressions;
+}
+
+int runBenchmark(int argc, const char** argv,
+                 const BenchmarkParameters& parameters,
+                 const std::string& folder)
+{
+    const auto& description = parameters.scene;
+    brayns::BenchmarkScene benchmarkScene(description, folder);
+
+    // The volume is attached by the engine at startup, from the volume
+    // parameters
+    std::vector<std::string> arguments(argv, argv + argc);
+    const auto volumeFile = benchmarkScene.createVolumeFile();
+    if (!volumeFile.empty())
+    {
+        const auto size = std::to_string(description.volumeSize);
+        arguments.insert(arguments.end(),
+                         {"--volume-file", volumeFile, "--volume-dimensions",
+                          size, size, size});
+    }
+    std::vector<const char*> args;
+    for (const auto& argument : arguments)
+        args.push_back(argument.c_str());
+
+    pt::ptree results;
+    std::unique_ptr<brayns::Brayns> brayns;
+    results.put("timings.startup", measure([&] {
+                    brayns.reset(new brayns::Brayns(args.size(), args.data()));
+                }));
+
+    auto& engine = brayns->getEngine();
+    auto& scene = engine.getScene();
+    auto& parametersManager = brayns->getParametersManager();
+
+    bool populated = false;
+    results.put("timings.load", measure([&] {
+                    scene.reset();
+                    populated = benchmarkScene.populate(scene);
+                }));
+    if (!populated)
+        return 1;
+
+    results.put("timings.commit", measure([&] {
+                    scene.commitSimulationData();
+                    scene.buildGeometry();
+                    scene.commit();
+                    engine.setDefaultCamera();
+                    engine.commit();
+                }));
+
+    results.put("timings.first_frame", measure([&] { brayns->render(); }));
+
+    Statistics frames;
+    for (size_t i = 0; i < parameters.nbFrames; ++i)
+        frames.add(measure([&] { brayns->render(); }));
+    results.put("timings.frame", frames.average());
+    results.put("timings.frame_min", frames.min);
+
+#if BRAYNS_USE_LIBJPEGTURBO
+    brayns::RenderInput input;
+    brayns::RenderOutput output;
+    const auto& camera = engine.getCamera();
+    const auto& windowSize =
+        parametersManager.getApplicationParameters().getWindowSize();
+    input.windowSize = brayns::Vector2i(windowSize.x(), windowSize.y());
+    input.position = camera.getPosition();
+    input.target = camera.getTarget();
+    input.up = camera.getUp();
+    brayns->render(input, output);
+    results.put("timings.jpeg",
+                measureJpegEncoding(
+                    output, windowSize,
+                    parametersManager.getApplicationParameters()
+                        .getJpegCompression(),
+                    parameters.nbFrames));
+#endif
+
+    auto simulationHandler = scene.getSimulationHandler();
+    if (simulationHandler)
+    {
+        Statistics histograms;
+        for (size_t i = 0; i < parameters.nbFrames; ++i)
+        {
+            // The histogram is only computed when the frame changes
+            simulationHandler->setTimestamp(i);
+            histograms.add(
+                measure([&] { simulationHandler->getHistogram(); }));
+        }
+        results.put("timings.histogram", histograms.average());
+    }
+
+    results.put("scene.spheres", description.nbSpheres);
+    results.put("scene.cylinders", description.nbCylinders);
+    results.put("scene.cones", description.nbCones);
+    results.put("scene.triangles", description.nbTriangles);
+    results.put("scene.volume_size", description.volumeSize);
+    results.put("scene.simulation_frames", description.nbSimulationFrames);
+    results.put("scene.seed", description.seed);
+    results.put("scene.samples_per_pixel",
+                parametersManager.getRenderingParameters()
+                    .getSamplesPerPixel());
+    results.put("scene.renderer",
+                parametersManager.getRenderingParameters().getRendererAsString(
+                    parametersManager.getRenderingParameters()
+                        .getRenderer()));
+
+    std::ostringstream json;
+    pt::write_json(json, results);
+    BRAYNS_INFO << "Benchmark results:" << std::endl << json.str();
+    if (!parameters.resultsFile.empty())
+        pt::write_json(parameters.resultsFile, results);
+
+    if (parameters.baselineFile.empty())
+        return 0;
+
+    const size_t nbRegressions = compareWithBaseline(results, parameters);
+    if (nbRegressions == 0)
+        return 0;
+    BRAYNS_ERROR << nbRegressions << " timing(s) exceeded the baseline by "
+                 << "more than " << parameters.tolerance << "%" << std::endl;
+    return 1;
+}
+}
+
+int main(int argc, const char** argv)
+{
+    try
+    {
+        BenchmarkParameters parameters;
+        if (!parseBenchmarkParameters(argc, argv, parameters))
+            return 1;
+
+        const auto folder = boost::filesystem::temp_directory_path() /
+                            boost::filesystem::unique_path();
+        boost::filesystem::create_directories(folder);
+        const int status =
+            runBenchmark(argc, argv, parameters, folder.string());
+        boost::filesystem::remove_all(folder);
+        return status;
+    }
+    catch (const std::exception& e)
+    {
+        BRAYNS_ERROR << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -28,10 +28,12 @@
 #include <brayns/common/input/KeyboardHandler.h>
 #include <brayns/common/light/DirectionalLight.h>
 #include <brayns/common/log.h>
+#include <brayns/common/material/Material.h>
 #include <brayns/common/renderer/FrameBuffer.h>
 #include <brayns/common/scene/Scene.h>
 #include <brayns/common/simulation/CircuitSimulationHandler.h>
 #include <brayns/common/simulation/SpikeSimulationHandler.h>
+#include <brayns/common/utils/PerformanceCounters.h>
 #include <brayns/common/utils/Utils.h>
 #include <brayns/common/volume/VolumeHandler.h>
 
@@ -52,15 +54,196 @@
 
 #include <servus/uri.h>
 
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <set>
+
+namespace
+{
+/**
+ * Geometry parameters of the data sources that can be added and removed at
+ * runtime. Each of them is loaded as an instanced model of the scene, so that
+ * it can be replaced without reloading the rest of the scene.
+ */
+const brayns::strings DATA_SOURCE_PARAMETERS = {
+    "splash-scene-folder", "morphology-folder", "mesh-folder",
+    "pdb-file",            "pdb-folder",        "xyzb-file",
+    "circuit-config"};
+
+template <typename T>
+void addMaterialIds(const std::map<size_t, T>& geometry,
+                    std::set<size_t>& materialIds)
+{
+    for (const auto& materialGeometry : geometry)
+        materialIds.insert(materialGeometry.first);
+}
+
+template <typename T>
+void appendGeometry(const std::map<size_t, T>& from, std::map<size_t, T>& to)
+{
+    for (const auto& materialGeometry : from)
+    {
+        auto& geometry = to[materialGeometry.first];
+        geometry.insert(geometry.end(), materialGeometry.second.begin(),
+                        materialGeometry.second.end());
+    }
+}
+
+/** Appends vertex attributes, padded with the given value for the vertices of
+    the mesh that has none */
+template <typename T>
+void appendAttributes(const std::vector<T>& from, const size_t nbFrom,
+                      std::vector<T>& to, const size_t nbTo, const T& value)
+{
+    if (from.empty() && to.empty())
+        return;
+    to.resize(nbTo, value);
+    to.insert(to.end(), from.begin(), from.end());
+    to.resize(nbTo + nbFrom, value);
+}
+
+void appendMesh(brayns::TrianglesMesh& from, brayns::TrianglesMesh& to)
+{
+    auto& vertices = to.getVertices();
+    const size_t nbVertices = vertices.size();
+    const size_t nbAppendedVertices = from.getVertices().size();
+    appendAttributes(from.getNormals(), nbAppendedVertices, to.getNormals(),
+                     nbVertices, brayns::Vector3f(0.f, 0.f, 1.f));
+    appendAttributes(from.getTextureCoordinates(), nbAppendedVertices,
+                     to.getTextureCoordinates(), nbVertices,
+                     brayns::Vector2f(0.f, 0.f));
+    appendAttributes(from.getColors(), nbAppendedVertices, to.getColors(),
+                     nbVertices, brayns::Vector4f(1.f, 1.f, 1.f, 1.f));
+    vertices.insert(vertices.end(), from.getVertices().begin(),
+                    from.getVertices().end());
+
+    auto& indices = to.getIndices();
+    indices.reserve(indices.size() + from.getIndices().size());
+    for (const auto& triangle : from.getIndices())
+        indices.push_back(brayns::Vector3ui(nbVertices + triangle.x(),
+                                            nbVertices + triangle.y(),
+                                            nbVertices + triangle.z()));
+}
+
+/**
+ * Scene into which a data source is loaded in the background, before its
+ * geometry is moved into an instanced model of the rendered scene or merged
+ * into the geometry of that scene. It works
+ * on copies of the materials of the rendered scene and has no engine
+ * counterpart, so that the rendered scene is not touched while loading.
+ */
+class DataSourceScene : public brayns::Scene
+{
+public:
+    DataSourceScene(brayns::ParametersManager& parametersManager,
+                    const brayns::MaterialsMap& materials)
+        : brayns::Scene(brayns::Renderers(), parametersManager)
+    {
+        for (const auto& material : materials)
+            _materials[material.first] =
+                std::make_shared<brayns::Material>(*material.second);
+    }
+
+    /**
+     * Moves the loaded geometry into a model of the given scene, placed once
+     * where it was loaded, and applies the materials it uses to the scene
+     */
+    void moveToModel(brayns::Scene& scene, const std::string& name)
+    {
+        _applyMaterials(scene);
+        auto& model = scene.getInstancedModel(name);
+        model.getSpheres() = std::move(_spheres);
+        model.getCylinders() = std::move(_cylinders);
+        model.getCones() = std::move(_cones);
+        model.getTriangleMeshes() = std::move(_trianglesMeshes);
+        model.getBounds() = _bounds;
+        scene.addInstance(name, brayns::Matrix4f::IDENTITY);
+    }
+
+    /**
+     * Appends the loaded geometry to the geometry of the given scene, and
+     * applies the materials it uses to the scene
+     */
+    void mergeInto(brayns::Scene& scene)
+    {
+        appendGeometry(_spheres, scene.getSpheres());
+        appendGeometry(_cylinders, scene.getCylinders());
+        appendGeometry(_cones, scene.getCones());
+        for (auto& mesh : _trianglesMeshes)
+            appendMesh(mesh.second, scene.getTriangleMeshes()[mesh.first]);
+        scene.getWorldBounds().merge(_bounds);
+        _applyMaterials(scene);
+    }
+
+    /**
+     * Moves the geometry loaded so far into the given scene, and continues
+     * loading into an empty one
+     */
+    void moveGeometry(DataSourceScene& scene)
+    {
+        scene._spheres = std::move(_spheres);
+        scene._cylinders = std::move(_cylinders);
+        scene._cones = std::move(_cones);
+        scene._trianglesMeshes = std::move(_trianglesMeshes);
+        scene._bounds = _bounds;
+
+        _spheres.clear();
+        _cylinders.clear();
+        _cones.clear();
+        _trianglesMeshes.clear();
+        _bounds.reset();
+    }
+
+    void commit() final {}
+    void commitMaterials(const bool) final {}
+    void commitLights() final {}
+    void buildGeometry() final {}
+    uint64_t serializeGeometry() final { return 0; }
+    void commitSimulationData() final {}
+    void commitVolumeData() final {}
+    void commitTransferFunctionData() final {}
+    void saveSceneToCacheFile() final {}
+    bool isVolumeSupported(const std::string&) const final { return false; }
+private:
+    /** Loaders may have set up the materials of the data source */
+    void _applyMaterials(brayns::Scene& scene)
+    {
+        std::set<size_t> materialIds;
+        addMaterialIds(_spheres, materialIds);
+        addMaterialIds(_cylinders, materialIds);
+        addMaterialIds(_cones, materialIds);
+        addMaterialIds(_trianglesMeshes, materialIds);
+        for (const auto materialId : materialIds)
+        {
+            const auto material = _materials.find(materialId);
+            if (material != _materials.end() &&
+                scene.getMaterials().count(materialId))
+                *scene.getMaterial(materialId) = *material->second;
+        }
+    }
+};
+typedef std::shared_ptr<DataSourceScene> DataSourceScenePtr;
+}
+
 namespace brayns
 {
 struct Brayns::Impl
 {
     Impl(int argc, const char** argv)
-        : _engine(nullptr)
+        : _parametersManager(new ParametersManager())
+        , _engine(nullptr)
+        , _meshLoader(_parametersManager->getGeometryParameters())
+        , _nbLoadedBatches(0)
+        , _resetCamera(false)
+        , _loadedItems(0)
+        , _itemsToLoad(0)
     {
         BRAYNS_INFO << "Parsing command line options" << std::endl;
-        _parametersManager.reset(new ParametersManager());
         _parametersManager->parse(argc, argv);
         _parametersManager->print();
 
@@ -69,8 +252,8 @@ struct Brayns::Impl
         _registerKeyboardShortcuts();
 
         // Get rendering engine
-        _engineFactory.reset(
-            new EngineFactory(argc, argv, *_parametersManager));
+        _engineFactory.reset(new EngineFactory(argc, argv, *_parametersManager,
+                                               _performanceCounters));
         createEngine();
 
         _extensionPluginFactory.reset(
@@ -102,24 +285,29 @@ struct Brayns::Impl
         buildScene();
 
         _engine->recreate = std::bind(&Impl::createEngine, this);
+        _engine->updateDataSources =
+            std::bind(&Impl::updateDataSources, this, std::placeholders::_1);
     }
 
     void buildScene()
     {
-        _meshLoader.clear();
+        _resetDataSources();
         _loadData();
         Scene& scene = _engine->getScene();
         scene.commitVolumeData();
         scene.commitSimulationData();
         scene.buildEnvironment();
-        scene.buildGeometry();
+        _buildGeometry();
 
-        if (scene.empty() && !scene.getVolumeHandler())
+        // Data sources loaded progressively are not in the scene yet
+        if (scene.empty() && !scene.getVolumeHandler() &&
+            _pendingDataSources.empty())
         {
             BRAYNS_INFO << "Building default scene" << std::endl;
             scene.buildDefault();
-            scene.buildGeometry();
+            _buildGeometry();
         }
+        _reportMemoryUsage("geometry serialization");
 
         scene.commit();
 
@@ -127,11 +315,52 @@ struct Brayns::Impl
         _setupCameraManipulator(CameraMode::inspect);
         _engine->setDefaultCamera();
 
-        // Set default epsilon according to scene bounding box
-        _engine->setDefaultEpsilon();
+        // Set default epsilon according to scene bounding box, once the first
+        // geometry is in the scene if it is loaded progressively
+        if (!_resetCamera)
+            _engine->setDefaultEpsilon();
 
         // Commit changes to the rendering engine
-        _engine->commit();
+        _commitEngine();
+
+        _loadNextDataSource();
+    }
+
+    /**
+     * Loads the given data source parameters in the background, each as an
+     * instanced model replacing the one of its previous value. Models are
+     * swapped in the scene at the frame following their loading.
+     * @return false if some parameters cannot be updated without rebuilding
+     *         the scene
+     */
+    bool updateDataSources(const strings& parameters)
+    {
+        for (const auto& parameter : parameters)
+        {
+            if (!_isDataSourceParameter(parameter))
+                return false;
+
+            // Data merged into the geometry of the scene to be saved in the
+            // cache file cannot be removed on its own
+            if (_mergedDataSources.count(parameter))
+                return false;
+        }
+
+        for (const auto& parameter : parameters)
+        {
+            // A newer value replaces the one waiting to be loaded
+            for (auto it = _pendingDataSources.begin();
+                 it != _pendingDataSources.end(); ++it)
+                if (it->parameter == parameter)
+                {
+                    _pendingDataSources.erase(it);
+                    break;
+                }
+            _pendingDataSources.push_back(
+                {parameter, _getDataSource(parameter)});
+        }
+        _loadNextDataSource();
+        return true;
     }
 
     void render(const RenderInput& renderInput, RenderOutput& renderOutput)
@@ -142,7 +371,7 @@ struct Brayns::Impl
         _engine->preRender();
 
         auto oldEngine = _engine.get();
-        _extensionPluginFactory->execute(*_engine);
+        _executePlugins();
 
         // the ZeroEQ plugin can create a new engine
         if (_engine.get() != oldEngine)
@@ -151,9 +380,11 @@ struct Brayns::Impl
             _engine->preRender();
         }
 
+        _swapLoadedDataSources();
+
         auto& sceneParams = _parametersManager->getSceneParameters();
         if (sceneParams.getAnimationDelta() != 0)
-            _engine->commit();
+            _commitEngine();
 
         Camera& camera = _engine->getCamera();
         camera.commit();
@@ -204,7 +435,7 @@ struct Brayns::Impl
         _engine->preRender();
 
         auto oldEngine = _engine.get();
-        _extensionPluginFactory->execute(*_engine);
+        _executePlugins();
 
         // the ZeroEQ plugin can create a new engine
         if (_engine.get() != oldEngine)
@@ -213,12 +444,14 @@ struct Brayns::Impl
             _engine->preRender();
         }
 
+        _swapLoadedDataSources();
+
         Scene& scene = _engine->getScene();
         Camera& camera = _engine->getCamera();
 
         auto& sceneParams = _parametersManager->getSceneParameters();
         if (sceneParams.getAnimationDelta() != 0)
-            _engine->commit();
+            _commitEngine();
 
         if (_parametersManager->getRenderingParameters().getHeadLight())
         {
@@ -243,6 +476,34 @@ struct Brayns::Impl
     KeyboardHandler& getKeyboardHandler() { return *_keyboardHandler; }
     AbstractManipulator& getCameraManipulator() { return *_cameraManipulator; }
 private:
+    void _executePlugins()
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        _extensionPluginFactory->execute(*_engine);
+
+        // Plugins may recreate the engine, the duration is recorded in the
+        // current one
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::high_resolution_clock::now() - start;
+        _engine->getPerformanceCounters().add(counters::PLUGINS,
+                                              elapsed.count());
+    }
+
+    void _commitEngine()
+    {
+        PerformanceCounters::ScopedTimer timer(
+            _engine->getPerformanceCounters(), counters::ENGINE_COMMIT);
+        _engine->commit();
+    }
+
+    void _buildGeometry()
+    {
+        PerformanceCounters::ScopedTimer timer(
+            _engine->getPerformanceCounters(),
+            counters::GEOMETRY_SERIALIZATION);
+        _engine->getScene().buildGeometry();
+    }
+
     void _render()
     {
         _engine->setActiveRenderer(
@@ -264,8 +525,20 @@ private:
             scene.getMaterial(MATERIAL_SKYBOX)
                 ->setTexture(TT_DIFFUSE, environmentMap);
 
-        if (!geometryParameters.getSplashSceneFolder().empty())
-            _loadMeshFolder(geometryParameters.getSplashSceneFolder());
+        // Geometry data sources are independent from each other and from the
+        // other loaders, and are loaded concurrently into scene fragments
+        _loadFragments();
+
+        const auto& splashSceneFolder =
+            geometryParameters.getSplashSceneFolder();
+        if (!splashSceneFolder.empty())
+            _loadPhase("splash scene", splashSceneFolder, [&] {
+                auto splashScene = _createDataSourceScene();
+                _loadMeshFolder(*splashScene, splashSceneFolder,
+                                geometryParameters, _meshLoader);
+                _addDataSourceBatch({"splash-scene-folder", splashSceneFolder},
+                                    splashScene, 0);
+            });
 
         const std::string& colorMapFilename =
             sceneParameters.getColorMapFilename();
@@ -276,41 +549,38 @@ private:
         }
         scene.commitTransferFunctionData();
 
-        if (!geometryParameters.getMorphologyFolder().empty())
-            _loadMorphologyFolder();
-
         if (!geometryParameters.getNESTCircuit().empty())
-            _loadNESTCircuit();
-
-        if (!geometryParameters.getPDBFile().empty())
-            _loadPDBFile(geometryParameters.getPDBFile());
-
-        if (!geometryParameters.getPDBFolder().empty())
-            _loadPDBFolder();
-
-        if (!geometryParameters.getMeshFolder().empty())
-            _loadMeshFolder(geometryParameters.getMeshFolder());
+            _loadPhase("NEST circuit", geometryParameters.getNESTCircuit(),
+                       [this] { _loadNESTCircuit(); });
 
         if (!geometryParameters.getReport().empty())
-            _loadCompartmentReport();
+            _loadPhase("compartment report", geometryParameters.getReport(),
+                       [this] { _loadCompartmentReport(); });
 
+        // Circuits with a compartment report are not a fragment
         if (!geometryParameters.getCircuitConfiguration().empty() &&
-            geometryParameters.getLoadCacheFile().empty())
-            _loadCircuitConfiguration();
-
-        if (!geometryParameters.getXYZBFile().empty())
-            _loadXYZBFile();
+            geometryParameters.getLoadCacheFile().empty() &&
+            !geometryParameters.getReport().empty())
+            _loadPhase("circuit", geometryParameters.getCircuitConfiguration(),
+                       [&] {
+                           _loadCircuitConfiguration(scene, geometryParameters);
+                       });
 
         if (!geometryParameters.getMolecularSystemConfig().empty())
-            _loadMolecularSystem();
+            _loadPhase("molecular system",
+                       geometryParameters.getMolecularSystemConfig(),
+                       [this] { _loadMolecularSystem(); });
 
-        if (scene.getVolumeHandler())
+        // The volume is attached while the fragments are still loading
+        const auto volumeHandler = scene.getVolumeHandler();
+
+        _addFragments(scene);
+
+        if (volumeHandler)
         {
-            scene.getVolumeHandler()->setTimestamp(0.f);
-            const Vector3ui& volumeDimensions =
-                scene.getVolumeHandler()->getDimensions();
-            const Vector3f& volumeOffset =
-                scene.getVolumeHandler()->getOffset();
+            volumeHandler->setTimestamp(0.f);
+            const Vector3ui& volumeDimensions = volumeHandler->getDimensions();
+            const Vector3f& volumeOffset = volumeHandler->getOffset();
             const Vector3f& volumeElementSpacing =
                 volumeParameters.getElementSpacing();
             Boxf& worldBounds = scene.getWorldBounds();
@@ -321,15 +591,463 @@ private:
         }
     }
 
+    /**
+     * Runs a load phase and logs the memory usage once it is done. The size of
+     * the input data is used as an estimate of the memory the phase needs: if
+     * it does not fit in the memory budget, the phase is either skipped
+     * (--memory-budget-strict) or run with a warning.
+     */
+    void _loadPhase(const std::string& name, const std::string& source,
+                    const std::function<void()>& load)
+    {
+        if (!_fitsMemoryBudget(name, source))
+            return;
+        load();
+        _reportMemoryUsage(name);
+    }
+
+    /** @return false if the data must not be loaded to stay in the memory
+                budget */
+    bool _fitsMemoryBudget(const std::string& name, const std::string& source)
+    {
+        uint64_t reserved = 0;
+        return _fitsMemoryBudget(name, source, reserved);
+    }
+
+    /**
+     * @param reserved estimate of the memory needed by data being loaded
+     *        concurrently, increased by the estimate for the given data if it
+     *        is to be loaded
+     * @return false if the data must not be loaded to stay in the memory
+     *         budget
+     */
+    bool _fitsMemoryBudget(const std::string& name, const std::string& source,
+                           uint64_t& reserved)
+    {
+        const auto& registry = _engine->getMemoryRegistry();
+        const uint64_t estimate = _getDataSize(source);
+        if (registry.fits(reserved + estimate))
+        {
+            reserved += estimate;
+            return true;
+        }
+
+        const auto& applicationParameters =
+            _parametersManager->getApplicationParameters();
+        if (applicationParameters.getMemoryBudgetStrict())
+        {
+            BRAYNS_ERROR << "Not loading " << name << " from " << source
+                         << ": " << estimate
+                         << " bytes exceed the memory budget" << std::endl;
+            return false;
+        }
+        BRAYNS_WARN << "Loading " << name << " from " << source
+                    << " may exceed the memory budget" << std::endl;
+        reserved += estimate;
+        return true;
+    }
+
+    /**
+     * Starts loading the geometry data sources of the scene that are not
+     * loaded progressively, each into its own scene fragment
+     */
+    void _loadFragments()
+    {
+        uint64_t reserved = 0;
+        for (const auto& parameter : DATA_SOURCE_PARAMETERS)
+        {
+            if (!_sceneDataSources.count(parameter) ||
+                !_isDataSourceParameter(parameter))
+                continue;
+
+            const DataSource dataSource{parameter, _getDataSource(parameter)};
+            if (!_fitsMemoryBudget(parameter, dataSource.source, reserved))
+                continue;
+            _fragments[parameter] =
+                std::async(std::launch::async,
+                           std::bind(&Impl::_loadDataSource, this, dataSource,
+                                     _createDataSourceScene(),
+                                     _parametersManager
+                                         ->getGeometryParameters()));
+        }
+    }
+
+    /**
+     * Adds the loaded fragments to the scene as instanced models, like the
+     * data sources loaded at runtime, so that they can be replaced without
+     * rebuilding the scene. They are merged into the scene geometry instead
+     * when it is saved to a cache file, which only holds that geometry.
+     * Fragments are added in the order of the data source parameters so that
+     * the resulting scene does not depend on which loader finished first.
+     */
+    void _addFragments(Scene& scene)
+    {
+        const bool merge = !_parametersManager->getGeometryParameters()
+                                .getSaveCacheFile()
+                                .empty();
+        for (const auto& parameter : DATA_SOURCE_PARAMETERS)
+        {
+            auto fragment = _fragments.find(parameter);
+            if (fragment == _fragments.end())
+                continue;
+            const auto loadedScene = fragment->second.get();
+            _fragments.erase(fragment);
+            if (merge)
+            {
+                loadedScene->mergeInto(scene);
+                _mergedDataSources.insert(parameter);
+            }
+            else
+                _addDataSourceBatch({parameter, _getDataSource(parameter)},
+                                    loadedScene, 0);
+            _reportMemoryUsage(parameter);
+        }
+    }
+
+    /** Data source to load as an instanced model */
+    struct DataSource
+    {
+        std::string parameter;
+        std::string source;
+    };
+
+    /** @return true if the given parameter is a data source that can be
+                loaded as an instanced model */
+    bool _isDataSourceParameter(const std::string& parameter)
+    {
+        if (std::find(DATA_SOURCE_PARAMETERS.begin(),
+                      DATA_SOURCE_PARAMETERS.end(),
+                      parameter) == DATA_SOURCE_PARAMETERS.end())
+            return false;
+
+        // Circuits with a compartment report or a cache file are part of the
+        // scene
+        if (parameter == "circuit-config")
+        {
+            const auto& geometryParameters =
+                _parametersManager->getGeometryParameters();
+            return geometryParameters.getReport().empty() &&
+                   geometryParameters.getLoadCacheFile().empty();
+        }
+        return true;
+    }
+
+    /** @return true if the given data source is loaded in the background once
+                the scene is built, rather than with the scene */
+    bool _isLoadedProgressively(const std::string& parameter)
+    {
+        const auto& geometryParameters =
+            _parametersManager->getGeometryParameters();
+        return geometryParameters.useProgressiveLoading() &&
+               parameter != "splash-scene-folder" &&
+               _isDataSourceParameter(parameter);
+    }
+
+    /** @return the value of the given data source parameter */
+    std::string _getDataSource(const std::string& parameter)
+    {
+        const auto& geometryParameters =
+            _parametersManager->getGeometryParameters();
+        if (parameter == "splash-scene-folder")
+            return geometryParameters.getSplashSceneFolder();
+        if (parameter == "morphology-folder")
+            return geometryParameters.getMorphologyFolder();
+        if (parameter == "mesh-folder")
+            return geometryParameters.getMeshFolder();
+        if (parameter == "pdb-file")
+            return geometryParameters.getPDBFile();
+        if (parameter == "pdb-folder")
+            return geometryParameters.getPDBFolder();
+        if (parameter == "xyzb-file")
+            return geometryParameters.getXYZBFile();
+        if (parameter == "circuit-config")
+            return geometryParameters.getCircuitConfiguration();
+        return std::string();
+    }
+
+    DataSourceScenePtr _createDataSourceScene()
+    {
+        return std::make_shared<DataSourceScene>(
+            *_parametersManager, _engine->getScene().getMaterials());
+    }
+
+    /**
+     * Loads a data source into the given scene. This is called from a
+     * background thread, and must not access the rendered scene. If loading
+     * is progressive, the geometry is published in batches while loading, and
+     * the returned scene holds the remaining geometry.
+     * @param geometryParameters copy of the geometry parameters taken when the
+     *        loading started, as the main thread keeps updating them
+     */
+    DataSourceScenePtr _loadDataSource(
+        const DataSource& dataSource, DataSourceScenePtr scene,
+        const GeometryParameters& geometryParameters)
+    {
+        const auto& parameter = dataSource.parameter;
+        const auto& source = dataSource.source;
+        if (source.empty())
+            return scene;
+
+        LoadingCallback batchLoaded;
+        if (geometryParameters.useProgressiveLoading())
+            batchLoaded = [this, scene](const size_t loaded,
+                                        const size_t total) {
+                _publishBatch(*scene, loaded, total);
+            };
+
+        if (parameter == "splash-scene-folder" || parameter == "mesh-folder")
+        {
+            MeshLoader meshLoader(geometryParameters);
+            _loadMeshFolder(*scene, source, geometryParameters, meshLoader,
+                            batchLoaded);
+        }
+        else if (parameter == "morphology-folder")
+            _loadMorphologyFolder(*scene, source, geometryParameters,
+                                  batchLoaded);
+        else if (parameter == "pdb-file")
+            _loadPDBFile(*scene, source, geometryParameters);
+        else if (parameter == "pdb-folder")
+            _loadPDBFolder(*scene, source, geometryParameters, batchLoaded);
+        else if (parameter == "xyzb-file")
+            _loadXYZBFile(*scene, source, geometryParameters);
+        else if (parameter == "circuit-config")
+            _loadCircuitConfiguration(*scene, geometryParameters, batchLoaded);
+        return scene;
+    }
+
+    /**
+     * Publishes the geometry loaded so far into the given scene as a batch,
+     * added to the rendered scene at the next frame. This is called from the
+     * loading thread.
+     */
+    void _publishBatch(DataSourceScene& scene, const size_t loaded,
+                       const size_t total)
+    {
+        auto batch = std::make_shared<DataSourceScene>(*_parametersManager,
+                                                       scene.getMaterials());
+        scene.moveGeometry(*batch);
+
+        std::lock_guard<std::mutex> lock(_loadedBatchesMutex);
+        _loadedBatches.push_back(batch);
+        _loadedItems = loaded;
+        _itemsToLoad = total;
+    }
+
+    /**
+     * Calls the given callback, if any, once every loading batch size items
+     * and after the last one
+     */
+    void _notifyBatch(const GeometryParameters& geometryParameters,
+                      const LoadingCallback& batchLoaded, const size_t loaded,
+                      const size_t total)
+    {
+        if (!batchLoaded)
+            return;
+        const size_t batchSize = geometryParameters.getLoadingBatchSize();
+        if (loaded == total || (batchSize != 0 && loaded % batchSize == 0))
+            batchLoaded(loaded, total);
+    }
+
+    /**
+     * Adds a loaded batch of a data source to the scene as a model. The first
+     * batch replaces the models of the previous value of the data source.
+     */
+    void _addDataSourceBatch(const DataSource& dataSource,
+                             DataSourceScenePtr batch, const size_t index)
+    {
+        auto& scene = _engine->getScene();
+        auto& models = scene.getInstancedModels();
+        auto& names = _dataSourceModels[dataSource.parameter];
+        if (index == 0)
+        {
+            for (const auto& name : names)
+                models.erase(name);
+            names.clear();
+        }
+
+        if (!batch->empty())
+        {
+            const std::string name = dataSource.parameter + ":" +
+                                     dataSource.source + "#" +
+                                     std::to_string(index);
+            models.erase(name);
+            batch->moveToModel(scene, name);
+            names.push_back(name);
+        }
+        scene.setInstancedModelsDirty(true);
+    }
+
+    /** Starts loading the next pending data source, if none is loading */
+    void _loadNextDataSource()
+    {
+        while (!_dataSourceLoading.valid() && !_pendingDataSources.empty())
+        {
+            const DataSource dataSource = _pendingDataSources.front();
+            _pendingDataSources.pop_front();
+            if (!dataSource.source.empty() &&
+                !_fitsMemoryBudget(dataSource.parameter, dataSource.source))
+                continue;
+
+            BRAYNS_INFO << "Loading " << dataSource.parameter << " "
+                        << dataSource.source << " in the background"
+                        << std::endl;
+            _loadingDataSource = dataSource;
+            _nbLoadedBatches = 0;
+            _loadedItems = 0;
+            _itemsToLoad = 0;
+            _dataSourceLoading =
+                std::async(std::launch::async,
+                           std::bind(&Impl::_loadDataSource, this, dataSource,
+                                     _createDataSourceScene(),
+                                     _parametersManager
+                                         ->getGeometryParameters()));
+        }
+        _updateLoadingProgress();
+    }
+
+    /**
+     * Swaps the batches of the loading data source that were published since
+     * the last frame into the scene, and the remaining geometry once it is
+     * loaded. Only their models are built, the rest of the scene and the
+     * engine are kept as they are.
+     */
+    void _swapLoadedDataSources()
+    {
+        if (!_dataSourceLoading.valid())
+            return;
+
+        // Batches are published before the loading completes
+        const bool loaded = _dataSourceLoading.wait_for(
+                                std::chrono::seconds(0)) ==
+                            std::future_status::ready;
+        std::deque<DataSourceScenePtr> batches;
+        {
+            std::lock_guard<std::mutex> lock(_loadedBatchesMutex);
+            batches.swap(_loadedBatches);
+        }
+        if (loaded)
+            batches.push_back(_dataSourceLoading.get());
+        if (batches.empty())
+        {
+            _updateLoadingProgress();
+            return;
+        }
+
+        for (const auto& batch : batches)
+            _addDataSourceBatch(_loadingDataSource, batch, _nbLoadedBatches++);
+        auto& scene = _engine->getScene();
+        scene.commitMaterials();
+        scene.serializeGeometry();
+        scene.commit();
+        _engine->getFrameBuffer().clear();
+
+        // The camera is set up once the first geometry of the progressively
+        // loaded scene is in place
+        if (_resetCamera && !scene.getWorldBounds().isEmpty())
+        {
+            _engine->setDefaultCamera();
+            _engine->setDefaultEpsilon();
+            _commitEngine();
+            _resetCamera = false;
+        }
+
+        if (loaded)
+        {
+            _reportMemoryUsage(_loadingDataSource.parameter);
+            _loadNextDataSource();
+        }
+        else
+            _updateLoadingProgress();
+    }
+
+    /** Reports the progress of the data sources loading to the engine */
+    void _updateLoadingProgress()
+    {
+        if (!_dataSourceLoading.valid())
+        {
+            _engine->setLoadingProgress("", 1.f);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_loadedBatchesMutex);
+        const std::string operation = "Loading " +
+                                      _loadingDataSource.parameter + " " +
+                                      _loadingDataSource.source;
+        _engine->setLoadingProgress(
+            operation, _itemsToLoad == 0 ? 0.f : float(_loadedItems) /
+                                                     float(_itemsToLoad));
+    }
+
+    /**
+     * Forgets the data sources of the previous scene, and queues the ones of
+     * the new scene that are loaded progressively
+     */
+    void _resetDataSources()
+    {
+        _pendingDataSources.clear();
+        if (_dataSourceLoading.valid())
+            _dataSourceLoading.wait();
+        _dataSourceLoading = std::future<DataSourceScenePtr>();
+        _fragments.clear();
+        _loadedBatches.clear();
+        _dataSourceModels.clear();
+
+        _sceneDataSources.clear();
+        _mergedDataSources.clear();
+        for (const auto& parameter : DATA_SOURCE_PARAMETERS)
+        {
+            const std::string source = _getDataSource(parameter);
+            if (parameter == "splash-scene-folder" || source.empty())
+                continue;
+            if (_isLoadedProgressively(parameter))
+                _pendingDataSources.push_back({parameter, source});
+            else
+                _sceneDataSources.insert(parameter);
+        }
+        _resetCamera = !_pendingDataSources.empty();
+    }
+
+    /** @return the size in bytes of a file, or of all files in a folder */
+    uint64_t _getDataSize(const std::string& source) const
+    {
+        namespace fs = boost::filesystem;
+        boost::system::error_code error;
+        if (fs::is_regular_file(source, error))
+            return fs::file_size(source, error);
+
+        uint64_t size = 0;
+        if (!fs::is_directory(source, error))
+            return size;
+        for (fs::recursive_directory_iterator it(source, error), end;
+             it != end; it.increment(error))
+        {
+            if (error)
+                break;
+            if (fs::is_regular_file(it->status()))
+                size += fs::file_size(it->path(), error);
+        }
+        return size;
+    }
+
+    void _reportMemoryUsage(const std::string& phase)
+    {
+        _engine->updateMemoryUsage();
+        auto& registry = _engine->getMemoryRegistry();
+        BRAYNS_INFO << "Memory usage after " << phase << ":" << std::endl;
+        registry.print();
+        if (!registry.fits(0))
+            BRAYNS_WARN << "Memory usage exceeds the budget" << std::endl;
+    }
+
     /**
         Loads data from SWC and H5 files located in the folder specified in the
         geometry parameters (command line parameter --morphology-folder)
     */
-    void _loadMorphologyFolder()
+    void _loadMorphologyFolder(
+        Scene& scene, const std::string& folder,
+        const GeometryParameters& geometryParameters,
+        const LoadingCallback& batchLoaded = LoadingCallback())
     {
-        auto& geometryParameters = _parametersManager->getGeometryParameters();
-        auto& scene = _engine->getScene();
-        const auto& folder = geometryParameters.getMorphologyFolder();
         BRAYNS_INFO << "Loading morphologies from " << folder << std::endl;
         MorphologyLoader morphologyLoader(geometryParameters);
 
@@ -343,6 +1061,8 @@ private:
             if (!morphologyLoader.importMorphology(uri, progress, scene))
                 BRAYNS_ERROR << "Failed to import " << file << std::endl;
             ++progress;
+            _notifyBatch(geometryParameters, batchLoaded, progress,
+                         files.size());
         }
     }
 
@@ -388,11 +1108,11 @@ private:
     /**
         Loads data from a PDB file (command line parameter --pdb-file)
     */
-    void _loadPDBFolder()
+    void _loadPDBFolder(Scene& scene, const std::string& folder,
+                        const GeometryParameters& geometryParameters,
+                        const LoadingCallback& batchLoaded = LoadingCallback())
     {
         // Load PDB File
-        auto& geometryParameters = _parametersManager->getGeometryParameters();
-        const std::string& folder = geometryParameters.getPDBFolder();
         BRAYNS_INFO << "Loading PDB folder " << folder << std::endl;
         const strings filters = {".pdb", ".pdb1"};
         const strings files = parseFolder(folder, filters);
@@ -400,25 +1120,20 @@ private:
         for (const auto& file : files)
         {
             BRAYNS_PROGRESS(progress, files.size());
-            _loadPDBFile(file);
+            _loadPDBFile(scene, file, geometryParameters);
             ++progress;
+            _notifyBatch(geometryParameters, batchLoaded, progress,
+                         files.size());
         }
     }
 
     /**
         Loads data from a PDB file (command line parameter --pdb-file)
     */
-    void _loadPDBFile(const std::string& filename)
+    void _loadPDBFile(Scene& scene, const std::string& pdbFile,
+                      const GeometryParameters& geometryParameters)
     {
         // Load PDB File
-        auto& geometryParameters = _parametersManager->getGeometryParameters();
-        auto& scene = _engine->getScene();
-        std::string pdbFile = filename;
-        if (pdbFile == "")
-        {
-            pdbFile = geometryParameters.getPDBFile();
-            BRAYNS_INFO << "Loading PDB file " << pdbFile << std::endl;
-        }
         ProteinLoader proteinLoader(geometryParameters);
         if (!proteinLoader.importPDBFile(pdbFile, Vector3f(0, 0, 0), 0, scene))
             BRAYNS_ERROR << "Failed to import " << pdbFile << std::endl;
@@ -433,30 +1148,31 @@ private:
     /**
         Loads data from a XYZR file (command line parameter --xyzr-file)
     */
-    void _loadXYZBFile()
+    void _loadXYZBFile(Scene& scene, const std::string& filename,
+                       const GeometryParameters& geometryParameters)
     {
         // Load XYZB File
-        auto& geometryParameters = _parametersManager->getGeometryParameters();
-        auto& scene = _engine->getScene();
-        BRAYNS_INFO << "Loading XYZB file " << geometryParameters.getXYZBFile()
-                    << std::endl;
+        BRAYNS_INFO << "Loading XYZB file " << filename << std::endl;
         XYZBLoader xyzbLoader(geometryParameters);
-        if (!xyzbLoader.importFromBinaryFile(geometryParameters.getXYZBFile(),
-                                             scene))
-            BRAYNS_ERROR << "Failed to import "
-                         << geometryParameters.getXYZBFile() << std::endl;
+        const bool loaded =
+            boost::filesystem::extension(filename) == ".xyz"
+                ? xyzbLoader.importFromFile(filename, scene)
+                : xyzbLoader.importFromBinaryFile(filename, scene);
+        if (!loaded)
+            BRAYNS_ERROR << "Failed to import " << filename << std::endl;
     }
 
     /**
         Loads data from mesh files located in the folder specified in the
         geometry parameters (command line parameter --mesh-folder)
     */
-    void _loadMeshFolder(const std::string& folder)
+    void _loadMeshFolder(Scene& scene, const std::string& folder,
+                         const GeometryParameters& geometryParameters,
+                         MeshLoader& meshLoader,
+                         const LoadingCallback& batchLoaded = LoadingCallback())
     {
 #ifdef BRAYNS_USE_ASSIMP
         BRAYNS_INFO << "Loading meshes from " << folder << std::endl;
-        auto& geometryParameters = _parametersManager->getGeometryParameters();
-        auto& scene = _engine->getScene();
 
         strings filters = {".obj", ".dae", ".fbx", ".ply", ".lwo",
                            ".stl", ".3ds", ".ase", ".ifc"};
@@ -484,11 +1200,13 @@ private:
                 break;
             }
 
-            if (!_meshLoader.importMeshFromFile(file, scene, quality,
-                                                Vector3f(), Vector3f(1, 1, 1),
-                                                material))
+            if (!meshLoader.importMeshFromFile(file, scene, quality,
+                                               Vector3f(), Vector3f(1, 1, 1),
+                                               material))
                 BRAYNS_ERROR << "Failed to import " << file << std::endl;
             ++progress;
+            _notifyBatch(geometryParameters, batchLoaded, progress,
+                         files.size());
         }
 #else
         BRAYNS_ERROR << "Assimp library is required to load meshes from "
@@ -500,10 +1218,10 @@ private:
         Loads morphologies from circuit configuration (command line parameter
         --circuit-configuration)
     */
-    void _loadCircuitConfiguration()
+    void _loadCircuitConfiguration(
+        Scene& scene, const GeometryParameters& geometryParameters,
+        const LoadingCallback& batchLoaded = LoadingCallback())
     {
-        auto& geometryParameters = _parametersManager->getGeometryParameters();
-        auto& scene = _engine->getScene();
         const std::string& filename =
             geometryParameters.getCircuitConfiguration();
         const std::string& target = geometryParameters.getTarget();
@@ -514,7 +1232,7 @@ private:
         MorphologyLoader morphologyLoader(geometryParameters);
         const servus::URI uri(filename);
         if (report.empty())
-            morphologyLoader.importCircuit(uri, target, scene);
+            morphologyLoader.importCircuit(uri, target, scene, batchLoaded);
         else
             morphologyLoader.importCircuit(uri, target, report, scene);
     }
@@ -818,6 +1536,8 @@ private:
             !renderParams.getLightEmittingMaterials());
     }
 
+    // Outlives the engines, so that timings are kept when switching engines
+    PerformanceCounters _performanceCounters;
     std::unique_ptr<EngineFactory> _engineFactory;
     ParametersManagerPtr _parametersManager;
     EnginePtr _engine;
@@ -825,6 +1545,25 @@ private:
     AbstractManipulatorPtr _cameraManipulator;
     MeshLoader _meshLoader;
 
+    // Data sources loaded as instanced models, by parameter
+    std::map<std::string, strings> _dataSourceModels;
+    // Data sources loaded with the scene, and those of them merged into its
+    // geometry
+    std::set<std::string> _sceneDataSources;
+    std::set<std::string> _mergedDataSources;
+    std::deque<DataSource> _pendingDataSources;
+    DataSource _loadingDataSource;
+    std::future<DataSourceScenePtr> _dataSourceLoading;
+    std::map<std::string, std::future<DataSourceScenePtr>> _fragments;
+    size_t _nbLoadedBatches;
+    bool _resetCamera;
+
+    // Batches published by the loading thread
+    std::mutex _loadedBatchesMutex;
+    std::deque<DataSourceScenePtr> _loadedBatches;
+    size_t _loadedItems;
+    size_t _itemsToLoad;
+
 #if (BRAYNS_USE_DEFLECT || BRAYNS_USE_NETWORKING)
     ExtensionPluginFactoryPtr _extensionPluginFactory;
 #endif
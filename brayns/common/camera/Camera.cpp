@@ -21,6 +21,9 @@
 
 #include "Camera.h"
 #include <brayns/common/log.h>
+
+#include <cmath>
+
 #ifdef BRAYNS_USE_ZEROBUF
 #include <zerobuf/render/camera.h>
 #endif
@@ -44,6 +47,8 @@ public:
         , _fieldOfView(45.f)
         , _stereoMode(CameraStereoMode::none)
         , _eyeSeparation(0.0635f)
+        , _windowStart(0.f, 0.f)
+        , _windowEnd(1.f, 1.f)
     {
         if (_type == CameraType::stereo)
             setStereoMode(CameraStereoMode::side_by_side);
@@ -287,6 +292,17 @@ public:
     }
 
     ClipPlanes& getClipPlanes() { return _clipPlanes; }
+    void setWindow(const Vector2f& start, const Vector2f& end)
+    {
+        if (_windowStart == start && _windowEnd == end)
+            return;
+        _windowStart = start;
+        _windowEnd = end;
+        modified = true;
+    }
+
+    const Vector2f& getWindowStart() const { return _windowStart; }
+    const Vector2f& getWindowEnd() const { return _windowEnd; }
     bool modified = false;
 
     /*! rotation matrice along x and y axis */
@@ -311,6 +327,9 @@ private:
     mutable float _eyeSeparation;
 
     ClipPlanes _clipPlanes;
+
+    Vector2f _windowStart;
+    Vector2f _windowEnd;
 };
 
 Camera::Camera(const CameraType cameraType)
@@ -468,6 +487,41 @@ ClipPlanes& Camera::getClipPlanes()
     return _impl->getClipPlanes();
 }
 
+void Camera::setWindow(const Vector2f& start, const Vector2f& end)
+{
+    _impl->setWindow(start, end);
+}
+
+const Vector2f& Camera::getWindowStart() const
+{
+    return _impl->getWindowStart();
+}
+
+const Vector2f& Camera::getWindowEnd() const
+{
+    return _impl->getWindowEnd();
+}
+
+void Camera::getPrimaryRay(const Vector2f& position, Vector3f& origin,
+                           Vector3f& direction) const
+{
+    // The frame buffer only covers the window of the image plane
+    const auto& windowStart = getWindowStart();
+    const auto& windowEnd = getWindowEnd();
+    const Vector2f screen = windowStart + (windowEnd - windowStart) * position;
+
+    const auto dir = normalize(getTarget() - getPosition());
+    const auto du = normalize(cross(dir, getUp()));
+    const auto dv = cross(du, dir);
+    const float imagePlaneHeight =
+        2.f * std::tan(0.5f * getFieldOfView() * M_PI / 180.f);
+    const float imagePlaneWidth = imagePlaneHeight * getAspectRatio();
+
+    origin = getPosition();
+    direction = dir + du * ((screen.x() - 0.5f) * imagePlaneWidth) +
+                dv * ((screen.y() - 0.5f) * imagePlaneHeight);
+}
+
 std::ostream& operator<<(std::ostream& os, Camera& camera)
 {
     const auto& position = camera.getPosition();
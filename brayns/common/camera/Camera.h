@@ -225,6 +225,34 @@ public:
     */
     BRAYNS_API ClipPlanes& getClipPlanes();
 
+    /**
+       Restricts rendering to a region of the image plane, so that a frame
+       buffer only receives the corresponding tile of the full image.
+       Coordinates are normalized, (0,0) being the bottom left corner of the
+       full image and (1,1) the top right one.
+       @param start Bottom left corner of the region
+       @param end Top right corner of the region
+    */
+    BRAYNS_API void setWindow(const Vector2f& start, const Vector2f& end);
+
+    /** @return the bottom left corner of the rendered region */
+    BRAYNS_API const Vector2f& getWindowStart() const;
+
+    /** @return the top right corner of the rendered region */
+    BRAYNS_API const Vector2f& getWindowEnd() const;
+
+    /**
+       Computes the ray going through a point of the frame buffer, as cast by
+       a perspective camera
+       @param position Normalized frame buffer coordinates, (0,0) being the
+              bottom left corner of the frame buffer and (1,1) the top right
+              one
+       @param origin Origin of the ray
+       @param direction Direction of the ray, not normalized
+    */
+    BRAYNS_API void getPrimaryRay(const Vector2f& position, Vector3f& origin,
+                                  Vector3f& direction) const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> _impl;
@@ -30,9 +30,15 @@
 
 namespace brayns
 {
-Engine::Engine(ParametersManager& parametersManager)
+Engine::Engine(ParametersManager& parametersManager,
+               PerformanceCounters& performanceCounters)
     : _parametersManager(parametersManager)
+    , _performanceCounters(performanceCounters)
+    , _loadingProgress(1.f)
 {
+    const uint64_t budget =
+        _parametersManager.getApplicationParameters().getMemoryBudget();
+    _memoryRegistry.setBudget(budget * 1024 * 1024);
 }
 
 Engine::~Engine()
@@ -46,14 +52,23 @@ void Engine::setActiveRenderer(const RendererType renderer)
         _activeRenderer = renderer;
 }
 
-void Engine::reshape(const Vector2ui& frameSize)
+void Engine::updateMemoryUsage()
 {
-    if (_frameBuffer->getSize() == frameSize)
-        return;
+    _memoryRegistry.clear();
+    _scene->reportMemoryUsage(_memoryRegistry);
+    _memoryRegistry.set("frame buffer", _frameBuffer->getMemoryUsage());
+}
 
-    _frameBuffer->resize(frameSize);
-    _camera->setAspectRatio(static_cast<float>(frameSize.x()) /
-                            static_cast<float>(frameSize.y()));
+void Engine::reshape(const Vector2ui& frameSize)
+{
+    if (_frameBuffer->getSize() != frameSize)
+        _frameBuffer->resize(frameSize);
+
+    // When the camera only renders a region of the image, the aspect ratio is
+    // the one of the full image
+    const Vector2f window = _camera->getWindowEnd() - _camera->getWindowStart();
+    _camera->setAspectRatio(static_cast<float>(frameSize.x()) * window.y() /
+                            (static_cast<float>(frameSize.y()) * window.x()));
 }
 
 void Engine::commit()
@@ -61,8 +76,6 @@ void Engine::commit()
     auto& sceneParams = _parametersManager.getSceneParameters();
     sceneParams.setTimestamp(sceneParams.getTimestamp() +
                              sceneParams.getAnimationDelta());
-
-    _frameBuffer->clear();
 }
 
 void Engine::_render(const RenderInput& renderInput, RenderOutput& renderOutput)
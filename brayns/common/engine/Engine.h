@@ -22,6 +22,8 @@
 #define ENGINE_H
 
 #include <brayns/common/types.h>
+#include <brayns/common/utils/MemoryRegistry.h>
+#include <brayns/common/utils/PerformanceCounters.h>
 
 namespace brayns
 {
@@ -40,8 +42,11 @@ public:
      * @brief Engine contructor
      * @param parametersManager holds all engine parameters (geometry,
      * rendering, etc)
+     * @param performanceCounters timings of the main rendering phases, which
+     * outlive the engine
      */
-    explicit Engine(ParametersManager& parametersManager);
+    Engine(ParametersManager& parametersManager,
+           PerformanceCounters& performanceCounters);
     virtual ~Engine();
 
     /**
@@ -51,7 +56,8 @@ public:
 
     /**
        Commits changes to the engine. This include scene and camera
-       modifications
+       modifications. Engines are in charge of restarting the accumulation
+       when the changes affect the image.
     */
     virtual void commit();
 
@@ -76,9 +82,35 @@ public:
     Camera& getCamera() { return *_camera; }
     /** Gets the renderer */
     Renderer& getRenderer();
+    /** Gets the timings of the main rendering phases */
+    PerformanceCounters& getPerformanceCounters()
+    {
+        return _performanceCounters;
+    }
+    /** Gets the memory held by the scene and the frame buffer */
+    MemoryRegistry& getMemoryRegistry() { return _memoryRegistry; }
+    /** Refreshes the memory registry from the scene and the frame buffer */
+    void updateMemoryUsage();
+
+    /**
+       Sets the progress of the data loaded in the background
+       @param operation Description of the data being loaded, empty once all
+              data is loaded
+       @param progress Fraction of that data already in the scene, between 0
+              and 1
+    */
+    void setLoadingProgress(const std::string& operation, const float progress)
+    {
+        _loadingOperation = operation;
+        _loadingProgress = progress;
+    }
+    /** Description of the data being loaded, empty if none */
+    const std::string& getLoadingOperation() const { return _loadingOperation; }
+    /** Fraction of the data being loaded that is already in the scene */
+    float getLoadingProgress() const { return _loadingProgress; }
 
     /** Active renderer */
-    void setActiveRenderer(const RendererType renderer);
+    virtual void setActiveRenderer(const RendererType renderer);
     RendererType getActiveRenderer() { return _activeRenderer; }
     /**
        Reshapes the current frame buffers
@@ -124,17 +156,29 @@ public:
      */
     std::function<void()> recreate;
 
+    /**
+     * Loads the data sources of the given geometry parameters in the
+     * background, as models that are added to the scene once loaded. The
+     * loading is delegated to the Brayns instance.
+     * @return false if the engine must be recreated to apply the parameters
+     */
+    std::function<bool(const strings& parameters)> updateDataSources;
+
 protected:
     void _render(const RenderInput& renderInput, RenderOutput& renderOutput);
     void _render();
 
     ParametersManager& _parametersManager;
+    PerformanceCounters& _performanceCounters;
     ScenePtr _scene;
     CameraPtr _camera;
     RendererType _activeRenderer;
     RendererMap _renderers;
     Vector2i _frameSize;
     FrameBufferPtr _frameBuffer;
+    MemoryRegistry _memoryRegistry;
+    std::string _loadingOperation;
+    float _loadingProgress;
 };
 }
 
@@ -25,6 +25,8 @@ namespace brayns
 Primitive::Primitive(const size_t materialId, const float timestamp)
     : _materialId(materialId)
     , _timestamp(timestamp)
+    , _gid(0)
+    , _sectionId(0)
 {
     _geometryType = GT_UNDEFINED;
 }
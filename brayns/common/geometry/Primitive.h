@@ -37,6 +37,16 @@ public:
     BRAYNS_API virtual ~Primitive() {}
     BRAYNS_API size_t getMaterialId() const { return _materialId; }
     BRAYNS_API float getTimestamp() const { return _timestamp; }
+    /** @return GID of the cell the primitive belongs to, 0 if none */
+    BRAYNS_API uint32_t getGid() const { return _gid; }
+    /** @return Section of the cell the primitive belongs to */
+    BRAYNS_API uint32_t getSectionId() const { return _sectionId; }
+    /** Sets the cell and the section the primitive belongs to */
+    BRAYNS_API void setCellSection(const uint32_t gid, const uint32_t sectionId)
+    {
+        _gid = gid;
+        _sectionId = sectionId;
+    }
     BRAYNS_API virtual size_t serializeData(floats& serializedData) = 0;
     BRAYNS_API static size_t getSerializationSize()
     {
@@ -47,6 +57,8 @@ protected:
     static size_t _serializationSize;
     size_t _materialId;
     float _timestamp;
+    uint32_t _gid;
+    uint32_t _sectionId;
 };
 }
 
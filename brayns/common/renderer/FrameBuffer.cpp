@@ -20,6 +20,8 @@
 
 #include "FrameBuffer.h"
 
+#include <brayns/common/utils/MemoryRegistry.h>
+
 namespace brayns
 {
 FrameBuffer::FrameBuffer(const Vector2ui& frameSize,
@@ -45,4 +47,32 @@ size_t FrameBuffer::getColorDepth()
         return 0;
     }
 }
+
+MemoryUsage FrameBuffer::getMemoryUsage() const
+{
+    size_t colorSize = 0;
+    switch (_frameBufferFormat)
+    {
+    case FBF_RGBA_I8:
+    case FBF_BGRA_I8:
+        colorSize = 4;
+        break;
+    case FBF_RGB_I8:
+        colorSize = 3;
+        break;
+    case FBF_RGBA_F32:
+        colorSize = 4 * sizeof(float);
+        break;
+    default:
+        break;
+    }
+    size_t pixelSize = colorSize + sizeof(float);
+    if (_accumulation)
+        pixelSize += 4 * sizeof(float);
+
+    MemoryUsage usage;
+    usage.reserved = uint64_t(_frameSize.x()) * _frameSize.y() * pixelSize;
+    usage.resident = usage.reserved;
+    return usage;
+}
 }
@@ -43,6 +43,15 @@ public:
 
     virtual void resize(const Vector2ui& frameSize) = 0;
 
+    /**
+     * @return the fraction of the frame size at which images are rendered, 1
+     * if they are rendered at full resolution
+     */
+    virtual float getScale() const { return 1.f; }
+
+    /** @return the memory held by the color, depth and accumulation buffers */
+    BRAYNS_API virtual MemoryUsage getMemoryUsage() const;
+
     Vector2ui getSize() const { return _frameSize; }
     void setAccumulation(const bool accumulation)
     {
@@ -26,6 +26,7 @@ namespace brayns
 {
 Renderer::Renderer(ParametersManager& parametersManager)
     : _parametersManager(parametersManager)
+    , _modified(true)
 {
 }
 }
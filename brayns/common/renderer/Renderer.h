@@ -37,9 +37,20 @@ public:
     BRAYNS_API void setScene(ScenePtr scene) { _scene = scene; };
     BRAYNS_API virtual void setCamera(CameraPtr camera) = 0;
 
+    /**
+       @return true if a commit may have changed the rendered image after the
+               last resetModified(), in which case the accumulation must be
+               restarted. Renderers that do not track their parameters are
+               always modified.
+    */
+    BRAYNS_API bool getModified() const { return _modified; }
+    /** Reset the modified flag */
+    BRAYNS_API void resetModified() { _modified = false; }
+
 protected:
     ParametersManager& _parametersManager;
     ScenePtr _scene;
+    bool _modified;
 };
 }
 #endif // RENDERER_H
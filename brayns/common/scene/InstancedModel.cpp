@@ -0,0 +1,42 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "InstancedModel.h"
+
+namespace brayns
+{
+Boxf InstancedModel::getInstanceBounds(const size_t instance) const
+{
+    const Matrix4f& transformation = _instances[instance];
+    const Vector3f& min = _bounds.getMin();
+    const Vector3f& max = _bounds.getMax();
+    Boxf bounds;
+    for (size_t corner = 0; corner < 8; ++corner)
+    {
+        const Vector4f point((corner & 1) ? max.x() : min.x(),
+                             (corner & 2) ? max.y() : min.y(),
+                             (corner & 4) ? max.z() : min.z(), 1.f);
+        const Vector4f transformed = transformation * point;
+        bounds.merge(
+            Vector3f(transformed.x(), transformed.y(), transformed.z()));
+    }
+    return bounds;
+}
+}
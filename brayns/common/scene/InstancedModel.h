@@ -0,0 +1,83 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef INSTANCEDMODEL_H
+#define INSTANCEDMODEL_H
+
+#include <brayns/api.h>
+#include <brayns/common/geometry/Cone.h>
+#include <brayns/common/geometry/Cylinder.h>
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/common/geometry/TrianglesMesh.h>
+#include <brayns/common/types.h>
+
+namespace brayns
+{
+/**
+ * Geometry that is built once and placed many times in the scene, for
+ * instance a protein of a molecular system. Primitives and meshes are
+ * expressed in the model space, and every instance places a copy of them with
+ * its own transformation. Engines build the geometry once and map the
+ * instances onto their own instancing, so that memory scales with the number
+ * of models rather than with the number of instances.
+ *
+ * Engines keep the geometry they have built for a model as long as the scene
+ * holds the same model object, so a model is replaced rather than modified to
+ * change its geometry.
+ */
+class InstancedModel
+{
+public:
+    /** @return Spheres of the model, by material */
+    SpheresMap& getSpheres() { return _spheres; }
+    /** @return Cylinders of the model, by material */
+    CylindersMap& getCylinders() { return _cylinders; }
+    /** @return Cones of the model, by material */
+    ConesMap& getCones() { return _cones; }
+    /** @return Triangle meshes of the model, by material */
+    TrianglesMeshMap& getTriangleMeshes() { return _trianglesMeshes; }
+
+    /** @return Bounds of the model geometry, in model space */
+    Boxf& getBounds() { return _bounds; }
+    const Boxf& getBounds() const { return _bounds; }
+    /** @return Transformations of the instances of the model */
+    const Matrix4fs& getInstances() const { return _instances; }
+    /**
+     * Places a copy of the model in the scene
+     * @param transformation Model to world transformation of the instance
+     */
+    void addInstance(const Matrix4f& transformation)
+    {
+        _instances.push_back(transformation);
+    }
+
+    /** @return Bounds of the given instance, in world space */
+    BRAYNS_API Boxf getInstanceBounds(size_t instance) const;
+
+private:
+    SpheresMap _spheres;
+    CylindersMap _cylinders;
+    ConesMap _cones;
+    TrianglesMeshMap _trianglesMeshes;
+    Boxf _bounds;
+    Matrix4fs _instances;
+};
+}
+#endif // INSTANCEDMODEL_H
@@ -22,6 +22,8 @@
 
 #include <brayns/common/log.h>
 #include <brayns/common/material/Material.h>
+#include <brayns/common/scene/SpatialIndex.h>
+#include <brayns/common/utils/MemoryRegistry.h>
 #include <brayns/common/volume/VolumeHandler.h>
 #include <brayns/io/NESTLoader.h>
 #include <brayns/io/TransferFunctionLoader.h>
@@ -31,6 +33,45 @@
 
 #include <boost/filesystem.hpp>
 
+namespace
+{
+/**
+ * Primitives are allocated one by one and owned by shared pointers, each
+ * with its own reference count block
+ */
+const size_t SHARED_POINTER_OVERHEAD = 2 * sizeof(void*) + 2 * sizeof(int);
+
+template <typename T>
+brayns::MemoryUsage getPrimitivesMemoryUsage(
+    const std::map<size_t, std::vector<std::shared_ptr<T>>>& primitives)
+{
+    brayns::MemoryUsage usage;
+    for (const auto& materialPrimitives : primitives)
+    {
+        brayns::addMemoryUsage(materialPrimitives.second, usage);
+        const uint64_t size = materialPrimitives.second.size() *
+                              (sizeof(T) + SHARED_POINTER_OVERHEAD);
+        usage.resident += size;
+        usage.reserved += size;
+    }
+    return usage;
+}
+
+void addMeshesMemoryUsage(brayns::TrianglesMeshMap& meshes,
+                          brayns::MemoryUsage& usage)
+{
+    for (auto& trianglesMesh : meshes)
+    {
+        auto& mesh = trianglesMesh.second;
+        brayns::addMemoryUsage(mesh.getVertices(), usage);
+        brayns::addMemoryUsage(mesh.getNormals(), usage);
+        brayns::addMemoryUsage(mesh.getColors(), usage);
+        brayns::addMemoryUsage(mesh.getIndices(), usage);
+        brayns::addMemoryUsage(mesh.getTextureCoordinates(), usage);
+    }
+}
+}
+
 namespace brayns
 {
 Scene::Scene(Renderers renderers, ParametersManager& parametersManager)
@@ -40,6 +81,7 @@ Scene::Scene(Renderers renderers, ParametersManager& parametersManager)
     , _cylindersDirty(true)
     , _conesDirty(true)
     , _trianglesMeshesDirty(true)
+    , _instancedModelsDirty(true)
     , _volumeHandler(nullptr)
     , _simulationHandler(nullptr)
     , _caDiffusionSimulationHandler(nullptr)
@@ -57,16 +99,121 @@ void Scene::reset()
     _cylinders.clear();
     _cones.clear();
     _trianglesMeshes.clear();
+    _instancedModels.clear();
     _bounds.reset();
     _caDiffusionSimulationHandler.reset();
 }
 
+void Scene::addSpheres(const size_t materialId, Spheres&& spheres,
+                       const Boxf& bounds)
+{
+    auto& materialSpheres = _spheres[materialId];
+    if (materialSpheres.empty())
+        materialSpheres = std::move(spheres);
+    else
+        materialSpheres.insert(materialSpheres.end(),
+                               std::make_move_iterator(spheres.begin()),
+                               std::make_move_iterator(spheres.end()));
+    _bounds.merge(bounds);
+    _spheresDirty = true;
+    if (_spatialIndex)
+        _spatialIndex->invalidate();
+}
+
+InstancedModel& Scene::getInstancedModel(const std::string& name)
+{
+    auto& model = _instancedModels[name];
+    if (!model)
+        model.reset(new InstancedModel);
+    return *model;
+}
+
+void Scene::addInstance(const std::string& name,
+                        const Matrix4f& transformation)
+{
+    auto& model = getInstancedModel(name);
+    model.addInstance(transformation);
+    if (!model.getBounds().isEmpty())
+        _bounds.merge(
+            model.getInstanceBounds(model.getInstances().size() - 1));
+    _instancedModelsDirty = true;
+}
+
+void Scene::setSphereCenters(const size_t materialId, const Vector3f* centers,
+                             const size_t nbCenters)
+{
+    auto& spheres = _spheres[materialId];
+    const size_t nbSpheres = std::min(nbCenters, spheres.size());
+    for (size_t i = 0; i < nbSpheres; ++i)
+        spheres[i]->setCenter(centers[i]);
+    if (_spatialIndex)
+        _spatialIndex->invalidate();
+}
+
+SpatialIndex& Scene::getSpatialIndex()
+{
+    if (!_spatialIndex)
+        _spatialIndex.reset(new SpatialIndex(*this));
+    return *_spatialIndex;
+}
+
+void Scene::reportMemoryUsage(MemoryRegistry& registry)
+{
+    registry.set("scene/spheres", getPrimitivesMemoryUsage(_spheres));
+    registry.set("scene/cylinders", getPrimitivesMemoryUsage(_cylinders));
+    registry.set("scene/cones", getPrimitivesMemoryUsage(_cones));
+
+    MemoryUsage meshesUsage;
+    addMeshesMemoryUsage(_trianglesMeshes, meshesUsage);
+    registry.set("scene/meshes", meshesUsage);
+
+    MemoryUsage instancedModelsUsage;
+    for (const auto& instancedModel : _instancedModels)
+    {
+        auto& model = *instancedModel.second;
+        const MemoryUsage primitivesUsages[] = {
+            getPrimitivesMemoryUsage(model.getSpheres()),
+            getPrimitivesMemoryUsage(model.getCylinders()),
+            getPrimitivesMemoryUsage(model.getCones())};
+        for (const auto& usage : primitivesUsages)
+        {
+            instancedModelsUsage.resident += usage.resident;
+            instancedModelsUsage.reserved += usage.reserved;
+        }
+        addMeshesMemoryUsage(model.getTriangleMeshes(), instancedModelsUsage);
+        addMemoryUsage(model.getInstances(), instancedModelsUsage);
+    }
+    registry.set("scene/instanced models", instancedModelsUsage);
+
+    if (_spatialIndex)
+        registry.set("scene/spatial index", _spatialIndex->getMemoryUsage());
+
+    MemoryUsage texturesUsage;
+    for (const auto& texture : _textures)
+    {
+        const auto& t = texture.second;
+        const uint64_t size = uint64_t(t->getWidth()) * t->getHeight() *
+                              t->getNbChannels() * t->getDepth();
+        texturesUsage.resident += size;
+        texturesUsage.reserved += size;
+    }
+    registry.set("textures", texturesUsage);
+
+    if (_simulationHandler)
+        registry.set("simulation", _simulationHandler->getMemoryUsage());
+    if (_volumeHandler)
+        registry.set("volume", _volumeHandler->getMemoryUsage());
+}
+
 void Scene::setDirty()
 {
     _spheresDirty = true;
     _cylindersDirty = true;
     _conesDirty = true;
     _trianglesMeshesDirty = true;
+    _instancedModelsDirty = true;
+    if (_spatialIndex)
+        _spatialIndex->invalidate();
 }
 
 void Scene::setMaterials(const MaterialType materialType,
@@ -564,6 +711,6 @@ VolumeHandlerPtr Scene::getVolumeHandler()
 bool Scene::empty() const
 {
     return _spheres.empty() && _cylinders.empty() && _cones.empty() &&
-           _trianglesMeshes.empty();
+           _trianglesMeshes.empty() && _instancedModels.empty();
 }
 }
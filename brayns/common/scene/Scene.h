@@ -28,6 +28,7 @@
 #include <brayns/common/geometry/TrianglesMesh.h>
 #include <brayns/common/material/Material.h>
 #include <brayns/common/material/Texture2D.h>
+#include <brayns/common/scene/InstancedModel.h>
 #include <brayns/common/simulation/AbstractSimulationHandler.h>
 #include <brayns/common/transferFunction/TransferFunction.h>
 #include <brayns/common/types.h>
@@ -173,6 +174,21 @@ public:
         Returns spheres handled by the scene
     */
     BRAYNS_API SpheresMap& getSpheres() { return _spheres; }
+    /**
+        Appends spheres to the given material in one go, and merges their
+        bounds into the world bounds
+    */
+    BRAYNS_API void addSpheres(size_t materialId, Spheres&& spheres,
+                               const Boxf& bounds);
+    /**
+        Moves the first spheres of the given material to the given centers,
+        keeping their radius and values. Engines update their serialized
+        copy in place, so that the geometry does not need to be serialized
+        again.
+    */
+    BRAYNS_API virtual void setSphereCenters(size_t materialId,
+                                             const Vector3f* centers,
+                                             size_t nbCenters);
     /**
         Returns cylinders handled by the scene
     */
@@ -197,6 +213,34 @@ public:
         return _trianglesMeshes;
     }
 
+    /**
+        Returns models that are built once and instanced in the scene
+    */
+    BRAYNS_API InstancedModelsMap& getInstancedModels()
+    {
+        return _instancedModels;
+    }
+    /**
+        Returns the instanced model with the given name, creating an empty
+        one if it does not exist yet
+    */
+    BRAYNS_API InstancedModel& getInstancedModel(const std::string& name);
+    /**
+        Places an instance of the given model in the scene, and merges its
+        bounds into the world bounds. The model geometry must be complete
+        before its instances are added.
+        @param name Name of the instanced model
+        @param transformation Model to world transformation of the instance
+    */
+    BRAYNS_API void addInstance(const std::string& name,
+                                const Matrix4f& transformation);
+
+    /**
+        Returns the spatial index of the scene primitives, used for picking
+        and region queries
+    */
+    BRAYNS_API SpatialIndex& getSpatialIndex();
+
     /**
         Returns the simulutation handler
     */
@@ -243,6 +287,12 @@ public:
     */
     BRAYNS_API virtual void saveSceneToCacheFile() = 0;
 
+    /**
+     * Reports the memory held by the scene geometry, textures, simulation and
+     * volume data to the given registry
+     */
+    BRAYNS_API virtual void reportMemoryUsage(MemoryRegistry& registry);
+
     /**
      * @return true if the given volume file is supported by the engines' scene.
      *         If false, a default scene will be constructed.
@@ -282,6 +332,15 @@ public:
         _trianglesMeshesDirty = value;
     }
 
+    /**
+     * @brief Sets instanced models as dirty, meaning that they need to be
+     *        built and sent to the rendering engine
+     */
+    BRAYNS_API void setInstancedModelsDirty(const bool value)
+    {
+        _instancedModelsDirty = value;
+    }
+
     /**
      * @brief Sets all geometries as dirty, meaning that they need to be
      *        serialized and sent to the rendering engine
@@ -302,6 +361,8 @@ protected:
     bool _conesDirty;
     TrianglesMeshMap _trianglesMeshes;
     bool _trianglesMeshesDirty;
+    InstancedModelsMap _instancedModels;
+    bool _instancedModelsDirty;
     MaterialsMap _materials;
     TexturesMap _textures;
     Lights _lights;
@@ -316,6 +377,7 @@ protected:
 
     // Scene
     Boxf _bounds;
+    SpatialIndexPtr _spatialIndex;
 };
 }
 #endif // SCENE_H
@@ -0,0 +1,834 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "SpatialIndex.h"
+
+#include <brayns/common/geometry/Cone.h>
+#include <brayns/common/geometry/Cylinder.h>
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/common/geometry/TrianglesMesh.h>
+#include <brayns/common/log.h>
+#include <brayns/common/scene/InstancedModel.h>
+#include <brayns/common/scene/Scene.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+namespace
+{
+// Leaves hold a few primitives so that the hierarchy stays small compared to
+// the primitives themselves
+const uint32_t MAX_PRIMITIVES_PER_LEAF = 8;
+// A median split halves the primitives at every level, so that 64 levels are
+// never reached
+const size_t MAX_TRAVERSAL_DEPTH = 64;
+// Smaller subtrees are built by the thread that split their parent
+const uint32_t MIN_PRIMITIVES_PER_TASK = 65536;
+
+void mergeSphere(brayns::Boxf& bounds, const brayns::Vector3f& center,
+                 const float radius)
+{
+    const brayns::Vector3f extent(radius, radius, radius);
+    bounds.merge(center - extent);
+    bounds.merge(center + extent);
+}
+
+brayns::Vector3f transformPoint(const brayns::Matrix4f& matrix,
+                                const brayns::Vector3f& point)
+{
+    const brayns::Vector4f transformed =
+        matrix * brayns::Vector4f(point.x(), point.y(), point.z(), 1.f);
+    return brayns::Vector3f(transformed.x(), transformed.y(), transformed.z());
+}
+
+brayns::Vector3f transformDirection(const brayns::Matrix4f& matrix,
+                                    const brayns::Vector3f& direction)
+{
+    const brayns::Vector4f transformed =
+        matrix *
+        brayns::Vector4f(direction.x(), direction.y(), direction.z(), 0.f);
+    return brayns::Vector3f(transformed.x(), transformed.y(), transformed.z());
+}
+
+brayns::Boxf transformBounds(const brayns::Matrix4f& matrix,
+                             const brayns::Boxf& bounds)
+{
+    const brayns::Vector3f& min = bounds.getMin();
+    const brayns::Vector3f& max = bounds.getMax();
+    brayns::Boxf transformed;
+    for (size_t corner = 0; corner < 8; ++corner)
+        transformed.merge(transformPoint(
+            matrix, brayns::Vector3f((corner & 1) ? max.x() : min.x(),
+                                     (corner & 2) ? max.y() : min.y(),
+                                     (corner & 4) ? max.z() : min.z())));
+    return transformed;
+}
+
+bool overlaps(const brayns::Boxf& first, const brayns::Boxf& second)
+{
+    for (size_t axis = 0; axis < 3; ++axis)
+        if (first.getMin()[axis] > second.getMax()[axis] ||
+            second.getMin()[axis] > first.getMax()[axis])
+            return false;
+    return true;
+}
+
+/**
+ * Slab test of a ray against bounds
+ * @param entry Distance at which the ray enters the bounds
+ * @return true if the ray enters the bounds before maxDistance
+ */
+bool intersectBounds(const brayns::Boxf& bounds,
+                     const brayns::Vector3f& origin,
+                     const brayns::Vector3f& inverseDirection,
+                     const float maxDistance, float& entry)
+{
+    float nearest = 0.f;
+    float farthest = maxDistance;
+    for (size_t axis = 0; axis < 3; ++axis)
+    {
+        float t0 = (bounds.getMin()[axis] - origin[axis]) *
+                   inverseDirection[axis];
+        float t1 = (bounds.getMax()[axis] - origin[axis]) *
+                   inverseDirection[axis];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        nearest = std::max(nearest, t0);
+        farthest = std::min(farthest, t1);
+        if (nearest > farthest)
+            return false;
+    }
+    entry = nearest;
+    return true;
+}
+
+bool intersectSphere(const brayns::Vector3f& center, const float radius,
+                     const brayns::Vector3f& origin,
+                     const brayns::Vector3f& direction,
+                     const float maxDistance, float& distance)
+{
+    const brayns::Vector3f offset = origin - center;
+    const float a = direction.dot(direction);
+    const float b = offset.dot(direction);
+    const float c = offset.dot(offset) - radius * radius;
+    const float discriminant = b * b - a * c;
+    if (discriminant < 0.f)
+        return false;
+
+    const float root = std::sqrt(discriminant);
+    float t = (-b - root) / a;
+    if (t < 0.f)
+        t = (-b + root) / a;
+    if (t < 0.f || t >= maxDistance)
+        return false;
+    distance = t;
+    return true;
+}
+
+/**
+ * Intersects a ray with the side of a truncated cone, cylinders being cones
+ * with the same radius at both ends. Ends are left open since morphologies
+ * close them with spheres.
+ */
+bool intersectCone(const brayns::Vector3f& base, const float baseRadius,
+                   const brayns::Vector3f& top, const float topRadius,
+                   const brayns::Vector3f& origin,
+                   const brayns::Vector3f& direction, const float maxDistance,
+                   float& distance)
+{
+    brayns::Vector3f axis = top - base;
+    const float height = axis.length();
+    if (height == 0.f)
+        return false;
+    axis /= height;
+
+    // Points at distance s along the axis are at radius baseRadius + slope * s
+    const float slope = (topRadius - baseRadius) / height;
+    const brayns::Vector3f offset = origin - base;
+    const float offsetAlongAxis = offset.dot(axis);
+    const float directionAlongAxis = direction.dot(axis);
+    const brayns::Vector3f radialOffset = offset - axis * offsetAlongAxis;
+    const brayns::Vector3f radialDirection =
+        direction - axis * directionAlongAxis;
+    const float radius = baseRadius + slope * offsetAlongAxis;
+
+    const float a = radialDirection.dot(radialDirection) -
+                    slope * slope * directionAlongAxis * directionAlongAxis;
+    const float b = 2.f * (radialOffset.dot(radialDirection) -
+                           slope * directionAlongAxis * radius);
+    const float c = radialOffset.dot(radialOffset) - radius * radius;
+
+    float roots[2];
+    size_t nbRoots = 0;
+    if (a == 0.f)
+    {
+        if (b == 0.f)
+            return false;
+        roots[nbRoots++] = -c / b;
+    }
+    else
+    {
+        const float discriminant = b * b - 4.f * a * c;
+        if (discriminant < 0.f)
+            return false;
+        const float root = std::sqrt(discriminant);
+        roots[0] = (-b - root) / (2.f * a);
+        roots[1] = (-b + root) / (2.f * a);
+        if (roots[0] > roots[1])
+            std::swap(roots[0], roots[1]);
+        nbRoots = 2;
+    }
+
+    for (size_t i = 0; i < nbRoots; ++i)
+    {
+        const float t = roots[i];
+        if (t < 0.f || t >= maxDistance)
+            continue;
+        const float s = offsetAlongAxis + t * directionAlongAxis;
+        // Discard the hits beyond the ends and on the mirrored cone
+        if (s < 0.f || s > height || baseRadius + slope * s < 0.f)
+            continue;
+        distance = t;
+        return true;
+    }
+    return false;
+}
+
+bool intersectTriangle(const brayns::Vector3f& v0, const brayns::Vector3f& v1,
+                       const brayns::Vector3f& v2,
+                       const brayns::Vector3f& origin,
+                       const brayns::Vector3f& direction,
+                       const float maxDistance, float& distance)
+{
+    const brayns::Vector3f edge1 = v1 - v0;
+    const brayns::Vector3f edge2 = v2 - v0;
+    const brayns::Vector3f p = cross(direction, edge2);
+    const float determinant = edge1.dot(p);
+    if (determinant == 0.f)
+        return false;
+
+    const float inverseDeterminant = 1.f / determinant;
+    const brayns::Vector3f s = origin - v0;
+    const float u = s.dot(p) * inverseDeterminant;
+    if (u < 0.f || u > 1.f)
+        return false;
+
+    const brayns::Vector3f q = cross(s, edge1);
+    const float v = direction.dot(q) * inverseDeterminant;
+    if (v < 0.f || u + v > 1.f)
+        return false;
+
+    const float t = edge2.dot(q) * inverseDeterminant;
+    if (t < 0.f || t >= maxDistance)
+        return false;
+    distance = t;
+    return true;
+}
+
+brayns::Vector3f inverse(const brayns::Vector3f& direction)
+{
+    return brayns::Vector3f(1.f / direction.x(), 1.f / direction.y(),
+                            1.f / direction.z());
+}
+}
+
+namespace brayns
+{
+/**
+ * Hierarchy over the primitives of a scene or of an instanced model, in the
+ * space they are expressed in. Nodes are split at the median of the
+ * primitive centers along their largest extent, and primitives only keep a
+ * reference to their geometry, bounds being recomputed when leaves are
+ * visited.
+ */
+class SpatialIndex::Hierarchy
+{
+public:
+    struct Item
+    {
+        uint32_t source;
+        uint32_t index;
+    };
+
+    Hierarchy(SpheresMap& spheres, CylindersMap& cylinders, ConesMap& cones,
+              TrianglesMeshMap& meshes)
+    {
+        for (const auto& materialSpheres : spheres)
+            _sources.push_back({GT_SPHERE, materialSpheres.first,
+                                &materialSpheres.second, nullptr, nullptr,
+                                nullptr, materialSpheres.second.size()});
+        for (const auto& materialCylinders : cylinders)
+            _sources.push_back({GT_CYLINDER, materialCylinders.first, nullptr,
+                                &materialCylinders.second, nullptr, nullptr,
+                                materialCylinders.second.size()});
+        for (const auto& materialCones : cones)
+            _sources.push_back({GT_CONE, materialCones.first, nullptr, nullptr,
+                                &materialCones.second, nullptr,
+                                materialCones.second.size()});
+        for (auto& materialMesh : meshes)
+            _sources.push_back({GT_TRIANGLES_MESH, materialMesh.first, nullptr,
+                                nullptr, nullptr, &materialMesh.second,
+                                materialMesh.second.getIndices().size()});
+
+        size_t nbItems = 0;
+        for (const auto& source : _sources)
+            nbItems += source.size;
+        if (nbItems == 0)
+            return;
+
+        std::vector<BuildItem> buildItems(nbItems);
+        size_t first = 0;
+        for (uint32_t i = 0; i < _sources.size(); ++i)
+        {
+            const auto& source = _sources[i];
+#pragma omp parallel for
+            for (size_t j = 0; j < source.size; ++j)
+            {
+                auto& buildItem = buildItems[first + j];
+                buildItem.item = {i, uint32_t(j)};
+                buildItem.bounds = _getBounds(buildItem.item);
+            }
+            first += source.size;
+        }
+
+        // Leaves hold at least half of the maximum number of primitives, which
+        // bounds the number of nodes
+        _nodes.resize(4 * nbItems / MAX_PRIMITIVES_PER_LEAF + 1);
+        std::atomic<uint32_t> nbNodes(1);
+#pragma omp parallel
+#pragma omp single
+        _build(buildItems, 0, 0, nbItems, nbNodes);
+        _nodes.resize(nbNodes);
+        _nodes.shrink_to_fit();
+
+        _items.reserve(nbItems);
+        for (const auto& buildItem : buildItems)
+            _items.push_back(buildItem.item);
+    }
+
+    /** @return Number of indexed primitives */
+    size_t size() const { return _items.size(); }
+    /**
+     * Finds the closest primitive hit by a ray
+     * @param distance Distance along the ray beyond which primitives are
+     *        ignored, updated with the distance of the primitive found
+     * @param primitive Updated with the primitive found, if any
+     * @return true if a primitive was found
+     */
+    bool intersect(const Vector3f& origin, const Vector3f& direction,
+                   float& distance, IndexedPrimitive& primitive) const
+    {
+        if (_nodes.empty())
+            return false;
+
+        const Vector3f inverseDirection = inverse(direction);
+        std::pair<uint32_t, float> stack[MAX_TRAVERSAL_DEPTH];
+        size_t stackSize = 0;
+        float entry;
+        if (!intersectBounds(_nodes[0].bounds, origin, inverseDirection,
+                             distance, entry))
+            return false;
+        stack[stackSize++] = std::make_pair(0, entry);
+
+        bool found = false;
+        while (stackSize > 0)
+        {
+            const auto visited = stack[--stackSize];
+            if (visited.second >= distance)
+                continue;
+
+            const Node& node = _nodes[visited.first];
+            if (node.count != 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count;
+                     ++i)
+                {
+                    if (_intersect(_items[i], origin, direction, distance,
+                                   distance))
+                    {
+                        describe(_items[i], primitive);
+                        found = true;
+                    }
+                }
+                continue;
+            }
+
+            // Push the farthest child first so that the closest one is
+            // visited first and shortens the ray
+            float entries[2];
+            bool hits[2];
+            for (uint32_t i = 0; i < 2; ++i)
+                hits[i] = intersectBounds(_nodes[node.first + i].bounds,
+                                          origin, inverseDirection, distance,
+                                          entries[i]);
+            const uint32_t farthest =
+                (hits[0] && hits[1] && entries[0] < entries[1]) ? 1 : 0;
+            for (const uint32_t i : {farthest, 1 - farthest})
+                if (hits[i])
+                    stack[stackSize++] =
+                        std::make_pair(node.first + i, entries[i]);
+        }
+        return found;
+    }
+
+    /**
+     * Calls found for every primitive whose bounds intersect the given box,
+     * with the primitive bounds
+     */
+    void query(const Boxf& box,
+               const std::function<void(const Item&, const Boxf&)>& found) const
+    {
+        if (_nodes.empty())
+            return;
+
+        uint32_t stack[MAX_TRAVERSAL_DEPTH];
+        size_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            const Node& node = _nodes[stack[--stackSize]];
+            if (!overlaps(node.bounds, box))
+                continue;
+
+            if (node.count == 0)
+            {
+                stack[stackSize++] = node.first;
+                stack[stackSize++] = node.first + 1;
+                continue;
+            }
+
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                const Boxf bounds = _getBounds(_items[i]);
+                if (overlaps(bounds, box))
+                    found(_items[i], bounds);
+            }
+        }
+    }
+
+    /** Fills the type, material, index and cell section of a primitive */
+    void describe(const Item& item, IndexedPrimitive& primitive) const
+    {
+        const Source& source = _sources[item.source];
+        primitive.type = source.type;
+        primitive.materialId = source.materialId;
+        primitive.index = item.index;
+
+        const Primitive* described = nullptr;
+        switch (source.type)
+        {
+        case GT_SPHERE:
+            described = (*source.spheres)[item.index].get();
+            break;
+        case GT_CYLINDER:
+            described = (*source.cylinders)[item.index].get();
+            break;
+        case GT_CONE:
+            described = (*source.cones)[item.index].get();
+            break;
+        default:
+            break;
+        }
+        primitive.gid = described ? described->getGid() : 0;
+        primitive.sectionId = described ? described->getSectionId() : 0;
+    }
+
+    void addMemoryUsage(MemoryUsage& usage) const
+    {
+        brayns::addMemoryUsage(_sources, usage);
+        brayns::addMemoryUsage(_items, usage);
+        brayns::addMemoryUsage(_nodes, usage);
+    }
+
+private:
+    // Primitives of one type and material
+    struct Source
+    {
+        GeometryType type;
+        size_t materialId;
+        const Spheres* spheres;
+        const Cylinders* cylinders;
+        const Cones* cones;
+        TrianglesMesh* mesh;
+        size_t size;
+    };
+
+    struct BuildItem
+    {
+        Item item;
+        Boxf bounds;
+    };
+
+    // Inner nodes have no primitives, their children being at first and
+    // first + 1
+    struct Node
+    {
+        Boxf bounds;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    void _build(std::vector<BuildItem>& buildItems, const uint32_t nodeIndex,
+                const uint32_t first, const uint32_t count,
+                std::atomic<uint32_t>& nbNodes)
+    {
+        Boxf bounds;
+        Boxf centers;
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            bounds.merge(buildItems[i].bounds);
+            centers.merge(buildItems[i].bounds.getCenter());
+        }
+        _nodes[nodeIndex].bounds = bounds;
+        if (count <= MAX_PRIMITIVES_PER_LEAF)
+        {
+            _nodes[nodeIndex].first = first;
+            _nodes[nodeIndex].count = count;
+            return;
+        }
+
+        const Vector3f extent = centers.getSize();
+        size_t axis = 0;
+        if (extent.y() > extent[axis])
+            axis = 1;
+        if (extent.z() > extent[axis])
+            axis = 2;
+
+        const uint32_t middle = first + count / 2;
+        std::nth_element(buildItems.begin() + first,
+                         buildItems.begin() + middle,
+                         buildItems.begin() + first + count,
+                         [axis](const BuildItem& a, const BuildItem& b) {
+                             return a.bounds.getMin()[axis] +
+                                        a.bounds.getMax()[axis] <
+                                    b.bounds.getMin()[axis] +
+                                        b.bounds.getMax()[axis];
+                         });
+
+        const uint32_t children = nbNodes.fetch_add(2);
+        _nodes[nodeIndex].first = children;
+        _nodes[nodeIndex].count = 0;
+#pragma omp task shared(buildItems, nbNodes) \
+    if (count > MIN_PRIMITIVES_PER_TASK)
+        _build(buildItems, children, first, middle - first, nbNodes);
+        _build(buildItems, children + 1, middle, first + count - middle,
+               nbNodes);
+    }
+
+    Boxf _getBounds(const Item& item) const
+    {
+        const Source& source = _sources[item.source];
+        Boxf bounds;
+        switch (source.type)
+        {
+        case GT_SPHERE:
+        {
+            const Sphere& sphere = *(*source.spheres)[item.index];
+            mergeSphere(bounds, sphere.getCenter(), sphere.getRadius());
+            break;
+        }
+        case GT_CYLINDER:
+        {
+            const Cylinder& cylinder = *(*source.cylinders)[item.index];
+            mergeSphere(bounds, cylinder.getCenter(), cylinder.getRadius());
+            mergeSphere(bounds, cylinder.getUp(), cylinder.getRadius());
+            break;
+        }
+        case GT_CONE:
+        {
+            const Cone& cone = *(*source.cones)[item.index];
+            mergeSphere(bounds, cone.getCenter(), cone.getCenterRadius());
+            mergeSphere(bounds, cone.getUp(), cone.getUpRadius());
+            break;
+        }
+        default:
+        {
+            const Vector3ui& triangle = source.mesh->getIndices()[item.index];
+            const Vector3fs& vertices = source.mesh->getVertices();
+            for (size_t i = 0; i < 3; ++i)
+                bounds.merge(vertices[triangle[i]]);
+        }
+        }
+        return bounds;
+    }
+
+    bool _intersect(const Item& item, const Vector3f& origin,
+                    const Vector3f& direction, const float maxDistance,
+                    float& distance) const
+    {
+        const Source& source = _sources[item.source];
+        switch (source.type)
+        {
+        case GT_SPHERE:
+        {
+            const Sphere& sphere = *(*source.spheres)[item.index];
+            return intersectSphere(sphere.getCenter(), sphere.getRadius(),
+                                   origin, direction, maxDistance, distance);
+        }
+        case GT_CYLINDER:
+        {
+            const Cylinder& cylinder = *(*source.cylinders)[item.index];
+            return intersectCone(cylinder.getCenter(), cylinder.getRadius(),
+                                 cylinder.getUp(), cylinder.getRadius(),
+                                 origin, direction, maxDistance, distance);
+        }
+        case GT_CONE:
+        {
+            const Cone& cone = *(*source.cones)[item.index];
+            return intersectCone(cone.getCenter(), cone.getCenterRadius(),
+                                 cone.getUp(), cone.getUpRadius(), origin,
+                                 direction, maxDistance, distance);
+        }
+        default:
+        {
+            const Vector3ui& triangle = source.mesh->getIndices()[item.index];
+            const Vector3fs& vertices = source.mesh->getVertices();
+            return intersectTriangle(vertices[triangle[0]],
+                                     vertices[triangle[1]],
+                                     vertices[triangle[2]], origin, direction,
+                                     maxDistance, distance);
+        }
+        }
+    }
+
+    std::vector<Source> _sources;
+    std::vector<Item> _items;
+    std::vector<Node> _nodes;
+};
+
+SpatialIndex::SpatialIndex(Scene& scene)
+    : _scene(scene)
+{
+}
+
+SpatialIndex::~SpatialIndex()
+{
+}
+
+void SpatialIndex::invalidate()
+{
+    _sceneHierarchy.reset();
+}
+
+bool SpatialIndex::intersect(const Vector3f& origin, const Vector3f& direction,
+                             IndexedPrimitive& primitive)
+{
+    _update();
+
+    float distance = std::numeric_limits<float>::max();
+    bool found = false;
+    if (_sceneHierarchy->intersect(origin, direction, distance, primitive))
+    {
+        primitive.model.clear();
+        primitive.instance = 0;
+        found = true;
+    }
+
+    const Vector3f inverseDirection = inverse(direction);
+    for (const auto& modelHierarchy : _modelHierarchies)
+    {
+        const auto& model = modelHierarchy.second;
+        for (size_t i = 0; i < model.inverseInstances.size(); ++i)
+        {
+            float entry;
+            if (!intersectBounds(model.instanceBounds[i], origin,
+                                 inverseDirection, distance, entry))
+                continue;
+
+            // Distances along the ray are preserved by the transformation
+            const Matrix4f& toModel = model.inverseInstances[i];
+            if (model.hierarchy->intersect(
+                    transformPoint(toModel, origin),
+                    transformDirection(toModel, direction), distance,
+                    primitive))
+            {
+                primitive.model = modelHierarchy.first;
+                primitive.instance = i;
+                found = true;
+            }
+        }
+    }
+
+    if (!found)
+        return false;
+    primitive.position = origin + direction * distance;
+    primitive.distance = distance * direction.length();
+    return true;
+}
+
+size_t SpatialIndex::queryBox(const Boxf& box, const size_t maxPrimitives,
+                              IndexedPrimitives& primitives)
+{
+    const RegionTest intersectsBox = [&box](const Boxf& bounds) {
+        return overlaps(bounds, box);
+    };
+    return _query(box, intersectsBox, maxPrimitives, primitives);
+}
+
+size_t SpatialIndex::querySphere(const Vector3f& center, const float radius,
+                                 const size_t maxPrimitives,
+                                 IndexedPrimitives& primitives)
+{
+    Boxf region;
+    mergeSphere(region, center, radius);
+    const RegionTest intersectsSphere = [&center, radius](const Boxf& bounds) {
+        // Distance from the center to the closest point of the bounds
+        float squaredDistance = 0.f;
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const float closest =
+                std::max(bounds.getMin()[axis],
+                         std::min(center[axis], bounds.getMax()[axis]));
+            const float delta = center[axis] - closest;
+            squaredDistance += delta * delta;
+        }
+        return squaredDistance <= radius * radius;
+    };
+    return _query(region, intersectsSphere, maxPrimitives, primitives);
+}
+
+MemoryUsage SpatialIndex::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    if (_sceneHierarchy)
+        _sceneHierarchy->addMemoryUsage(usage);
+    for (const auto& modelHierarchy : _modelHierarchies)
+    {
+        const auto& model = modelHierarchy.second;
+        model.hierarchy->addMemoryUsage(usage);
+        addMemoryUsage(model.inverseInstances, usage);
+        addMemoryUsage(model.instanceBounds, usage);
+    }
+    return usage;
+}
+
+void SpatialIndex::_update()
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    size_t nbIndexedPrimitives = 0;
+
+    if (!_sceneHierarchy)
+    {
+        _sceneHierarchy.reset(new Hierarchy(_scene.getSpheres(),
+                                            _scene.getCylinders(),
+                                            _scene.getCones(),
+                                            _scene.getTriangleMeshes()));
+        nbIndexedPrimitives += _sceneHierarchy->size();
+    }
+
+    // Models are replaced rather than modified, so only the removed and
+    // replaced ones need their hierarchy to be dropped
+    auto& models = _scene.getInstancedModels();
+    for (auto i = _modelHierarchies.begin(); i != _modelHierarchies.end();)
+    {
+        const auto model = models.find(i->first);
+        if (model == models.end() || model->second != i->second.model.lock())
+            i = _modelHierarchies.erase(i);
+        else
+            ++i;
+    }
+
+    for (const auto& model : models)
+    {
+        auto& modelHierarchy = _modelHierarchies[model.first];
+        if (!modelHierarchy.hierarchy)
+        {
+            modelHierarchy.model = model.second;
+            modelHierarchy.hierarchy.reset(
+                new Hierarchy(model.second->getSpheres(),
+                              model.second->getCylinders(),
+                              model.second->getCones(),
+                              model.second->getTriangleMeshes()));
+            nbIndexedPrimitives += modelHierarchy.hierarchy->size();
+        }
+
+        // Instances can be added once the model is indexed
+        const auto& instances = model.second->getInstances();
+        for (size_t i = modelHierarchy.inverseInstances.size();
+             i < instances.size(); ++i)
+        {
+            Matrix4f toModel;
+            instances[i].inverse(toModel);
+            modelHierarchy.inverseInstances.push_back(toModel);
+            modelHierarchy.instanceBounds.push_back(
+                model.second->getInstanceBounds(i));
+        }
+    }
+
+    if (nbIndexedPrimitives == 0)
+        return;
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::high_resolution_clock::now() - start;
+    BRAYNS_INFO << "Indexed " << nbIndexedPrimitives << " primitives in "
+                << elapsed.count() << " ms" << std::endl;
+}
+
+size_t SpatialIndex::_query(const Boxf& region, const RegionTest& intersects,
+                            const size_t maxPrimitives,
+                            IndexedPrimitives& primitives)
+{
+    _update();
+
+    primitives.clear();
+    size_t nbPrimitives = 0;
+    const auto add = [&](const Hierarchy& hierarchy,
+                         const Hierarchy::Item& item, const Boxf& bounds,
+                         const std::string& model, const size_t instance) {
+        if (!intersects(bounds))
+            return;
+        if (nbPrimitives++ >= maxPrimitives)
+            return;
+        IndexedPrimitive primitive;
+        hierarchy.describe(item, primitive);
+        primitive.model = model;
+        primitive.instance = instance;
+        primitive.position = bounds.getCenter();
+        primitives.push_back(primitive);
+    };
+
+    _sceneHierarchy->query(region, [&](const Hierarchy::Item& item,
+                                       const Boxf& bounds) {
+        add(*_sceneHierarchy, item, bounds, std::string(), 0);
+    });
+
+    for (const auto& modelHierarchy : _modelHierarchies)
+    {
+        const auto& model = modelHierarchy.second;
+        const auto& instances = model.model.lock()->getInstances();
+        for (size_t i = 0; i < model.inverseInstances.size(); ++i)
+        {
+            if (!overlaps(model.instanceBounds[i], region))
+                continue;
+
+            const Matrix4f& toWorld = instances[i];
+            model.hierarchy->query(
+                transformBounds(model.inverseInstances[i], region),
+                [&](const Hierarchy::Item& item, const Boxf& bounds) {
+                    add(*model.hierarchy, item,
+                        transformBounds(toWorld, bounds),
+                        modelHierarchy.first, i);
+                });
+        }
+    }
+    return nbPrimitives;
+}
+}
@@ -0,0 +1,148 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <brayns/api.h>
+#include <brayns/common/geometry/Geometry.h>
+#include <brayns/common/types.h>
+#include <brayns/common/utils/MemoryRegistry.h>
+
+#include <functional>
+
+namespace brayns
+{
+/** Primitive found by a query on the spatial index */
+struct IndexedPrimitive
+{
+    /** Instanced model holding the primitive, empty for the scene geometry */
+    std::string model;
+    /** Instance of the model the primitive was found in */
+    size_t instance = 0;
+    GeometryType type = GT_UNDEFINED;
+    size_t materialId = 0;
+    /**
+     * Index of the primitive amongst those of its material, or of the
+     * triangle in the mesh of its material
+     */
+    size_t index = 0;
+    /** GID of the cell the primitive belongs to, 0 if none */
+    uint32_t gid = 0;
+    /** Section of the cell the primitive belongs to */
+    uint32_t sectionId = 0;
+    /**
+     * Point hit by the picking ray, or center of the primitive bounds for
+     * region queries, in world space
+     */
+    Vector3f position;
+    /** Distance from the origin of the picking ray, 0 for region queries */
+    float distance = 0.f;
+};
+typedef std::vector<IndexedPrimitive> IndexedPrimitives;
+
+/**
+ * Bounding volume hierarchies over the spheres, cylinders, cones and
+ * triangles of a scene, used to find the primitive under a pixel or the
+ * primitives in a region of space without going through the rendering
+ * engine.
+ *
+ * The scene geometry and every instanced model get their own hierarchy,
+ * built by the first query that needs it. Instanced models are never
+ * modified, so their hierarchy is kept as long as the scene holds the same
+ * model, while the one of the scene geometry is dropped whenever the scene
+ * geometry changes.
+ */
+class SpatialIndex
+{
+public:
+    BRAYNS_API explicit SpatialIndex(Scene& scene);
+    BRAYNS_API ~SpatialIndex();
+
+    /**
+     * Drops the hierarchy of the scene geometry, so that it is rebuilt by the
+     * next query
+     */
+    BRAYNS_API void invalidate();
+
+    /**
+     * Finds the closest primitive hit by a ray
+     * @param origin Origin of the ray, in world space
+     * @param direction Direction of the ray, in world space
+     * @param primitive Closest primitive hit by the ray
+     * @return true if the ray hits a primitive, false otherwise
+     */
+    BRAYNS_API bool intersect(const Vector3f& origin,
+                              const Vector3f& direction,
+                              IndexedPrimitive& primitive);
+
+    /**
+     * Finds the primitives whose bounds intersect a box
+     * @param box Box in world space
+     * @param maxPrimitives Maximum number of primitives to return
+     * @param primitives Primitives found, up to maxPrimitives
+     * @return Number of primitives in the box, which can exceed maxPrimitives
+     */
+    BRAYNS_API size_t queryBox(const Boxf& box, size_t maxPrimitives,
+                               IndexedPrimitives& primitives);
+
+    /**
+     * Finds the primitives whose bounds intersect a sphere
+     * @param center Center of the sphere in world space
+     * @param radius Radius of the sphere
+     * @param maxPrimitives Maximum number of primitives to return
+     * @param primitives Primitives found, up to maxPrimitives
+     * @return Number of primitives in the sphere, which can exceed
+     *         maxPrimitives
+     */
+    BRAYNS_API size_t querySphere(const Vector3f& center, float radius,
+                                  size_t maxPrimitives,
+                                  IndexedPrimitives& primitives);
+
+    /** @return Memory held by the hierarchies */
+    BRAYNS_API MemoryUsage getMemoryUsage() const;
+
+private:
+    class Hierarchy;
+    typedef std::shared_ptr<Hierarchy> HierarchyPtr;
+
+    // Models are not held, so that the geometry of removed models is freed
+    // without waiting for the next query
+    struct ModelHierarchy
+    {
+        std::weak_ptr<InstancedModel> model;
+        HierarchyPtr hierarchy;
+        Matrix4fs inverseInstances;
+        std::vector<Boxf> instanceBounds;
+    };
+
+    // Tells whether world space bounds intersect the queried region
+    typedef std::function<bool(const Boxf&)> RegionTest;
+
+    void _update();
+    size_t _query(const Boxf& region, const RegionTest& intersects,
+                  size_t maxPrimitives, IndexedPrimitives& primitives);
+
+    Scene& _scene;
+    HierarchyPtr _sceneHierarchy;
+    std::map<std::string, ModelHierarchy> _modelHierarchies;
+};
+}
+#endif // SPATIALINDEX_H
@@ -21,6 +21,7 @@
 #include "AbstractSimulationHandler.h"
 
 #include <brayns/common/log.h>
+#include <brayns/common/utils/MemoryRegistry.h>
 #include <brayns/parameters/GeometryParameters.h>
 
 #include <fcntl.h>
@@ -56,6 +57,18 @@ AbstractSimulationHandler::~AbstractSimulationHandler()
         ::close(_cacheFileDescriptor);
 }
 
+MemoryUsage AbstractSimulationHandler::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    if (_memoryMapPtr)
+    {
+        usage.reserved = _headerSize + _frameSize * _nbFrames * sizeof(float);
+        usage.resident =
+            MemoryRegistry::getResidentSize(_memoryMapPtr, usage.reserved);
+    }
+    return usage;
+}
+
 void AbstractSimulationHandler::setTimestamp(const float timestamp)
 {
     _timestamp = size_t(timestamp) % _nbFrames;
@@ -127,8 +140,7 @@ const Histogram& AbstractSimulationHandler::getHistogram()
                    -std::numeric_limits<float>::max());
     for (size_t i = 0; i < _frameSize; ++i)
     {
-        const uint64_t index = i * sizeof(float);
-        float value = data[index];
+        float value = data[i];
         range.x() = std::min(range.x(), value);
         range.y() = std::max(range.y(), value);
     }
@@ -138,12 +150,12 @@ const Histogram& AbstractSimulationHandler::getHistogram()
     _histogram.values.clear();
     _histogram.values.resize(histogramSize, 0);
     const float normalizationValue =
-        (range.y() - range.x()) / float((histogramSize + 1));
+        std::max(range.y() - range.x(), std::numeric_limits<float>::min()) /
+        float(histogramSize);
     for (size_t i = 0; i < _frameSize; ++i)
     {
-        const uint64_t index = i * sizeof(float);
-        const size_t idx = (data[index] - range.x()) / normalizationValue;
-        ++_histogram.values[idx];
+        const size_t idx = (data[i] - range.x()) / normalizationValue;
+        ++_histogram.values[std::min(idx, histogramSize - 1)];
     }
 
     // Build histogram
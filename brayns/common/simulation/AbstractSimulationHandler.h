@@ -53,7 +53,8 @@ public:
     * @param cacheFile File containing the simulation values
     * @return True if the file was successfully attached, false otherwise
     */
-    BRAYNS_API bool attachSimulationToCacheFile(const std::string& cacheFile);
+    BRAYNS_API virtual bool attachSimulationToCacheFile(
+        const std::string& cacheFile);
 
     /**
     * @brief Writes the header to a stream. The header contains the number of
@@ -76,6 +77,11 @@ public:
      */
     void setTimestamp(const float timestamp);
 
+    /**
+     * @brief getTimestamp returns the frame of the current timestamp
+     */
+    float getTimestamp() const { return _timestamp; }
+
     /**
      * @brief getFrameData returns a void pointer to the simulation data for the
      * current timestamp
@@ -128,6 +134,9 @@ public:
     /** @return true if the histogram has changed since the last update. */
     bool histogramChanged() const;
 
+    /** @return the memory mapped by the simulation cache file */
+    virtual MemoryUsage getMemoryUsage() const;
+
 protected:
     const GeometryParameters& _geometryParameters;
     float _timestamp;
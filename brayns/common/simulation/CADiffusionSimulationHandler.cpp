@@ -25,66 +25,215 @@
 #include <brayns/common/utils/Utils.h>
 #include <brayns/parameters/GeometryParameters.h>
 
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
+#include <functional>
+#include <sstream>
 
 namespace
 {
 const float CALCIUM_RADIUS = 0.00194f;
+
+const std::string CACHE_FILENAME = "calcium_positions.cache";
+const uint64_t CACHE_MAGIC = 0xca1c1u;
+const uint64_t CACHE_VERSION = 1;
+// Magic, version and number of frames
+const uint64_t CACHE_HEADER_SIZE = 3 * sizeof(uint64_t);
+
+const size_t FRAMES_PER_CONVERSION_BATCH = 32;
+const size_t PREFETCHED_FRAMES = 4;
+
+/**
+ * Reads the "index x y z" lines of a frame file. Lines that do not contain
+ * four values are ignored.
+ */
+bool readPositions(const std::string& filename, brayns::Vector3fs& positions)
+{
+    std::ifstream file(filename, std::ios::in);
+    if (!file.good())
+        return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string content = buffer.str();
+
+    const char* line = content.c_str();
+    const char* contentEnd = line + content.size();
+    while (line < contentEnd)
+    {
+        const char* lineEnd = std::find(line, contentEnd, '\n');
+        char* end = nullptr;
+        std::strtoull(line, &end, 10);
+        bool valid = end != line && end <= lineEnd;
+        float values[3];
+        for (size_t i = 0; valid && i < 3; ++i)
+        {
+            const char* begin = end;
+            values[i] = std::strtof(begin, &end);
+            valid = end != begin && end <= lineEnd;
+        }
+        if (valid)
+            positions.push_back(
+                brayns::Vector3f(values[0], values[1], values[2]));
+        line = lineEnd + 1;
+    }
+    return true;
+}
 }
 
 namespace brayns
 {
 CADiffusionSimulationHandler::CADiffusionSimulationHandler(
     const std::string& simulationFolder)
-    : _currentFrame(std::numeric_limits<size_t>::max())
+    : _frameOffsets(nullptr)
+    , _positions(nullptr)
+    , _currentFrame(std::numeric_limits<size_t>::max())
     , _spheresCreated(false)
 {
     BRAYNS_DEBUG << "Loading Calcium simulation from " << simulationFolder
                  << std::endl;
     const strings filters = {".dat"};
-    strings files = parseFolder(simulationFolder, filters);
-    for (size_t i = 0; i < files.size(); ++i)
+    _simulationFiles = parseFolder(simulationFolder, filters);
+    if (_simulationFiles.empty())
+        return;
+
+    // The cache lives next to the simulation, or in the temporary folder if
+    // the simulation folder is read-only
+    namespace fs = boost::filesystem;
+    const std::string cacheFile =
+        (fs::path(simulationFolder) / CACHE_FILENAME).string();
+    const std::string tmpCacheFile =
+        (fs::temp_directory_path() /
+         (std::to_string(std::hash<std::string>()(
+              fs::absolute(simulationFolder).string())) +
+          "_" + CACHE_FILENAME))
+            .string();
+
+    for (const auto& file : {cacheFile, tmpCacheFile})
+        if (_attachCache(file) || (_createCache(file) && _attachCache(file)))
+            return;
+    BRAYNS_ERROR << "Failed to create Calcium positions cache for "
+                 << simulationFolder << std::endl;
+}
+
+bool CADiffusionSimulationHandler::_attachCache(const std::string& cacheFile)
+{
+    namespace fs = boost::filesystem;
+    boost::system::error_code error;
+    if (!fs::exists(cacheFile, error))
+        return false;
+
+    // The cache must be more recent than all frames
+    const auto cacheTime = fs::last_write_time(cacheFile, error);
+    for (const auto& file : _simulationFiles)
+        if (fs::last_write_time(file, error) > cacheTime)
+            return false;
+
+    if (!_cache.map(cacheFile, false))
+        return false;
+
+    const uint64_t nbFrames = _simulationFiles.size();
+    const uint64_t offsetsSize = (nbFrames + 1) * sizeof(uint64_t);
+    const uint64_t* header =
+        reinterpret_cast<const uint64_t*>(_cache.getData());
+    if (_cache.getSize() >= CACHE_HEADER_SIZE + offsetsSize &&
+        header[0] == CACHE_MAGIC && header[1] == CACHE_VERSION &&
+        header[2] == nbFrames)
     {
-        BRAYNS_DEBUG << "CA diffusion: " << files[i] << std::endl;
-        _simulationFiles[i] = files[i];
+        const uint64_t* offsets = header + 3;
+        if (_cache.getSize() == CACHE_HEADER_SIZE + offsetsSize +
+                                    offsets[nbFrames] * sizeof(Vector3f))
+        {
+            _frameOffsets = offsets;
+            _positions = reinterpret_cast<const Vector3f*>(
+                _cache.getData() + CACHE_HEADER_SIZE + offsetsSize);
+            BRAYNS_INFO << "Attached Calcium positions cache " << cacheFile
+                        << std::endl;
+            return true;
+        }
     }
+    _cache.unmap();
+    return false;
 }
 
-bool CADiffusionSimulationHandler::_loadCalciumPositions(const size_t frame)
+bool CADiffusionSimulationHandler::_createCache(
+    const std::string& cacheFile) const
 {
-    if (_simulationFiles.find(frame) == _simulationFiles.end())
-    {
-        BRAYNS_ERROR << "No simulation file for frame " << frame << std::endl;
+    // Other instances may be mapping an existing cache, which is therefore
+    // only replaced once the new one is complete
+    AtomicFileWriter writer(cacheFile);
+    std::ofstream& file = writer.getStream();
+    if (!file.is_open())
         return false;
-    }
 
-    BRAYNS_DEBUG << "Loading Calcium positions for frame " << frame
-                 << ", filename: " << _simulationFiles[frame] << std::endl;
+    BRAYNS_INFO << "Converting " << _simulationFiles.size()
+                << " Calcium frames to " << cacheFile << std::endl;
+
+    // Offsets are written once all frames are known
+    const uint64_t nbFrames = _simulationFiles.size();
+    uint64_ts offsets(nbFrames + 1, 0);
+    const uint64_t header[] = {CACHE_MAGIC, CACHE_VERSION, nbFrames};
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)offsets.data(), offsets.size() * sizeof(uint64_t));
 
-    // Load Calcium positions
-    std::ifstream filePositions(_simulationFiles[frame], std::ios::in);
-    if (!filePositions.good())
+    // Frames are parsed in parallel batches, and written in order
+    for (size_t first = 0; first < nbFrames;
+         first += FRAMES_PER_CONVERSION_BATCH)
     {
-        BRAYNS_ERROR << "Could not open file " << _simulationFiles[frame]
-                     << std::endl;
-        return false;
+        BRAYNS_PROGRESS(first, nbFrames);
+        const size_t batchSize =
+            std::min(FRAMES_PER_CONVERSION_BATCH, nbFrames - first);
+        std::vector<Vector3fs> positions(batchSize);
+        std::vector<char> valid(batchSize);
+#pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < batchSize; ++i)
+            valid[i] = readPositions(_simulationFiles[first + i], positions[i]);
+
+        for (size_t i = 0; i < batchSize; ++i)
+        {
+            if (!valid[i])
+            {
+                BRAYNS_ERROR << "Could not open file "
+                             << _simulationFiles[first + i] << std::endl;
+                return false;
+            }
+            file.write((const char*)positions[i].data(),
+                       positions[i].size() * sizeof(Vector3f));
+            offsets[first + i + 1] = offsets[first + i] + positions[i].size();
+        }
     }
 
-    _calciumPositions.clear();
-    std::string line;
-    while (filePositions.good() && std::getline(filePositions, line))
-    {
-        std::stringstream lineStream(line);
-        size_t id;
-        Vector3f position;
-        lineStream >> id >> position.x() >> position.y() >> position.z();
+    file.seekp(sizeof(header));
+    file.write((const char*)offsets.data(), offsets.size() * sizeof(uint64_t));
+    return file.good() && writer.commit();
+}
 
-        _calciumPositions.push_back(position);
+const Vector3f* CADiffusionSimulationHandler::_getPositions(
+    const size_t frame, size_t& nbPositions) const
+{
+    if (!_positions || frame >= _simulationFiles.size())
+    {
+        BRAYNS_ERROR << "No simulation file for frame " << frame << std::endl;
+        return nullptr;
     }
-    filePositions.close();
-    BRAYNS_DEBUG << _calciumPositions.size() << " Calcium positions loaded"
-                 << std::endl;
-    return true;
+    nbPositions = _frameOffsets[frame + 1] - _frameOffsets[frame];
+    return _positions + _frameOffsets[frame];
+}
+
+void CADiffusionSimulationHandler::_prefetch(const size_t frame) const
+{
+    const size_t endFrame =
+        std::min(frame + PREFETCHED_FRAMES, _simulationFiles.size());
+    if (!_positions || frame >= endFrame)
+        return;
+
+    const uint64_t offset =
+        reinterpret_cast<const char*>(_positions + _frameOffsets[frame]) -
+        _cache.getData();
+    _cache.prefetch(offset, (_frameOffsets[endFrame] - _frameOffsets[frame]) *
+                                sizeof(Vector3f));
 }
 
 void CADiffusionSimulationHandler::setFrame(Scene& scene, const size_t frame)
@@ -93,36 +242,42 @@ void CADiffusionSimulationHandler::setFrame(Scene& scene, const size_t frame)
     if (frame == _currentFrame)
         return;
 
+    size_t nbPositions = 0;
+    const Vector3f* positions = _getPositions(frame, nbPositions);
+    if (!positions)
+        return;
     _currentFrame = frame;
 
-    // Load Calcium positions
-    _loadCalciumPositions(frame);
     if (!_spheresCreated)
     {
-        BRAYNS_INFO << "Creating " << _calciumPositions.size() << " CA spheres"
-                    << std::endl;
-        for (const auto position : _calciumPositions)
+        BRAYNS_INFO << "Creating " << nbPositions << " CA spheres" << std::endl;
+        Spheres spheres;
+        spheres.reserve(nbPositions);
+        Boxf bounds;
+        for (size_t i = 0; i < nbPositions; ++i)
         {
-            SpherePtr sphere(new Sphere(MATERIAL_CA_SIMULATION, position,
-                                        CALCIUM_RADIUS, 0.f, 0.f));
-            scene.getSpheres()[MATERIAL_CA_SIMULATION].push_back(sphere);
-            scene.getWorldBounds().merge(position);
+            spheres.push_back(std::make_shared<Sphere>(
+                MATERIAL_CA_SIMULATION, positions[i], CALCIUM_RADIUS, 0.f,
+                0.f));
+            bounds.merge(positions[i]);
         }
+        scene.addSpheres(MATERIAL_CA_SIMULATION, std::move(spheres), bounds);
         _spheresCreated = true;
     }
     else
     {
-        uint64_t i = 0;
-        for (const auto position : _calciumPositions)
+        const size_t nbSpheres =
+            scene.getSpheres()[MATERIAL_CA_SIMULATION].size();
+        if (nbPositions > nbSpheres)
         {
-            auto& spheres = scene.getSpheres()[MATERIAL_CA_SIMULATION];
-            if (i < spheres.size())
-                spheres[i]->setCenter(position);
-            else
-                BRAYNS_WARN << "Invalid number of positions in "
-                            << _simulationFiles[frame] << std::endl;
-            ++i;
+            BRAYNS_WARN << "Invalid number of positions in "
+                        << _simulationFiles[frame] << std::endl;
+            nbPositions = nbSpheres;
         }
+        scene.setSphereCenters(MATERIAL_CA_SIMULATION, positions,
+                               nbPositions);
     }
+
+    _prefetch(frame + 1);
 }
 }
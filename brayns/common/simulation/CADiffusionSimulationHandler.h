@@ -23,6 +23,7 @@
 
 #include <brayns/api.h>
 #include <brayns/common/types.h>
+#include <brayns/common/utils/MemoryMappedFile.h>
 
 namespace brayns
 {
@@ -30,8 +31,11 @@ namespace brayns
  * @brief The CADiffusionSimulationHandler class handles simulation frames for
  *        Calcium diffusion. Frames are stored in ASCII files containing
  *        coordinates for CA atoms. Each frame is in a different file. The
- *        format of the frame is X Y Z values stored as text. For example:
- *        215.388692 996.594668 338.199478
+ *        format of the frame is an index followed by X Y Z values stored as
+ *        text. For example:
+ *        1 215.388692 996.594668 338.199478
+ *        The first time a simulation folder is opened, all frames are
+ *        converted into a binary cache file that is then memory mapped.
  */
 class CADiffusionSimulationHandler
 {
@@ -46,8 +50,9 @@ public:
     /**
      * @brief setFrame Sets the frame to load
      * @param scene Scene to be populated with spheres. When setFrame is called
-     *              for the first time, spheres are created. Otherwise, sphere
-     *              positions are updated with the new values
+     *              for the first time, spheres are created. Otherwise, only
+     *              sphere centers are updated with the new values. The
+     *              following frames are then prefetched in the background.
      * @param frame Frame to load
      */
     void setFrame(Scene& scene, const size_t frame);
@@ -57,10 +62,15 @@ public:
      */
     uint64_t getNbFrames() const { return _simulationFiles.size(); }
 private:
-    bool _loadCalciumPositions(const size_t frame);
+    bool _attachCache(const std::string& cacheFile);
+    bool _createCache(const std::string& cacheFile) const;
+    const Vector3f* _getPositions(size_t frame, size_t& nbPositions) const;
+    void _prefetch(size_t frame) const;
 
-    std::map<size_t, std::string> _simulationFiles;
-    Vector3fs _calciumPositions;
+    strings _simulationFiles;
+    MemoryMappedFile _cache;
+    const uint64_t* _frameOffsets;
+    const Vector3f* _positions;
     size_t _currentFrame;
     bool _spheresCreated;
 };
@@ -21,26 +21,168 @@
 #include "SpikeSimulationHandler.h"
 
 #include <brayns/common/log.h>
+#include <brayns/common/utils/MemoryRegistry.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+// Frames after which a spike is not visible anymore
+const uint64_t SPIKE_DECAY_FRAMES =
+    std::ceil(1.f / brayns::SPIKE_DECAY_PER_FRAME);
+}
 
 namespace brayns
 {
 SpikeSimulationHandler::SpikeSimulationHandler(
     const GeometryParameters& geometryParameters)
     : AbstractSimulationHandler(geometryParameters)
+    , _frameOffsets(nullptr)
+    , _spikes(nullptr)
+    , _currentDataFrame(-1)
+{
+}
+
+bool SpikeSimulationHandler::attachSimulationToCacheFile(
+    const std::string& cacheFile)
+{
+    BRAYNS_INFO << "Attaching " << cacheFile << " to current scene"
+                << std::endl;
+    if (!_cache.map(cacheFile, false))
+        return false;
+
+    // Header, then spike count, frame offsets and spikes
+    const uint64_t* header =
+        reinterpret_cast<const uint64_t*>(_cache.getData());
+    const uint64_t headerSize = 3 * sizeof(uint64_t);
+    if (_cache.getSize() >= headerSize)
+    {
+        _nbFrames = header[0];
+        _frameSize = header[1];
+        const uint64_t nbSpikes = header[2];
+        const uint64_t offsetsSize = (_nbFrames + 1) * sizeof(uint64_t);
+        if (_nbFrames > 0 &&
+            _cache.getSize() ==
+                headerSize + offsetsSize + nbSpikes * sizeof(SpikeEvent))
+        {
+            _frameOffsets = header + 3;
+            _spikes = reinterpret_cast<const SpikeEvent*>(
+                _cache.getData() + headerSize + offsetsSize);
+            _frameData.assign(_frameSize, -1.f);
+            _currentDataFrame = -1;
+
+            BRAYNS_INFO << "Nb Frames : " << _nbFrames << std::endl;
+            BRAYNS_INFO << "Frame size: " << _frameSize << std::endl;
+            BRAYNS_INFO << "Nb spikes : " << nbSpikes << std::endl;
+            return true;
+        }
+    }
+
+    BRAYNS_ERROR << cacheFile << " is not a valid spike cache file"
+                 << std::endl;
+    _cache.unmap();
+    _nbFrames = 0;
+    _frameSize = 0;
+    return false;
+}
+
+bool SpikeSimulationHandler::writeCacheFile(const std::string& cacheFile,
+                                            const SpikeEvents& spikes)
 {
+    std::ofstream file(cacheFile, std::ios::out | std::ios::binary);
+    if (!file.is_open())
+    {
+        BRAYNS_ERROR << "Failed to create cache file " << cacheFile
+                     << std::endl;
+        return false;
+    }
+
+    // Index of the first spike of every frame, and end of the spikes
+    uint64_ts frameOffsets(_nbFrames + 1);
+    for (uint64_t frame = 0; frame <= _nbFrames; ++frame)
+        frameOffsets[frame] =
+            std::lower_bound(spikes.begin(), spikes.end(), float(frame),
+                             [](const SpikeEvent& spike, const float value) {
+                                 return spike.frame < value;
+                             }) -
+            spikes.begin();
+    // Spikes beyond the last frame are not stored
+    const uint64_t nbSpikes = frameOffsets[_nbFrames];
+
+    writeHeader(file);
+    file.write((const char*)&nbSpikes, sizeof(uint64_t));
+    file.write((const char*)frameOffsets.data(),
+               frameOffsets.size() * sizeof(uint64_t));
+    file.write((const char*)spikes.data(), nbSpikes * sizeof(SpikeEvent));
+    return file.good();
 }
 
 void* SpikeSimulationHandler::getFrameData()
 {
-    if (_nbFrames == 0 || _memoryMapPtr == 0)
+    if (_nbFrames == 0 || !_spikes)
         return 0;
 
-    const uint64_t frame = _timestamp;
-    const uint64_t moduloFrame = frame % _nbFrames;
-    const uint64_t index =
-        std::min(_frameSize, std::max(uint64_t(0), moduloFrame));
+    const int64_t frame = uint64_t(_timestamp) % _nbFrames;
+    if (frame == _currentDataFrame)
+        return _frameData.data();
+
+    const int64_t lastVisibleFrame = frame - int64_t(SPIKE_DECAY_FRAMES);
+    if (_currentDataFrame >= 0 && frame > _currentDataFrame &&
+        _currentDataFrame >= lastVisibleFrame)
+    {
+        // Playing forward: only forget the spikes that are not visible
+        // anymore and apply the spikes of the new frames
+        const int64_t previousLastVisibleFrame =
+            _currentDataFrame - int64_t(SPIKE_DECAY_FRAMES);
+        if (lastVisibleFrame > 0)
+            _expireSpikes(std::max(previousLastVisibleFrame, int64_t(0)),
+                          lastVisibleFrame);
+        _applySpikes(_currentDataFrame + 1, frame + 1);
+    }
+    else
+    {
+        // Rebuild from the spikes that are still visible
+        std::fill(_frameData.begin(), _frameData.end(), -1.f);
+        _applySpikes(std::max(lastVisibleFrame, int64_t(0)), frame + 1);
+    }
+    _currentDataFrame = frame;
+    return _frameData.data();
+}
+
+void SpikeSimulationHandler::_applySpikes(const uint64_t firstFrame,
+                                          const uint64_t endFrame)
+{
+    const uint64_t end = _frameOffsets[endFrame];
+    for (uint64_t i = _frameOffsets[firstFrame]; i < end; ++i)
+    {
+        const auto& spike = _spikes[i];
+        if (spike.gid < _frameSize)
+            _frameData[spike.gid] = spike.frame;
+    }
+}
+
+void SpikeSimulationHandler::_expireSpikes(const uint64_t firstFrame,
+                                           const uint64_t endFrame)
+{
+    // Neurons that spiked again keep their last spike
+    const uint64_t end = _frameOffsets[endFrame];
+    for (uint64_t i = _frameOffsets[firstFrame]; i < end; ++i)
+    {
+        const auto& spike = _spikes[i];
+        if (spike.gid < _frameSize && _frameData[spike.gid] == spike.frame)
+            _frameData[spike.gid] = -1.f;
+    }
+}
 
-    return (unsigned char*)_memoryMapPtr + _headerSize +
-           index * _frameSize * sizeof(float);
+MemoryUsage SpikeSimulationHandler::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.reserved = _cache.getSize();
+    usage.resident =
+        MemoryRegistry::getResidentSize(_cache.getData(), _cache.getSize());
+    addMemoryUsage(_frameData, usage);
+    return usage;
 }
 }
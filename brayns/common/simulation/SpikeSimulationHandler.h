@@ -25,17 +25,38 @@
 #include <brayns/common/scene/Scene.h>
 #include <brayns/common/simulation/AbstractSimulationHandler.h>
 #include <brayns/common/types.h>
+#include <brayns/common/utils/MemoryMappedFile.h>
 
 namespace brayns
 {
+/** Spike of a neuron. The time is expressed in frames. */
+struct SpikeEvent
+{
+    float frame;
+    uint32_t gid;
+};
+typedef std::vector<SpikeEvent> SpikeEvents;
+
+/**
+ * Value lost per frame by a spike, as applied by the particle renderer
+ * (NEST_TIMESTEP in ParticleRenderer.ispc). Spikes older than 1 / decay
+ * frames are not visible anymore.
+ */
+const float SPIKE_DECAY_PER_FRAME = 0.1f;
+
 /**
  * @brief The SpikeSimulationHandler class handles simulation frames for the
  * current circuit.
- *        Frames are stored in a memory mapped file that is accessed according
- * to a specified
- *        timestamp. The SpikeSimulationHandler class is in charge of keeping
- * the handle to the
- *        memory mapped file.
+ *        Spikes are stored as sparse events sorted by time in a memory mapped
+ * cache file, with the index of the first spike of every frame. The frame
+ * buffer holds, for every neuron, the frame of its last visible spike, or -1.
+ * It is derived from the events when the timestamp changes, incrementally from
+ * the previous frame when playing forward, so that the work per frame scales
+ * with the number of spikes rather than with the number of neurons.
+ *
+ * The cache file contains the header of the AbstractSimulationHandler (number
+ * of frames and number of neurons), followed by the number of spikes, the
+ * nbFrames + 1 spike offsets of the frames and the SpikeEvent array.
  */
 class SpikeSimulationHandler : public AbstractSimulationHandler
 {
@@ -46,11 +67,38 @@ public:
      */
     SpikeSimulationHandler(const GeometryParameters& geometryParameters);
 
+    /** @copydoc AbstractSimulationHandler::attachSimulationToCacheFile */
+    bool attachSimulationToCacheFile(const std::string& cacheFile) final;
+
+    /**
+     * @brief Writes a cache file from spikes sorted by time. The number of
+     * frames and the frame size must be set beforehand.
+     * @param cacheFile File to write
+     * @param spikes Spikes sorted by frame
+     * @return True if the file was successfully written, false otherwise
+     */
+    bool writeCacheFile(const std::string& cacheFile,
+                        const SpikeEvents& spikes);
+
     /**
-     * @brief Returns a pointer to the current frame in the memory mapped file.
+     * @brief Returns the last spike frame of every neuron at the current
+     * timestamp
      * @return Pointer to given frame
      */
     void* getFrameData() final;
+
+    /** @copydoc AbstractSimulationHandler::getMemoryUsage */
+    MemoryUsage getMemoryUsage() const final;
+
+private:
+    void _applySpikes(uint64_t firstFrame, uint64_t endFrame);
+    void _expireSpikes(uint64_t firstFrame, uint64_t endFrame);
+
+    MemoryMappedFile _cache;
+    const uint64_t* _frameOffsets;
+    const SpikeEvent* _spikes;
+    floats _frameData;
+    int64_t _currentDataFrame;
 };
 }
 
@@ -26,6 +26,7 @@
 #include <boost/program_options.hpp>
 
 #include <cstdint>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
@@ -123,6 +124,13 @@ typedef std::map<size_t, Cones> ConesMap;
 class TrianglesMesh;
 typedef std::map<size_t, TrianglesMesh> TrianglesMeshMap;
 
+class InstancedModel;
+typedef std::shared_ptr<InstancedModel> InstancedModelPtr;
+typedef std::map<std::string, InstancedModelPtr> InstancedModelsMap;
+
+class SpatialIndex;
+typedef std::shared_ptr<SpatialIndex> SpatialIndexPtr;
+
 class Material;
 typedef std::shared_ptr<Material> MaterialPtr;
 typedef std::map<size_t, MaterialPtr> MaterialsMap;
@@ -159,6 +167,9 @@ typedef std::shared_ptr<CADiffusionSimulationHandler>
 class VolumeHandler;
 typedef std::shared_ptr<VolumeHandler> VolumeHandlerPtr;
 
+struct MemoryUsage;
+class MemoryRegistry;
+
 typedef std::vector<std::string> strings;
 typedef std::vector<float> floats;
 typedef std::vector<int> ints;
@@ -173,6 +184,12 @@ typedef std::vector<int64_t> int64_ts;
 typedef std::vector<uint64_t> uint64_ts;
 typedef std::vector<size_t> size_ts;
 
+/**
+ * Called by loaders after each batch of loaded items, with the number of items
+ * loaded so far and the total number of items
+ */
+typedef std::function<void(size_t, size_t)> LoadingCallback;
+
 class AbstractParameters;
 class ApplicationParameters;
 class GeometryParameters;
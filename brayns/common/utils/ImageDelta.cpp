@@ -0,0 +1,157 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ImageDelta.h"
+
+#include <cstring>
+
+namespace brayns
+{
+ImageDelta::ImageDelta(const size_t tileSize, const size_t keyframeInterval)
+    : _tileSize(std::max(tileSize, size_t(1)))
+    , _keyframeInterval(keyframeInterval)
+    , _frame(0)
+    , _framesSinceKeyframe(0)
+    , _keyframeFrame(0)
+    , _keyframe(true)
+    , _forceKeyframe(true)
+    , _pixelSize(0)
+{
+}
+
+void ImageDelta::setTileSize(const size_t tileSize)
+{
+    const size_t newTileSize = std::max(tileSize, size_t(1));
+    if (newTileSize != _tileSize)
+    {
+        _tileSize = newTileSize;
+        _forceKeyframe = true;
+    }
+}
+
+void ImageDelta::reset()
+{
+    _forceKeyframe = true;
+}
+
+bool ImageDelta::update(const uint8_t* data, const Vector2ui& size,
+                        const size_t pixelSize)
+{
+    ++_frame;
+    _tiles.clear();
+
+    const size_t bufferSize = size.x() * size.y() * pixelSize;
+    _keyframe = _forceKeyframe || size != _size || pixelSize != _pixelSize ||
+                (_keyframeInterval != 0 &&
+                 _framesSinceKeyframe + 1 >= _keyframeInterval);
+
+    const size_t nbTilesX = (size.x() + _tileSize - 1) / _tileSize;
+    const size_t nbTilesY = (size.y() + _tileSize - 1) / _tileSize;
+    ImageTiles tiles;
+    tiles.reserve(nbTilesX * nbTilesY);
+    for (size_t y = 0; y < nbTilesY; ++y)
+        for (size_t x = 0; x < nbTilesX; ++x)
+        {
+            ImageTile tile;
+            tile.origin = Vector2ui(x * _tileSize, y * _tileSize);
+            tile.size = Vector2ui(
+                std::min<size_t>(_tileSize, size.x() - tile.origin.x()),
+                std::min<size_t>(_tileSize, size.y() - tile.origin.y()));
+            tiles.push_back(tile);
+        }
+
+    if (_keyframe)
+    {
+        _reference.resize(bufferSize);
+        memcpy(_reference.data(), data, bufferSize);
+        _tiles = tiles;
+        _tileFrames.assign(tiles.size(), _frame);
+        _framesSinceKeyframe = 0;
+        _keyframeFrame = _frame;
+        _forceKeyframe = false;
+    }
+    else
+    {
+        ++_framesSinceKeyframe;
+        std::vector<char> dirty(tiles.size(), 0);
+#pragma omp parallel for
+        for (size_t i = 0; i < tiles.size(); ++i)
+        {
+            // Only the changed tiles need to be copied into the reference
+            dirty[i] = _isTileDirty(data, tiles[i]);
+            if (dirty[i])
+                _copyTile(data, tiles[i]);
+        }
+
+        for (size_t i = 0; i < tiles.size(); ++i)
+            if (dirty[i])
+            {
+                _tiles.push_back(tiles[i]);
+                _tileFrames[i] = _frame;
+            }
+    }
+    _allTiles.swap(tiles);
+
+    _size = size;
+    _pixelSize = pixelSize;
+    return _keyframe;
+}
+
+bool ImageDelta::needsKeyframe(const size_t frame) const
+{
+    return frame < _keyframeFrame || frame > _frame;
+}
+
+ImageTiles ImageDelta::getTilesSince(const size_t frame) const
+{
+    if (needsKeyframe(frame))
+        return _allTiles;
+
+    ImageTiles tiles;
+    for (size_t i = 0; i < _allTiles.size(); ++i)
+        if (_tileFrames[i] > frame)
+            tiles.push_back(_allTiles[i]);
+    return tiles;
+}
+
+bool ImageDelta::_isTileDirty(const uint8_t* data, const ImageTile& tile) const
+{
+    const size_t pitch = _size.x() * _pixelSize;
+    const size_t rowSize = tile.size.x() * _pixelSize;
+    for (size_t y = tile.origin.y(); y < tile.origin.y() + tile.size.y(); ++y)
+    {
+        const size_t offset = y * pitch + tile.origin.x() * _pixelSize;
+        if (memcmp(data + offset, _reference.data() + offset, rowSize) != 0)
+            return true;
+    }
+    return false;
+}
+
+void ImageDelta::_copyTile(const uint8_t* data, const ImageTile& tile)
+{
+    const size_t pitch = _size.x() * _pixelSize;
+    const size_t rowSize = tile.size.x() * _pixelSize;
+    for (size_t y = tile.origin.y(); y < tile.origin.y() + tile.size.y(); ++y)
+    {
+        const size_t offset = y * pitch + tile.origin.x() * _pixelSize;
+        memcpy(_reference.data() + offset, data + offset, rowSize);
+    }
+}
+}
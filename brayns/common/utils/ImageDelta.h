@@ -0,0 +1,116 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef IMAGEDELTA_H
+#define IMAGEDELTA_H
+
+#include <brayns/api.h>
+#include <brayns/common/types.h>
+
+namespace brayns
+{
+/** Rectangular region of an image, in pixels */
+struct ImageTile
+{
+    Vector2ui origin;
+    Vector2ui size;
+};
+typedef std::vector<ImageTile> ImageTiles;
+
+/**
+ * Keeps track of the last image sent to remote clients and computes, for
+ * every new image, the list of tiles that have changed since then. A keyframe
+ * (full image) is requested for the first image, whenever the size or pixel
+ * layout changes, after an explicit reset, and every keyframeInterval images.
+ * The frame at which each tile last changed is kept, so that clients that did
+ * not receive every image can be sent the tiles changed since their own last
+ * image.
+ */
+class ImageDelta
+{
+public:
+    /**
+     * @param tileSize Size of the square tiles in pixels
+     * @param keyframeInterval Number of images between two keyframes. 0 means
+     *        that only the first image is a keyframe
+     */
+    BRAYNS_API ImageDelta(size_t tileSize, size_t keyframeInterval);
+
+    /**
+     * @brief Compares the given image with the previous one and updates the
+     *        list of dirty tiles. The image is then kept as the reference for
+     *        the next call.
+     * @param data Pixels of the image, rows stored contiguously
+     * @param size Size of the image in pixels
+     * @param pixelSize Size of one pixel in bytes
+     * @return True if the image has to be sent as a keyframe
+     */
+    BRAYNS_API bool update(const uint8_t* data, const Vector2ui& size,
+                           size_t pixelSize);
+
+    /** Forces the next image to be a keyframe */
+    BRAYNS_API void reset();
+
+    /** Tiles that changed during the last update. Covers the whole image for
+     * keyframes */
+    const ImageTiles& getTiles() const { return _tiles; }
+
+    /**
+     * @return true if a client which last received the given frame needs a
+     *         keyframe, i.e. if that frame precedes the last keyframe or is
+     *         unknown
+     */
+    BRAYNS_API bool needsKeyframe(size_t frame) const;
+
+    /**
+     * @return the tiles that changed after the given frame, the whole image if
+     *         the frame needs a keyframe
+     */
+    BRAYNS_API ImageTiles getTilesSince(size_t frame) const;
+    /** True if the last update produced a keyframe */
+    bool isKeyframe() const { return _keyframe; }
+    /** Number of images processed since the creation of the object */
+    size_t getFrame() const { return _frame; }
+
+    size_t getTileSize() const { return _tileSize; }
+    void setTileSize(size_t tileSize);
+    size_t getKeyframeInterval() const { return _keyframeInterval; }
+    void setKeyframeInterval(size_t interval) { _keyframeInterval = interval; }
+
+private:
+    bool _isTileDirty(const uint8_t* data, const ImageTile& tile) const;
+    void _copyTile(const uint8_t* data, const ImageTile& tile);
+
+    size_t _tileSize;
+    size_t _keyframeInterval;
+    size_t _frame;
+    size_t _framesSinceKeyframe;
+    size_t _keyframeFrame;
+    bool _keyframe;
+    bool _forceKeyframe;
+    Vector2ui _size;
+    size_t _pixelSize;
+    uint8_ts _reference;
+    ImageTiles _tiles;
+    ImageTiles _allTiles;
+    std::vector<size_t> _tileFrames;
+};
+}
+#endif // IMAGEDELTA_H
@@ -0,0 +1,154 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "MemoryMappedFile.h"
+
+#include <brayns/common/log.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace brayns
+{
+MemoryMappedFile::~MemoryMappedFile()
+{
+    unmap();
+}
+
+bool MemoryMappedFile::map(const std::string& filename, const bool sequential)
+{
+    unmap();
+
+    _descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (_descriptor == -1)
+    {
+        BRAYNS_ERROR << "Failed to open " << filename << std::endl;
+        return false;
+    }
+
+    struct stat sb;
+    if (::fstat(_descriptor, &sb) == -1)
+    {
+        BRAYNS_ERROR << "Failed to get stats from " << filename << std::endl;
+        unmap();
+        return false;
+    }
+
+    // Empty files cannot be mapped, they are valid though
+    _size = sb.st_size;
+    if (_size == 0)
+        return true;
+
+    _data = ::mmap(0, _size, PROT_READ, MAP_PRIVATE, _descriptor, 0);
+    if (_data == MAP_FAILED)
+    {
+        _data = nullptr;
+        BRAYNS_ERROR << "Failed to map " << filename << std::endl;
+        unmap();
+        return false;
+    }
+
+    if (sequential)
+    {
+        ::madvise(_data, _size, MADV_SEQUENTIAL);
+        ::madvise(_data, _size, MADV_WILLNEED);
+    }
+    return true;
+}
+
+bool MemoryMappedFile::resize(const std::string& filename, const uint64_t size)
+{
+    unmap();
+
+    _descriptor = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (_descriptor == -1)
+    {
+        BRAYNS_ERROR << "Failed to open " << filename << std::endl;
+        return false;
+    }
+
+    if (::ftruncate(_descriptor, size) == -1)
+    {
+        BRAYNS_ERROR << "Failed to resize " << filename << std::endl;
+        unmap();
+        return false;
+    }
+
+    _size = size;
+    if (_size == 0)
+        return true;
+
+    _data = ::mmap(0, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _descriptor,
+                   0);
+    if (_data == MAP_FAILED)
+    {
+        _data = nullptr;
+        BRAYNS_ERROR << "Failed to map " << filename << std::endl;
+        unmap();
+        return false;
+    }
+    return true;
+}
+
+void MemoryMappedFile::prefetch(const uint64_t offset, uint64_t size) const
+{
+    if (!_data || offset >= _size)
+        return;
+
+    // madvise requires a page aligned address
+    const uint64_t pageSize = sysconf(_SC_PAGESIZE);
+    const uint64_t begin = offset - offset % pageSize;
+    size = std::min(size, _size - offset) + offset - begin;
+    ::madvise(static_cast<char*>(_data) + begin, size, MADV_WILLNEED);
+}
+
+std::vector<const char*> MemoryMappedFile::getLineChunks(
+    const size_t nbChunks) const
+{
+    const char* data = getData();
+    const char* end = data + _size;
+    std::vector<const char*> boundaries(1, data);
+    for (size_t i = 1; i < nbChunks; ++i)
+    {
+        const char* c =
+            std::max(data + i * _size / nbChunks, boundaries.back());
+        const void* endOfLine = std::memchr(c, '\n', end - c);
+        boundaries.push_back(
+            endOfLine ? static_cast<const char*>(endOfLine) + 1 : end);
+    }
+    boundaries.push_back(end);
+    return boundaries;
+}
+
+void MemoryMappedFile::unmap()
+{
+    if (_data)
+        ::munmap(_data, _size);
+    if (_descriptor != -1)
+        ::close(_descriptor);
+    _data = nullptr;
+    _descriptor = -1;
+    _size = 0;
+}
+}
@@ -0,0 +1,92 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef MEMORYMAPPEDFILE_H
+#define MEMORYMAPPEDFILE_H
+
+#include <brayns/api.h>
+#include <brayns/common/types.h>
+
+namespace brayns
+{
+/**
+ * Memory map of a whole file, read-only unless it is mapped with resize().
+ * The file is unmapped when the object is destroyed.
+ */
+class MemoryMappedFile
+{
+public:
+    MemoryMappedFile() = default;
+    BRAYNS_API ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    /**
+     * Maps the given file, unmapping the previously mapped one
+     * @param filename File to map
+     * @param sequential Hints the system that the file is read once from the
+     *        beginning to the end, so that pages are read ahead
+     * @return True if the file was successfully mapped, false otherwise
+     */
+    BRAYNS_API bool map(const std::string& filename, bool sequential = true);
+
+    /**
+     * Maps the given file for writing, creating it if needed and resizing it
+     * to the given size. Existing content within that size is kept, and
+     * writes go to the file.
+     * @param filename File to map
+     * @param size Size of the file in bytes
+     * @return True if the file was successfully mapped, false otherwise
+     */
+    BRAYNS_API bool resize(const std::string& filename, uint64_t size);
+
+    /** Unmaps the file */
+    BRAYNS_API void unmap();
+
+    /** @return the mapped data, nullptr if nothing is mapped */
+    const char* getData() const { return static_cast<const char*>(_data); }
+    /** @return the mapped data, only writable if mapped with resize() */
+    char* getData() { return static_cast<char*>(_data); }
+    /** @return the size of the mapped file in bytes */
+    uint64_t getSize() const { return _size; }
+
+    /**
+     * Asks the system to read the given range of the file in the background,
+     * so that it is in memory when accessed
+     */
+    BRAYNS_API void prefetch(uint64_t offset, uint64_t size) const;
+
+    /**
+     * Splits a text file in chunks of whole lines of roughly the same size,
+     * so that they can be parsed in parallel
+     * @param nbChunks Number of chunks, some of them may be empty
+     * @return nbChunks + 1 boundaries, chunk i spans from boundary i to
+     *         boundary i + 1
+     */
+    BRAYNS_API std::vector<const char*> getLineChunks(size_t nbChunks) const;
+
+private:
+    int _descriptor = -1;
+    void* _data = nullptr;
+    uint64_t _size = 0;
+};
+}
+#endif // MEMORYMAPPEDFILE_H
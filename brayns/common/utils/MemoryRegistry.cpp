@@ -0,0 +1,103 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "MemoryRegistry.h"
+
+#include <brayns/common/log.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+const double MEGABYTE = 1024.0 * 1024.0;
+}
+
+namespace brayns
+{
+void MemoryRegistry::set(const std::string& owner, const MemoryUsage& usage)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _usages[owner] = usage;
+}
+
+void MemoryRegistry::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _usages.clear();
+}
+
+MemoryUsages MemoryRegistry::getUsages() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _usages;
+}
+
+MemoryUsage MemoryRegistry::getTotal() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    MemoryUsage total;
+    for (const auto& usage : _usages)
+        total += usage.second;
+    return total;
+}
+
+bool MemoryRegistry::fits(const uint64_t bytes) const
+{
+    return _budget == 0 || getTotal().resident + bytes <= _budget;
+}
+
+void MemoryRegistry::print() const
+{
+    const auto usages = getUsages();
+    MemoryUsage total;
+    BRAYNS_INFO << "Memory usage (resident / reserved MB):" << std::endl;
+    for (const auto& usage : usages)
+    {
+        BRAYNS_INFO << "- " << usage.first << ": "
+                    << usage.second.resident / MEGABYTE << " / "
+                    << usage.second.reserved / MEGABYTE << std::endl;
+        total += usage.second;
+    }
+    BRAYNS_INFO << "Total: " << total.resident / MEGABYTE << " / "
+                << total.reserved / MEGABYTE << std::endl;
+    if (_budget != 0)
+        BRAYNS_INFO << "Budget: " << _budget / MEGABYTE << std::endl;
+}
+
+uint64_t MemoryRegistry::getResidentSize(const void* address,
+                                         const uint64_t size)
+{
+    if (!address || size == 0)
+        return 0;
+
+    const uint64_t pageSize = sysconf(_SC_PAGESIZE);
+    const uint64_t nbPages = (size + pageSize - 1) / pageSize;
+    std::vector<unsigned char> pages(nbPages);
+    if (mincore(const_cast<void*>(address), size, pages.data()) != 0)
+        return 0;
+
+    uint64_t nbResidentPages = 0;
+    for (const auto page : pages)
+        if (page & 1)
+            ++nbResidentPages;
+    return std::min(nbResidentPages * pageSize, size);
+}
+}
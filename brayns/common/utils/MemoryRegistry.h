@@ -0,0 +1,104 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef MEMORYREGISTRY_H
+#define MEMORYREGISTRY_H
+
+#include <brayns/api.h>
+#include <brayns/common/types.h>
+
+#include <map>
+#include <mutex>
+
+namespace brayns
+{
+/** Memory held by a component, in bytes */
+struct MemoryUsage
+{
+    /** Bytes actually backed by physical memory */
+    uint64_t resident = 0;
+    /** Bytes allocated or mapped, including unused capacity */
+    uint64_t reserved = 0;
+
+    MemoryUsage& operator+=(const MemoryUsage& other)
+    {
+        resident += other.resident;
+        reserved += other.reserved;
+        return *this;
+    }
+};
+typedef std::map<std::string, MemoryUsage> MemoryUsages;
+
+/**
+ * Central registry where the main owners of memory (scene, serialized
+ * geometry, simulation and volume data, textures, frame buffers) report how
+ * much they hold. The registry also carries an optional budget, checked
+ * before loading new data.
+ */
+class MemoryRegistry
+{
+public:
+    /** Sets the usage of the given owner, replacing the previous one */
+    BRAYNS_API void set(const std::string& owner, const MemoryUsage& usage);
+
+    /** Removes all owners */
+    BRAYNS_API void clear();
+
+    /** @return the usage of all owners */
+    BRAYNS_API MemoryUsages getUsages() const;
+
+    /** @return the sum of the usages of all owners */
+    BRAYNS_API MemoryUsage getTotal() const;
+
+    /** Budget in bytes, 0 if there is no budget */
+    uint64_t getBudget() const { return _budget; }
+    void setBudget(const uint64_t bytes) { _budget = bytes; }
+
+    /**
+     * @return true if the given amount of bytes can be added to the resident
+     *         memory without exceeding the budget
+     */
+    BRAYNS_API bool fits(uint64_t bytes) const;
+
+    /** Logs the usage of all owners */
+    BRAYNS_API void print() const;
+
+    /**
+     * @return the number of bytes of a memory mapped region that are
+     *         currently resident in physical memory
+     */
+    BRAYNS_API static uint64_t getResidentSize(const void* address,
+                                               uint64_t size);
+
+private:
+    mutable std::mutex _mutex;
+    MemoryUsages _usages;
+    uint64_t _budget = 0;
+};
+
+/** Adds the memory of a vector to a usage */
+template <typename T>
+void addMemoryUsage(const std::vector<T>& vector, MemoryUsage& usage)
+{
+    usage.resident += vector.size() * sizeof(T);
+    usage.reserved += vector.capacity() * sizeof(T);
+}
+}
+#endif // MEMORYREGISTRY_H
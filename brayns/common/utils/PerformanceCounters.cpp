@@ -0,0 +1,84 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "PerformanceCounters.h"
+
+#include <algorithm>
+
+namespace brayns
+{
+PerformanceCounters::PerformanceCounters(const size_t windowSize)
+    : _windowSize(std::max(windowSize, size_t(1)))
+{
+}
+
+void PerformanceCounters::add(const std::string& name,
+                              const double milliseconds)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& counter = _counters[name];
+    if (counter.samples.size() < _windowSize)
+        counter.samples.push_back(milliseconds);
+    else
+        counter.samples[counter.next] = milliseconds;
+    counter.next = (counter.next + 1) % _windowSize;
+    counter.last = milliseconds;
+    ++counter.count;
+}
+
+CountersStatistics PerformanceCounters::getStatistics() const
+{
+    std::map<std::string, Counter> counters;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        counters = _counters;
+    }
+
+    CountersStatistics statistics;
+    for (auto& counter : counters)
+    {
+        auto& samples = counter.second.samples;
+        auto& result = statistics[counter.first];
+        result.last = counter.second.last;
+        result.count = counter.second.count;
+        if (samples.empty())
+            continue;
+
+        double sum = 0.0;
+        for (const auto sample : samples)
+            sum += sample;
+        result.average = sum / samples.size();
+        result.min = *std::min_element(samples.begin(), samples.end());
+
+        // Nearest rank: the smallest sample not exceeded by 95% of them
+        const size_t p95 = (samples.size() * 95 + 99) / 100 - 1;
+        std::nth_element(samples.begin(), samples.begin() + p95,
+                         samples.end());
+        result.p95 = samples[p95];
+    }
+    return statistics;
+}
+
+void PerformanceCounters::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _counters.clear();
+}
+}
@@ -0,0 +1,117 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef PERFORMANCECOUNTERS_H
+#define PERFORMANCECOUNTERS_H
+
+#include <brayns/api.h>
+#include <brayns/common/types.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace brayns
+{
+/** Statistics of the most recent durations of a counter, in milliseconds */
+struct CounterStatistics
+{
+    double last = 0.0;
+    double min = 0.0;
+    double average = 0.0;
+    double p95 = 0.0;
+    uint64_t count = 0; // Total number of samples since creation
+};
+typedef std::map<std::string, CounterStatistics> CountersStatistics;
+
+/**
+ * Thread-safe collection of named duration counters. Each counter keeps the
+ * last windowSize samples, from which rolling statistics are computed on
+ * demand, so that recording a sample stays cheap enough to be always on.
+ */
+class PerformanceCounters
+{
+public:
+    /** Measures the lifetime of the object and records it in a counter */
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(PerformanceCounters& counters, const std::string& name)
+            : _counters(counters)
+            , _name(name)
+            , _start(std::chrono::high_resolution_clock::now())
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            const std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::high_resolution_clock::now() - _start;
+            _counters.add(_name, elapsed.count());
+        }
+
+    private:
+        PerformanceCounters& _counters;
+        const std::string _name;
+        const std::chrono::high_resolution_clock::time_point _start;
+    };
+
+    /** @param windowSize Number of samples kept per counter */
+    BRAYNS_API explicit PerformanceCounters(size_t windowSize = 128);
+
+    /** Records a duration, in milliseconds, for the given counter */
+    BRAYNS_API void add(const std::string& name, double milliseconds);
+
+    /** @return the statistics of all counters */
+    BRAYNS_API CountersStatistics getStatistics() const;
+
+    /** Removes all counters */
+    BRAYNS_API void clear();
+
+private:
+    struct Counter
+    {
+        std::vector<double> samples;
+        size_t next = 0;
+        uint64_t count = 0;
+        double last = 0.0;
+    };
+
+    const size_t _windowSize;
+    mutable std::mutex _mutex;
+    std::map<std::string, Counter> _counters;
+};
+
+/** Names of the counters recorded by Brayns */
+namespace counters
+{
+const std::string PLUGINS = "plugins";
+const std::string ENGINE_COMMIT = "engine_commit";
+const std::string GEOMETRY_SERIALIZATION = "geometry_serialization";
+const std::string SIMULATION_UPLOAD = "simulation_upload";
+const std::string VOLUME_UPLOAD = "volume_upload";
+const std::string RENDER = "render";
+const std::string FRAME_BUFFER_MAP = "frame_buffer_map";
+const std::string FRAME_BUFFER_UNMAP = "frame_buffer_unmap";
+const std::string JPEG_ENCODING = "jpeg_encoding";
+const std::string HTTP = "http";
+}
+}
+#endif // PERFORMANCECOUNTERS_H
@@ -24,6 +24,18 @@
 
 #include <boost/filesystem.hpp>
 
+namespace
+{
+std::string getTemporaryFilename(const std::string& filename)
+{
+    const boost::filesystem::path path(filename);
+    return (path.parent_path() /
+            boost::filesystem::unique_path(path.filename().string() +
+                                           ".%%%%-%%%%-%%%%.tmp"))
+        .string();
+}
+}
+
 namespace brayns
 {
 strings parseFolder(const std::string& folder, const strings& filters)
@@ -54,4 +66,44 @@ strings parseFolder(const std::string& folder, const strings& filters)
     std::sort(files.begin(), files.end());
     return files;
 }
+
+AtomicFileWriter::AtomicFileWriter(const std::string& filename)
+    : _filename(filename)
+    , _temporaryFile(getTemporaryFilename(filename))
+    , _stream(_temporaryFile, std::ios::out | std::ios::binary)
+{
+}
+
+AtomicFileWriter::~AtomicFileWriter()
+{
+    if (_committed)
+        return;
+    _stream.close();
+    boost::system::error_code error;
+    boost::filesystem::remove(_temporaryFile, error);
+}
+
+bool AtomicFileWriter::commit()
+{
+    if (_committed)
+        return true;
+    _stream.close();
+    if (_stream.fail())
+    {
+        BRAYNS_ERROR << "Could not write " << _temporaryFile << std::endl;
+        return false;
+    }
+
+    // rename() replaces the file in a single step on POSIX file systems
+    boost::system::error_code error;
+    boost::filesystem::rename(_temporaryFile, _filename, error);
+    if (error)
+    {
+        BRAYNS_ERROR << "Could not rename " << _temporaryFile << " to "
+                     << _filename << ": " << error.message() << std::endl;
+        return false;
+    }
+    _committed = true;
+    return true;
+}
 }
@@ -23,9 +23,38 @@
 
 #include <brayns/common/types.h>
 
+#include <fstream>
+
 namespace brayns
 {
 strings parseFolder(const std::string& folder, const strings& filters);
+
+/**
+ * Writes a file through a unique temporary file of the same folder, which is
+ * renamed over the file by commit(). Concurrent readers, e.g. other processes
+ * mapping the file, thus never see a partially written file. The temporary
+ * file is removed if the writer is destroyed without a successful commit.
+ */
+class AtomicFileWriter
+{
+public:
+    explicit AtomicFileWriter(const std::string& filename);
+    ~AtomicFileWriter();
+
+    std::ofstream& getStream() { return _stream; }
+
+    /** Closes the stream and moves the temporary file into place */
+    bool commit();
+
+private:
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+    const std::string _filename;
+    const std::string _temporaryFile;
+    std::ofstream _stream;
+    bool _committed{false};
+};
 }
 
 #endif // UTILS_H
@@ -21,6 +21,7 @@
 #include "VolumeHandler.h"
 
 #include <brayns/common/log.h>
+#include <brayns/common/utils/MemoryRegistry.h>
 
 #include <fcntl.h>
 #include <fstream>
@@ -129,6 +130,22 @@ uint64_t VolumeHandler::getSize() const
     return 0;
 }
 
+MemoryUsage VolumeHandler::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    for (const auto& volumeDescriptor : _volumeDescriptors)
+    {
+        const auto& descriptor = volumeDescriptor.second;
+        const void* data = descriptor->getMemoryMapPtr();
+        if (!data)
+            continue;
+        usage.reserved += descriptor->getSize();
+        usage.resident +=
+            MemoryRegistry::getResidentSize(data, descriptor->getSize());
+    }
+    return usage;
+}
+
 float VolumeHandler::_getBoundedTimestamp(const float timestamp) const
 {
     float result = 0.f;
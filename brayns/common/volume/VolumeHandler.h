@@ -80,6 +80,12 @@ public:
      */
     uint64_t getSize() const;
 
+    /**
+     * @brief Returns the memory mapped by all volumes attached to the handler
+     * @return Resident and mapped bytes
+     */
+    MemoryUsage getMemoryUsage() const;
+
     /**
      * @brief Returns a pointer to a given frame in the memory mapped file.
      * @return Pointer to volume
@@ -132,6 +138,11 @@ public:
      */
     void setTimestamp(const float timestamp);
 
+    /**
+     * @brief Gets the timestamp of the currently mapped volume
+     */
+    float getTimestamp() const { return _timestamp; }
+
     /** Set the histogram of the currently loaded volume. */
     void setHistogram(const Histogram& histogram)
     {
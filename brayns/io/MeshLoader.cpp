@@ -27,26 +27,320 @@
 
 #include <boost/filesystem.hpp>
 #include <brayns/common/log.h>
+#include <brayns/common/utils/MemoryMappedFile.h>
+#include <brayns/common/utils/Utils.h>
 #include <fstream>
 
 #include <brayns/common/scene/Scene.h>
 
-namespace brayns
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+namespace
+{
+const std::string CACHE_EXTENSION = ".meshcache";
+const uint64_t CACHE_MAGIC = 0xb5a15e5u;
+const uint64_t CACHE_VERSION = 1;
+
+/** Material attributes read from a mesh file */
+struct ImportedMaterial
+{
+    brayns::Vector3f color;
+    brayns::Vector3f specularColor;
+    float specularExponent;
+    float reflectionIndex;
+    float emission;
+    float opacity;
+    float refractionIndex;
+    brayns::TextureTypes textures;
+};
+
+/** Welded mesh of a mesh file, in the file space */
+struct ImportedMesh
 {
-MeshLoader::MeshLoader()
+    uint64_t materialIndex;
+    brayns::Vector3fs vertices;
+    brayns::Vector3fs normals;
+    brayns::Vector2fs textureCoordinates;
+    brayns::Vector4fs colors;
+    brayns::Vector3uis indices;
+};
+
+struct ImportedFile
 {
+    std::vector<ImportedMaterial> materials;
+    std::vector<ImportedMesh> meshes;
+};
+
+/**
+ * Normals are quantized to two 16 bit integers using the octahedral mapping,
+ * texture coordinates to half floats, and colors to 8 bits per channel
+ */
+void encodeNormal(const brayns::Vector3f& normal, int16_t* code)
+{
+    const float sum =
+        std::abs(normal.x()) + std::abs(normal.y()) + std::abs(normal.z());
+    float x = sum > 0.f ? normal.x() / sum : 0.f;
+    float y = sum > 0.f ? normal.y() / sum : 0.f;
+    if (normal.z() < 0.f)
+    {
+        const float foldedX = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+        y = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+        x = foldedX;
+    }
+    code[0] = int16_t(std::round(x * 32767.f));
+    code[1] = int16_t(std::round(y * 32767.f));
 }
 
-void MeshLoader::clear()
+brayns::Vector3f decodeNormal(const int16_t* code)
 {
-    _meshIndex.clear();
+    const float x = code[0] / 32767.f;
+    const float y = code[1] / 32767.f;
+    const float z = 1.f - std::abs(x) - std::abs(y);
+    brayns::Vector3f normal(x, y, z);
+    if (z < 0.f)
+    {
+        normal.x() = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+        normal.y() = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+    }
+    normal.normalize();
+    return normal;
 }
 
-bool MeshLoader::importMeshFromFile(const std::string& filename, Scene& scene,
-                                    MeshQuality meshQuality,
-                                    const Vector3f& position,
-                                    const Vector3f& scale,
-                                    const size_t defaultMaterial)
+uint16_t encodeHalf(const float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = (bits >> 16) & 0x8000;
+    const int32_t exponent = int32_t((bits >> 23) & 0xff) - 127 + 15;
+    const uint32_t mantissa = bits & 0x7fffff;
+    if (exponent <= 0)
+        return sign; // Too small, flushed to zero
+    if (exponent >= 31)
+        return sign | 0x7c00; // Too large, infinity
+    // Round to the nearest
+    return sign | ((exponent << 10) + ((mantissa + 0x1000) >> 13));
+}
+
+float decodeHalf(const uint16_t half)
+{
+    const uint32_t sign = uint32_t(half & 0x8000) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1f;
+    const uint32_t mantissa = half & 0x3ff;
+    uint32_t bits = sign;
+    if (exponent == 31)
+        bits |= 0x7f800000 | (mantissa << 13);
+    else if (exponent != 0)
+        bits |= ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+uint8_t encodeColor(const float value)
+{
+    return uint8_t(std::round(std::min(std::max(value, 0.f), 1.f) * 255.f));
+}
+
+/** Vertex attributes, compared bitwise to weld identical vertices */
+struct Vertex
+{
+    float values[12];
+
+    bool operator==(const Vertex& rhs) const
+    {
+        return memcmp(values, rhs.values, sizeof(values)) == 0;
+    }
+};
+
+struct VertexHash
+{
+    size_t operator()(const Vertex& vertex) const
+    {
+        // FNV-1a
+        size_t hash = 14695981039346656037ull;
+        const auto bytes =
+            reinterpret_cast<const unsigned char*>(vertex.values);
+        for (size_t i = 0; i < sizeof(vertex.values); ++i)
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        return hash;
+    }
+};
+
+/**
+ * Welds the identical vertices of a mesh. Vertices are numbered in the order
+ * in which the triangles first reference them, which keeps the vertices of
+ * neighbouring triangles close in memory. Attributes are quantized before
+ * welding if requested, so that vertices only differing by less than the
+ * quantization step are merged.
+ */
+void weldMesh(const aiMesh& mesh, const bool quantize, ImportedMesh& result)
+{
+    const bool hasNormals = mesh.HasNormals();
+    const bool hasTextureCoordinates = mesh.HasTextureCoords(0);
+    const bool hasColors = mesh.HasVertexColors(0);
+
+    std::unordered_map<Vertex, uint32_t, VertexHash> indices;
+    indices.reserve(mesh.mNumVertices);
+    result.materialIndex = mesh.mMaterialIndex;
+    result.indices.reserve(mesh.mNumFaces);
+
+    for (size_t f = 0; f < mesh.mNumFaces; ++f)
+    {
+        const aiFace& face = mesh.mFaces[f];
+        if (face.mNumIndices != 3)
+            continue;
+
+        uint32_t triangle[3];
+        for (size_t i = 0; i < 3; ++i)
+        {
+            const size_t index = face.mIndices[i];
+            Vertex vertex;
+            memset(vertex.values, 0, sizeof(vertex.values));
+            const aiVector3D& position = mesh.mVertices[index];
+            brayns::Vector3f normal;
+            brayns::Vector2f textureCoordinate;
+            brayns::Vector4f color;
+            if (hasNormals)
+            {
+                const aiVector3D& n = mesh.mNormals[index];
+                normal = brayns::Vector3f(n.x, n.y, n.z);
+                if (quantize)
+                {
+                    int16_t code[2];
+                    encodeNormal(normal, code);
+                    normal = decodeNormal(code);
+                }
+            }
+            if (hasTextureCoordinates)
+            {
+                const aiVector3D& t = mesh.mTextureCoords[0][index];
+                textureCoordinate = brayns::Vector2f(t.x, -t.y);
+                if (quantize)
+                    for (size_t c = 0; c < 2; ++c)
+                        textureCoordinate[c] =
+                            decodeHalf(encodeHalf(textureCoordinate[c]));
+            }
+            if (hasColors)
+            {
+                const aiColor4D& c = mesh.mColors[0][index];
+                color = brayns::Vector4f(c.r, c.g, c.b, c.a);
+                if (quantize)
+                    for (size_t component = 0; component < 4; ++component)
+                        color[component] =
+                            encodeColor(color[component]) / 255.f;
+            }
+
+            const float values[12] = {position.x, position.y, position.z,
+                                      normal.x(), normal.y(), normal.z(),
+                                      textureCoordinate.x(),
+                                      textureCoordinate.y(), color.x(),
+                                      color.y(), color.z(), color.w()};
+            memcpy(vertex.values, values, sizeof(values));
+
+            const auto it = indices.find(vertex);
+            if (it != indices.end())
+            {
+                triangle[i] = it->second;
+                continue;
+            }
+
+            triangle[i] = result.vertices.size();
+            indices[vertex] = triangle[i];
+            result.vertices.push_back(
+                brayns::Vector3f(position.x, position.y, position.z));
+            if (hasNormals)
+                result.normals.push_back(normal);
+            if (hasTextureCoordinates)
+                result.textureCoordinates.push_back(textureCoordinate);
+            if (hasColors)
+                result.colors.push_back(color);
+        }
+        result.indices.push_back(
+            brayns::Vector3ui(triangle[0], triangle[1], triangle[2]));
+    }
+}
+
+void readMaterials(const aiScene& aiScene, const std::string& folder,
+                   std::vector<ImportedMaterial>& materials)
+{
+    struct TextureTypeMapping
+    {
+        aiTextureType aiType;
+        brayns::TextureType type;
+    };
+
+    const size_t NB_TEXTURE_TYPES = 6;
+    TextureTypeMapping textureTypeMapping[NB_TEXTURE_TYPES] = {
+        {aiTextureType_DIFFUSE, brayns::TT_DIFFUSE},
+        {aiTextureType_NORMALS, brayns::TT_NORMALS},
+        {aiTextureType_SPECULAR, brayns::TT_SPECULAR},
+        {aiTextureType_EMISSIVE, brayns::TT_EMISSIVE},
+        {aiTextureType_OPACITY, brayns::TT_OPACITY},
+        {aiTextureType_REFLECTION, brayns::TT_REFLECTION}};
+
+    materials.resize(aiScene.mNumMaterials);
+    for (size_t m = 0; m < aiScene.mNumMaterials; ++m)
+    {
+        aiMaterial* material = aiScene.mMaterials[m];
+        ImportedMaterial& importedMaterial = materials[m];
+
+        for (size_t textureType = 0; textureType < NB_TEXTURE_TYPES;
+             ++textureType)
+        {
+            if (material->GetTextureCount(
+                    textureTypeMapping[textureType].aiType) > 0)
+            {
+                aiString path;
+                if (material->GetTexture(textureTypeMapping[textureType].aiType,
+                                         0, &path, nullptr, nullptr, nullptr,
+                                         nullptr, nullptr) == AI_SUCCESS)
+                {
+                    importedMaterial
+                        .textures[textureTypeMapping[textureType].type] =
+                        folder + "/" + path.data;
+                }
+            }
+        }
+
+        aiColor3D value3f(0.f, 0.f, 0.f);
+        float value1f;
+        material->Get(AI_MATKEY_COLOR_DIFFUSE, value3f);
+        importedMaterial.color =
+            brayns::Vector3f(value3f.r, value3f.g, value3f.b);
+
+        value1f = 0.f;
+        material->Get(AI_MATKEY_REFLECTIVITY, value1f);
+        importedMaterial.reflectionIndex = value1f;
+
+        value3f = aiColor3D(0.f, 0.f, 0.f);
+        material->Get(AI_MATKEY_COLOR_SPECULAR, value3f);
+        importedMaterial.specularColor =
+            brayns::Vector3f(value3f.r, value3f.g, value3f.b);
+
+        value1f = 0.f;
+        material->Get(AI_MATKEY_SHININESS, value1f);
+        importedMaterial.specularExponent =
+            fabs(value1f) < 0.01f ? 100.f : value1f;
+
+        value3f = aiColor3D(0.f, 0.f, 0.f);
+        material->Get(AI_MATKEY_COLOR_EMISSIVE, value3f);
+        importedMaterial.emission = value3f.r;
+
+        value1f = 0.f;
+        material->Get(AI_MATKEY_OPACITY, value1f);
+        importedMaterial.opacity = fabs(value1f) < 0.01f ? 1.f : value1f;
+
+        value1f = 0.f;
+        material->Get(AI_MATKEY_REFRACTI, value1f);
+        importedMaterial.refractionIndex =
+            fabs(value1f - 1.f) < 0.01f ? 1.0f : value1f;
+    }
+}
+
+bool readFile(const std::string& filename, const brayns::MeshQuality quality,
+              const bool quantize, ImportedFile& importedFile)
 {
     const boost::filesystem::path file = filename;
     Assimp::Importer importer;
@@ -57,30 +351,25 @@ bool MeshLoader::importMeshFromFile(const std::string& filename, Scene& scene,
         return false;
     }
 
-    size_t quality;
-    switch (meshQuality)
+    size_t flags;
+    switch (quality)
     {
-    case MeshQuality::medium:
-        quality = aiProcessPreset_TargetRealtime_Quality;
+    case brayns::MeshQuality::medium:
+        flags = aiProcessPreset_TargetRealtime_Quality;
         break;
-    case MeshQuality::high:
-        quality = aiProcessPreset_TargetRealtime_MaxQuality;
+    case brayns::MeshQuality::high:
+        flags = aiProcessPreset_TargetRealtime_MaxQuality;
         break;
     default:
-        quality = aiProcessPreset_TargetRealtime_Fast;
+        flags = aiProcessPreset_TargetRealtime_Fast;
         break;
     }
-
-    std::ifstream meshFile(filename, std::ios::in);
-    if (!meshFile.good())
-    {
-        BRAYNS_ERROR << "Could not open file " << filename << std::endl;
-        return false;
-    }
-    meshFile.close();
+    // Triangles are reordered for vertex locality, the cost is only paid
+    // when the cache is created
+    flags |= aiProcess_ImproveCacheLocality;
 
     const aiScene* aiScene = nullptr;
-    aiScene = importer.ReadFile(filename.c_str(), quality);
+    aiScene = importer.ReadFile(filename.c_str(), flags);
 
     if (!aiScene)
     {
@@ -96,71 +385,520 @@ bool MeshLoader::importMeshFromFile(const std::string& filename, Scene& scene,
         return false;
     }
 
-    boost::filesystem::path filepath = filename;
-    if (defaultMaterial == NO_MATERIAL)
-        _createMaterials(scene, aiScene, filepath.parent_path().string());
+    readMaterials(*aiScene, file.parent_path().string(),
+                  importedFile.materials);
 
     size_t nbVertices = 0;
     size_t nbFaces = 0;
-    auto& triangleMeshes = scene.getTriangleMeshes();
+    bool nonTriangulatedFaces = false;
+    importedFile.meshes.resize(aiScene->mNumMeshes);
     for (size_t m = 0; m < aiScene->mNumMeshes; ++m)
     {
-        aiMesh* mesh = aiScene->mMeshes[m];
-        size_t materialId = (defaultMaterial == NO_MATERIAL)
-                                ? mesh->mMaterialIndex
-                                : defaultMaterial;
+        const aiMesh& mesh = *aiScene->mMeshes[m];
+        nbVertices += mesh.mNumVertices;
+        nbFaces += mesh.mNumFaces;
+        weldMesh(mesh, quantize, importedFile.meshes[m]);
+        nonTriangulatedFaces |=
+            importedFile.meshes[m].indices.size() != mesh.mNumFaces;
+    }
+    if (nonTriangulatedFaces)
+        BRAYNS_WARN << "Some faces are not triangulated and have been removed"
+                    << std::endl;
+
+    size_t nbWeldedVertices = 0;
+    for (const auto& mesh : importedFile.meshes)
+        nbWeldedVertices += mesh.vertices.size();
+    BRAYNS_DEBUG << "Loaded " << nbVertices << " vertices and " << nbFaces
+                 << " faces, " << nbWeldedVertices
+                 << " vertices after welding" << std::endl;
+    return true;
+}
+
+/**
+ * Writes the cache file of a mesh file, see readCache for the layout. The
+ * cache only replaces an existing one once commit() succeeds, since other
+ * instances may be reading it.
+ */
+class CacheWriter
+{
+public:
+    CacheWriter(const std::string& filename)
+        : _writer(filename)
+        , _stream(_writer.getStream())
+    {
+    }
+
+    bool good() const { return _stream.good(); }
+    bool commit() { return _writer.commit(); }
+    void write(const uint64_t value) { _write(&value, sizeof(value)); }
+    template <typename T>
+    void write(const std::vector<T>& values)
+    {
+        _write(values.data(), values.size() * sizeof(T));
+    }
+
+private:
+    void _write(const void* data, const size_t size)
+    {
+        // Sections are aligned on 8 bytes so that they can be read in place
+        static const char padding[8] = {0};
+        _stream.write(static_cast<const char*>(data), size);
+        _stream.write(padding, (8 - size % 8) % 8);
+    }
+
+    brayns::AtomicFileWriter _writer;
+    std::ofstream& _stream;
+};
+
+/** Reads a mapped cache file, failing on truncated files */
+class CacheReader
+{
+public:
+    CacheReader(const brayns::MemoryMappedFile& file)
+        : _data(file.getData())
+        , _end(file.getData() + file.getSize())
+    {
+    }
+
+    bool read(uint64_t& value) { return _read(&value, sizeof(value)); }
+    template <typename T>
+    bool read(std::vector<T>& values, const size_t size)
+    {
+        // Sizes come from the file, and are checked before allocating
+        if (size > getRemainingSize() / sizeof(T))
+            return false;
+        values.resize(size);
+        return _read(values.data(), size * sizeof(T));
+    }
+    bool atEnd() const { return _data == _end; }
+    size_t getRemainingSize() const { return _end - _data; }
+
+private:
+    bool _read(void* data, const size_t size)
+    {
+        const size_t alignedSize = size + (8 - size % 8) % 8;
+        if (size_t(_end - _data) < alignedSize)
+            return false;
+        memcpy(data, _data, size);
+        _data += alignedSize;
+        return true;
+    }
+
+    const char* _data;
+    const char* _end;
+};
+
+/** @return the source file size and modification time, keying the cache */
+bool getSourceStamp(const std::string& filename, uint64_t& size,
+                    uint64_t& modificationTime)
+{
+    boost::system::error_code error;
+    size = boost::filesystem::file_size(filename, error);
+    if (error)
+        return false;
+    modificationTime = boost::filesystem::last_write_time(filename, error);
+    return !error;
+}
+
+/** The cache lives next to the mesh file, or in the temporary folder if the
+    mesh folder is read-only */
+brayns::strings getCacheFiles(const std::string& filename)
+{
+    namespace fs = boost::filesystem;
+    return {filename + CACHE_EXTENSION,
+            (fs::temp_directory_path() /
+             (std::to_string(std::hash<std::string>()(
+                  fs::absolute(filename).string())) +
+              "_" + fs::path(filename).filename().string() + CACHE_EXTENSION))
+                .string()};
+}
 
-        nbVertices += mesh->mNumVertices;
-        for (size_t i = 0; i < mesh->mNumVertices; ++i)
+/**
+ * Cache layout, all sections being aligned on 8 bytes:
+ * - magic, version, source size, source modification time, mesh quality,
+ *   quantization, number of materials and number of meshes
+ * - for each material: 11 floats (color, specular color, specular exponent,
+ *   reflection index, emission, opacity, refraction index), the number of
+ *   textures, and for each texture its type and file name
+ * - for each mesh: the material index, the number of vertices, the number of
+ *   triangles, flags telling which attributes are present, then vertices,
+ *   normals, texture coordinates, colors and indices
+ */
+enum AttributeFlags : uint64_t
+{
+    AF_NORMALS = 1,
+    AF_TEXTURE_COORDINATES = 2,
+    AF_COLORS = 4
+};
+
+bool writeCache(const std::string& cacheFile, const uint64_t sourceSize,
+                const uint64_t sourceTime, const brayns::MeshQuality quality,
+                const bool quantize, const ImportedFile& importedFile)
+{
+    CacheWriter writer(cacheFile);
+    if (!writer.good())
+        return false;
+
+    for (const uint64_t value :
+         {CACHE_MAGIC, CACHE_VERSION, sourceSize, sourceTime,
+          uint64_t(quality), uint64_t(quantize),
+          uint64_t(importedFile.materials.size()),
+          uint64_t(importedFile.meshes.size())})
+        writer.write(value);
+
+    for (const auto& material : importedFile.materials)
+    {
+        const auto& c = material.color;
+        const auto& s = material.specularColor;
+        writer.write(brayns::floats{
+            c.x(), c.y(), c.z(), s.x(), s.y(), s.z(),
+            material.specularExponent, material.reflectionIndex,
+            material.emission, material.opacity, material.refractionIndex});
+        writer.write(material.textures.size());
+        for (const auto& texture : material.textures)
         {
-            aiVector3D v = mesh->mVertices[i];
-            const Vector3f vertex = position + scale * Vector3f(v.x, v.y, v.z);
-            triangleMeshes[materialId].getVertices().push_back(vertex);
-            scene.getWorldBounds().merge(vertex);
+            writer.write(uint64_t(texture.first));
+            writer.write(texture.second.size());
+            writer.write(std::vector<char>(texture.second.begin(),
+                                           texture.second.end()));
+        }
+    }
 
-            if (mesh->HasNormals())
+    for (const auto& mesh : importedFile.meshes)
+    {
+        const size_t nbVertices = mesh.vertices.size();
+        uint64_t flags = 0;
+        if (mesh.normals.size() == nbVertices)
+            flags |= AF_NORMALS;
+        if (mesh.textureCoordinates.size() == nbVertices)
+            flags |= AF_TEXTURE_COORDINATES;
+        if (mesh.colors.size() == nbVertices)
+            flags |= AF_COLORS;
+        writer.write(mesh.materialIndex);
+        writer.write(nbVertices);
+        writer.write(mesh.indices.size());
+        writer.write(flags);
+        writer.write(mesh.vertices);
+
+        if (!quantize)
+        {
+            if (flags & AF_NORMALS)
+                writer.write(mesh.normals);
+            if (flags & AF_TEXTURE_COORDINATES)
+                writer.write(mesh.textureCoordinates);
+            if (flags & AF_COLORS)
+                writer.write(mesh.colors);
+        }
+        else
+        {
+            if (flags & AF_NORMALS)
             {
-                v = mesh->mNormals[i];
-                const Vector3f normal = {v.x, v.y, v.z};
-                triangleMeshes[materialId].getNormals().push_back(normal);
+                std::vector<int16_t> codes(2 * nbVertices);
+                for (size_t i = 0; i < nbVertices; ++i)
+                    encodeNormal(mesh.normals[i], &codes[2 * i]);
+                writer.write(codes);
             }
+            if (flags & AF_TEXTURE_COORDINATES)
+            {
+                brayns::uint16_ts codes(2 * nbVertices);
+                for (size_t i = 0; i < nbVertices; ++i)
+                    for (size_t c = 0; c < 2; ++c)
+                        codes[2 * i + c] =
+                            encodeHalf(mesh.textureCoordinates[i][c]);
+                writer.write(codes);
+            }
+            if (flags & AF_COLORS)
+            {
+                std::vector<uint8_t> codes(4 * nbVertices);
+                for (size_t i = 0; i < nbVertices; ++i)
+                    for (size_t c = 0; c < 4; ++c)
+                        codes[4 * i + c] = encodeColor(mesh.colors[i][c]);
+                writer.write(codes);
+            }
+        }
+        writer.write(mesh.indices);
+    }
+    return writer.commit();
+}
+
+bool readCache(const std::string& cacheFile, const uint64_t sourceSize,
+               const uint64_t sourceTime, const brayns::MeshQuality quality,
+               const bool quantize, ImportedFile& importedFile)
+{
+    boost::system::error_code error;
+    if (!boost::filesystem::exists(cacheFile, error))
+        return false;
+
+    brayns::MemoryMappedFile file;
+    if (!file.map(cacheFile))
+        return false;
+
+    CacheReader reader(file);
+    uint64_t header[8];
+    for (auto& value : header)
+        if (!reader.read(value))
+            return false;
+    if (header[0] != CACHE_MAGIC || header[1] != CACHE_VERSION ||
+        header[2] != sourceSize || header[3] != sourceTime ||
+        header[4] != uint64_t(quality) || header[5] != uint64_t(quantize))
+    {
+        return false;
+    }
 
-            if (mesh->HasTextureCoords(0))
+    // Each material and mesh takes at least one byte of the file
+    if (header[6] > reader.getRemainingSize() ||
+        header[7] > reader.getRemainingSize())
+    {
+        return false;
+    }
+
+    importedFile.materials.resize(header[6]);
+    for (auto& material : importedFile.materials)
+    {
+        brayns::floats values;
+        uint64_t nbTextures;
+        if (!reader.read(values, 11) || !reader.read(nbTextures))
+            return false;
+        material.color = brayns::Vector3f(values[0], values[1], values[2]);
+        material.specularColor =
+            brayns::Vector3f(values[3], values[4], values[5]);
+        material.specularExponent = values[6];
+        material.reflectionIndex = values[7];
+        material.emission = values[8];
+        material.opacity = values[9];
+        material.refractionIndex = values[10];
+        for (uint64_t i = 0; i < nbTextures; ++i)
+        {
+            uint64_t type, length;
+            std::vector<char> name;
+            if (!reader.read(type) || !reader.read(length) ||
+                !reader.read(name, length))
             {
-                v = mesh->mTextureCoords[0][i];
-                const Vector2f texCoord(v.x, -v.y);
-                triangleMeshes[materialId].getTextureCoordinates().push_back(
-                    texCoord);
+                return false;
             }
+            material.textures[brayns::TextureType(type)] =
+                std::string(name.begin(), name.end());
+        }
+    }
+
+    importedFile.meshes.resize(header[7]);
+    for (auto& mesh : importedFile.meshes)
+    {
+        uint64_t nbVertices, nbTriangles, flags;
+        if (!reader.read(mesh.materialIndex) || !reader.read(nbVertices) ||
+            !reader.read(nbTriangles) || !reader.read(flags) ||
+            !reader.read(mesh.vertices, nbVertices))
+        {
+            return false;
         }
-        bool nonTriangulatedFaces = false;
-        nbFaces += mesh->mNumFaces;
-        for (size_t f = 0; f < mesh->mNumFaces; ++f)
+
+        if (!quantize)
         {
-            if (mesh->mFaces[f].mNumIndices == 3)
+            if ((flags & AF_NORMALS) && !reader.read(mesh.normals, nbVertices))
+                return false;
+            if ((flags & AF_TEXTURE_COORDINATES) &&
+                !reader.read(mesh.textureCoordinates, nbVertices))
+                return false;
+            if ((flags & AF_COLORS) && !reader.read(mesh.colors, nbVertices))
+                return false;
+        }
+        else
+        {
+            if (flags & AF_NORMALS)
+            {
+                std::vector<int16_t> codes;
+                if (!reader.read(codes, 2 * nbVertices))
+                    return false;
+                mesh.normals.resize(nbVertices);
+                for (size_t i = 0; i < nbVertices; ++i)
+                    mesh.normals[i] = decodeNormal(&codes[2 * i]);
+            }
+            if (flags & AF_TEXTURE_COORDINATES)
             {
-                const Vector3ui ind = Vector3ui(
-                    _meshIndex[materialId] + mesh->mFaces[f].mIndices[0],
-                    _meshIndex[materialId] + mesh->mFaces[f].mIndices[1],
-                    _meshIndex[materialId] + mesh->mFaces[f].mIndices[2]);
-                triangleMeshes[materialId].getIndices().push_back(ind);
+                brayns::uint16_ts codes;
+                if (!reader.read(codes, 2 * nbVertices))
+                    return false;
+                mesh.textureCoordinates.resize(nbVertices);
+                for (size_t i = 0; i < nbVertices; ++i)
+                    mesh.textureCoordinates[i] =
+                        brayns::Vector2f(decodeHalf(codes[2 * i]),
+                                         decodeHalf(codes[2 * i + 1]));
+            }
+            if (flags & AF_COLORS)
+            {
+                std::vector<uint8_t> codes;
+                if (!reader.read(codes, 4 * nbVertices))
+                    return false;
+                mesh.colors.resize(nbVertices);
+                for (size_t i = 0; i < nbVertices; ++i)
+                    mesh.colors[i] = brayns::Vector4f(codes[4 * i] / 255.f,
+                                                      codes[4 * i + 1] / 255.f,
+                                                      codes[4 * i + 2] / 255.f,
+                                                      codes[4 * i + 3] / 255.f);
             }
-            else
-                nonTriangulatedFaces = true;
         }
-        if (nonTriangulatedFaces)
-            BRAYNS_WARN
-                << "Some faces are not triangulated and have been removed"
-                << std::endl;
+        if (!reader.read(mesh.indices, nbTriangles))
+            return false;
+    }
+    return reader.atEnd();
+}
+
+void createMaterials(brayns::Scene& scene,
+                     const std::vector<ImportedMaterial>& materials)
+{
+    BRAYNS_DEBUG << "Loading " << materials.size() << " materials"
+                 << std::endl;
+    for (size_t m = 0; m < materials.size(); ++m)
+    {
+        const ImportedMaterial& material = materials[m];
+        brayns::MaterialPtr sceneMaterial = scene.getMaterials()[m];
+        for (const auto& texture : material.textures)
+            sceneMaterial->getTextures()[texture.first] = texture.second;
+        sceneMaterial->setColor(material.color);
+        sceneMaterial->setReflectionIndex(material.reflectionIndex);
+        sceneMaterial->setSpecularColor(material.specularColor);
+        sceneMaterial->setSpecularExponent(material.specularExponent);
+        sceneMaterial->setEmission(material.emission);
+        sceneMaterial->setOpacity(material.opacity);
+        sceneMaterial->setRefractionIndex(material.refractionIndex);
+    }
+}
+
+/** Appends attributes to a mesh, completing them with a default value when
+    only the mesh or the appended vertices have them */
+template <typename T>
+void appendAttributes(std::vector<T>& attributes, const size_t nbVertices,
+                      const std::vector<T>& appended,
+                      const size_t nbAppendedVertices, const T& defaultValue)
+{
+    if (attributes.empty() && appended.empty())
+        return;
+    attributes.resize(nbVertices, defaultValue);
+    if (appended.empty())
+        attributes.resize(nbVertices + nbAppendedVertices, defaultValue);
+    else
+        attributes.insert(attributes.end(), appended.begin(), appended.end());
+}
+}
+
+namespace brayns
+{
+MeshLoader::MeshLoader(const GeometryParameters& geometryParameters)
+    : _geometryParameters(geometryParameters)
+{
+}
 
-        if (_meshIndex.find(materialId) == _meshIndex.end())
-            _meshIndex[materialId] = 0;
+bool MeshLoader::importMeshFromFile(const std::string& filename, Scene& scene,
+                                    MeshQuality meshQuality,
+                                    const Vector3f& position,
+                                    const Vector3f& scale,
+                                    const size_t defaultMaterial)
+{
+    return _importMesh(filename, scene, meshQuality, position, scale,
+                       defaultMaterial, scene.getTriangleMeshes(),
+                       scene.getWorldBounds());
+}
 
-        _meshIndex[materialId] += mesh->mNumVertices;
+bool MeshLoader::importMeshFromFile(const std::string& filename, Scene& scene,
+                                    MeshQuality meshQuality,
+                                    const Vector3f& scale,
+                                    const size_t defaultMaterial,
+                                    InstancedModel& model)
+{
+    return _importMesh(filename, scene, meshQuality, Vector3f(0.f, 0.f, 0.f),
+                       scale, defaultMaterial, model.getTriangleMeshes(),
+                       model.getBounds());
+}
+
+bool MeshLoader::_importMesh(const std::string& filename, Scene& scene,
+                             MeshQuality meshQuality, const Vector3f& position,
+                             const Vector3f& scale,
+                             const size_t defaultMaterial,
+                             TrianglesMeshMap& triangleMeshes, Boxf& bounds)
+{
+    uint64_t sourceSize;
+    uint64_t sourceTime;
+    if (!getSourceStamp(filename, sourceSize, sourceTime))
+    {
+        BRAYNS_ERROR << "Could not open file " << filename << std::endl;
+        return false;
     }
 
-    BRAYNS_DEBUG << "Loaded " << nbVertices << " vertices and " << nbFaces
-                 << " faces" << std::endl;
+    // Welded meshes are read from the cache when it matches the file and the
+    // import options, the file is otherwise imported and the cache created
+    const bool quantize = _geometryParameters.getMeshQuantization();
+    const strings cacheFiles = getCacheFiles(filename);
+    ImportedFile importedFile;
+    bool cached = false;
+    for (const auto& cacheFile : cacheFiles)
+    {
+        importedFile = ImportedFile();
+        cached = readCache(cacheFile, sourceSize, sourceTime, meshQuality,
+                           quantize, importedFile);
+        if (cached)
+        {
+            BRAYNS_DEBUG << "Loaded " << filename << " from " << cacheFile
+                         << std::endl;
+            break;
+        }
+    }
+
+    if (!cached)
+    {
+        importedFile = ImportedFile();
+        if (!readFile(filename, meshQuality, quantize, importedFile))
+            return false;
+
+        bool saved = false;
+        for (const auto& cacheFile : cacheFiles)
+            if (writeCache(cacheFile, sourceSize, sourceTime, meshQuality,
+                           quantize, importedFile))
+            {
+                saved = true;
+                break;
+            }
+        if (!saved)
+            BRAYNS_WARN << "Could not create mesh cache for " << filename
+                        << std::endl;
+    }
+
+    if (defaultMaterial == NO_MATERIAL)
+        createMaterials(scene, importedFile.materials);
+
+    for (const auto& mesh : importedFile.meshes)
+    {
+        const size_t materialId = (defaultMaterial == NO_MATERIAL)
+                                      ? mesh.materialIndex
+                                      : defaultMaterial;
+        auto& trianglesMesh = triangleMeshes[materialId];
+        auto& vertices = trianglesMesh.getVertices();
+        const size_t nbVertices = vertices.size();
+        const size_t nbAppendedVertices = mesh.vertices.size();
+
+        vertices.reserve(nbVertices + nbAppendedVertices);
+        for (const auto& v : mesh.vertices)
+        {
+            const Vector3f vertex = position + scale * v;
+            vertices.push_back(vertex);
+            bounds.merge(vertex);
+        }
+        appendAttributes(trianglesMesh.getNormals(), nbVertices, mesh.normals,
+                         nbAppendedVertices, Vector3f(0.f, 0.f, 1.f));
+        appendAttributes(trianglesMesh.getTextureCoordinates(), nbVertices,
+                         mesh.textureCoordinates, nbAppendedVertices,
+                         Vector2f(0.f, 0.f));
+        appendAttributes(trianglesMesh.getColors(), nbVertices, mesh.colors,
+                         nbAppendedVertices, Vector4f(1.f, 1.f, 1.f, 1.f));
+
+        // Indices are relative to the vertices already held by the mesh,
+        // whichever loader added them
+        auto& indices = trianglesMesh.getIndices();
+        indices.reserve(indices.size() + mesh.indices.size());
+        for (const auto& triangle : mesh.indices)
+            indices.push_back(Vector3ui(nbVertices + triangle.x(),
+                                        nbVertices + triangle.y(),
+                                        nbVertices + triangle.z()));
+    }
 
     return true;
 }
@@ -239,81 +977,4 @@ bool MeshLoader::exportMeshToFile(const std::string& filename,
     return true;
 }
 
-void MeshLoader::_createMaterials(Scene& scene, const aiScene* aiScene,
-                                  const std::string& folder)
-{
-    BRAYNS_DEBUG << "Loading " << aiScene->mNumMaterials << " materials"
-                 << std::endl;
-    for (size_t m = 0; m < aiScene->mNumMaterials; ++m)
-    {
-        aiMaterial* material = aiScene->mMaterials[m];
-
-        struct TextureTypeMapping
-        {
-            aiTextureType aiType;
-            TextureType type;
-        };
-
-        const size_t NB_TEXTURE_TYPES = 6;
-        TextureTypeMapping textureTypeMapping[NB_TEXTURE_TYPES] = {
-            {aiTextureType_DIFFUSE, TT_DIFFUSE},
-            {aiTextureType_NORMALS, TT_NORMALS},
-            {aiTextureType_SPECULAR, TT_SPECULAR},
-            {aiTextureType_EMISSIVE, TT_EMISSIVE},
-            {aiTextureType_OPACITY, TT_OPACITY},
-            {aiTextureType_REFLECTION, TT_REFLECTION}};
-
-        for (size_t textureType = 0; textureType < NB_TEXTURE_TYPES;
-             ++textureType)
-        {
-            if (material->GetTextureCount(
-                    textureTypeMapping[textureType].aiType) > 0)
-            {
-                aiString path;
-                if (material->GetTexture(textureTypeMapping[textureType].aiType,
-                                         0, &path, nullptr, nullptr, nullptr,
-                                         nullptr, nullptr) == AI_SUCCESS)
-                {
-                    scene.getMaterials()[m]
-                        ->getTextures()[textureTypeMapping[textureType].type] =
-                        folder + "/" + path.data;
-                }
-            }
-        }
-
-        aiColor3D value3f(0.f, 0.f, 0.f);
-        float value1f;
-        material->Get(AI_MATKEY_COLOR_DIFFUSE, value3f);
-        scene.getMaterials()[m]->setColor(
-            Vector3f(value3f.r, value3f.g, value3f.b));
-
-        value1f = 0.f;
-        material->Get(AI_MATKEY_REFLECTIVITY, value1f);
-        scene.getMaterials()[m]->setReflectionIndex(value1f);
-
-        value3f = aiColor3D(0.f, 0.f, 0.f);
-        material->Get(AI_MATKEY_COLOR_SPECULAR, value3f);
-        scene.getMaterials()[m]->setSpecularColor(
-            Vector3f(value3f.r, value3f.g, value3f.b));
-
-        value1f = 0.f;
-        material->Get(AI_MATKEY_SHININESS, value1f);
-        scene.getMaterials()[m]->setSpecularExponent(
-            fabs(value1f) < 0.01f ? 100.f : value1f);
-
-        value3f = aiColor3D(0.f, 0.f, 0.f);
-        material->Get(AI_MATKEY_COLOR_EMISSIVE, value3f);
-        scene.getMaterials()[m]->setEmission(value3f.r);
-
-        value1f = 0.f;
-        material->Get(AI_MATKEY_OPACITY, value1f);
-        scene.getMaterials()[m]->setOpacity(fabs(value1f) < 0.01f ? 1.f
-                                                                  : value1f);
-
-        value1f = 0.f;
-        material->Get(AI_MATKEY_REFRACTI, value1f);
-        scene.getMaterials()[m]->setRefractionIndex(
-            fabs(value1f - 1.f) < 0.01f ? 1.0f : value1f);
-    }
-}
 }
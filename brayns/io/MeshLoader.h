@@ -29,8 +29,6 @@
 
 #include <string>
 
-class aiScene;
-
 namespace brayns
 {
 /** Loads meshes from files using the assimp library
@@ -39,7 +37,7 @@ namespace brayns
 class MeshLoader
 {
 public:
-    MeshLoader();
+    MeshLoader(const GeometryParameters& geometryParameters);
 
     /** Imports meshes from a given file
      *
@@ -60,6 +58,23 @@ public:
                             const Vector3f& scale,
                             const size_t defaultMaterial);
 
+    /** Imports meshes from a given file into an instanced model, in the
+     * model space. The model is then placed in the scene by its instances.
+     *
+     * @param filename name of the file containing the meshes
+     * @param Scene holding the materials
+     * @param meshQuality can be MQ_FAST, MQ_QUALITY or MQ_MAX_QUALITY
+     * @param scale how to scale the imported mesh
+     * @param defaultMaterial Default material for the whole mesh, or
+     *        NO_MATERIAL to use materials from the mesh file
+     * @param model Resulting model
+     * @return true if the file was successfully imported. False otherwise.
+     */
+    bool importMeshFromFile(const std::string& filename, Scene& scene,
+                            MeshQuality meshQuality, const Vector3f& scale,
+                            const size_t defaultMaterial,
+                            InstancedModel& model);
+
     /** Exports meshes to a given file
      *
      * @param filename destination file name
@@ -67,16 +82,13 @@ public:
      */
     bool exportMeshToFile(const std::string& filename, Scene& scene) const;
 
-    /**
-     * @brief Clear all internal buffers
-     */
-    void clear();
-
 private:
-    void _createMaterials(Scene& scene, const aiScene* aiScene,
-                          const std::string& folder);
+    bool _importMesh(const std::string& filename, Scene& scene,
+                     MeshQuality meshQuality, const Vector3f& position,
+                     const Vector3f& scale, const size_t defaultMaterial,
+                     TrianglesMeshMap& triangleMeshes, Boxf& bounds);
 
-    std::map<size_t, size_t> _meshIndex;
+    const GeometryParameters& _geometryParameters;
 };
 }
 
@@ -26,6 +26,18 @@
 #include <brayns/io/ProteinLoader.h>
 #include <fstream>
 
+namespace
+{
+brayns::Matrix4f getTranslation(const brayns::Vector3f& position)
+{
+    brayns::Matrix4f transformation = brayns::Matrix4f::IDENTITY;
+    transformation(0, 3) = position.x();
+    transformation(1, 3) = position.y();
+    transformation(2, 3) = position.z();
+    return transformation;
+}
+}
+
 namespace brayns
 {
 MolecularSystemReader::MolecularSystemReader(
@@ -78,49 +90,62 @@ bool MolecularSystemReader::_createScene(Scene& scene, MeshLoader& meshLoader)
         break;
     }
 
+    // Every protein is built once as an instanced model, and placed in the
+    // scene by one instance per position
+    ProteinLoader loader(_geometryParameters);
+    const size_t nbMaterials = scene.getMaterials().size();
+    const bool byId =
+        _geometryParameters.getColorScheme() == ColorScheme::protein_by_id;
     uint64_t proteinCount = 0;
+    size_t proteinIndex = 0;
     for (const auto& proteinPosition : _proteinPositions)
     {
         BRAYNS_PROGRESS(proteinCount, _nbProteins);
 
         const auto& protein = _proteins.find(proteinPosition.first);
+        const auto& positions = proteinPosition.second;
         if (!_proteinFolder.empty())
+        {
             // Load PDB files
-            for (const auto& position : proteinPosition.second)
-            {
-                const auto pdbFilename =
-                    _proteinFolder + '/' + protein->second + ".pdb";
-                ProteinLoader loader(_geometryParameters);
-                loader.importPDBFile(pdbFilename, position, proteinCount,
-                                     scene);
-                ++proteinCount;
-            }
+            const auto pdbFilename =
+                _proteinFolder + '/' + protein->second + ".pdb";
+            auto& model = scene.getInstancedModel(pdbFilename);
+            if (model.getSpheres().empty() &&
+                !loader.importPDBFile(pdbFilename, proteinIndex, nbMaterials,
+                                      model))
+                scene.getInstancedModels().erase(pdbFilename);
+            else
+                for (const auto& position : positions)
+                    scene.addInstance(pdbFilename, getTranslation(position));
+            proteinCount += positions.size();
+        }
 
         if (!_meshFolder.empty())
+        {
             // Load meshes
-            for (const auto& position : proteinPosition.second)
-            {
-                const auto objFilename =
-                    _meshFolder + '/' + protein->second + ".obj";
-                const size_t material =
-                    _geometryParameters.getColorScheme() ==
-                            ColorScheme::protein_by_id
-                        ? proteinCount %
-                              (NB_MAX_MATERIALS - NB_SYSTEM_MATERIALS)
-                        : NO_MATERIAL;
+            const auto objFilename =
+                _meshFolder + '/' + protein->second + ".obj";
+            const size_t material =
+                byId ? proteinIndex % (NB_MAX_MATERIALS - NB_SYSTEM_MATERIALS)
+                     : NO_MATERIAL;
 
-                // Scale mesh to match PDB units. PDB are in angstrom, and
-                // positions are
-                // in micrometers
-                const float scale = 0.0001f;
-                meshLoader.importMeshFromFile(objFilename, scene, quality,
-                                              position,
-                                              Vector3f(scale, scale, scale),
-                                              material);
+            // Scale mesh to match PDB units. PDB are in angstrom, and
+            // positions are in micrometers
+            const float scale = 0.0001f;
+            auto& model = scene.getInstancedModel(objFilename);
+            if (model.getTriangleMeshes().empty() &&
+                !meshLoader.importMeshFromFile(objFilename, scene, quality,
+                                               Vector3f(scale, scale, scale),
+                                               material, model))
+                scene.getInstancedModels().erase(objFilename);
+            else
+                for (const auto& position : positions)
+                    scene.addInstance(objFilename, getTranslation(position));
 
-                if (_proteinFolder.empty())
-                    ++proteinCount;
-            }
+            if (_proteinFolder.empty())
+                proteinCount += positions.size();
+        }
+        ++proteinIndex;
     }
 
     // Update materials
@@ -129,7 +154,6 @@ bool MolecularSystemReader::_createScene(Scene& scene, MeshLoader& meshLoader)
         size_t index = 0;
         for (const auto& material : scene.getMaterials())
         {
-            ProteinLoader loader(_geometryParameters);
             material.second->setColor(loader.getMaterialKd(index));
             ++index;
         }
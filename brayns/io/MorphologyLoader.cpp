@@ -170,16 +170,17 @@ bool MorphologyLoader::importMorphology(const servus::URI& uri,
     }
     float maxDistanceToSoma;
     returnValue = returnValue &&
-                  _importMorphology(uri, morphologyIndex, Matrix4f(), nullptr,
-                                    scene.getSpheres(), scene.getCylinders(),
-                                    scene.getCones(), scene.getWorldBounds(), 0,
+                  _importMorphology(uri, morphologyIndex, 0, Matrix4f(),
+                                    nullptr, scene.getSpheres(),
+                                    scene.getCylinders(), scene.getCones(),
+                                    scene.getWorldBounds(), 0,
                                     maxDistanceToSoma);
     return returnValue;
 }
 
 bool MorphologyLoader::_importMorphology(
     const servus::URI& source, const size_t morphologyIndex,
-    const Matrix4f& transformation,
+    const uint32_t gid, const Matrix4f& transformation,
     const SimulationInformation* simulationInformation, SpheresMap& spheres,
     CylindersMap& cylinders, ConesMap& cones, Boxf& bounds,
     const size_t simulationOffset, float& maxDistanceToSoma)
@@ -246,6 +247,7 @@ bool MorphologyLoader::_importMorphology(
                            _geometryParameters.getRadiusMultiplier());
             spheres[material].push_back(
                 SpherePtr(new Sphere(material, center, radius, 0.f, offset)));
+            spheres[material].back()->setCellSection(gid, 0);
             bounds.merge(center);
         }
 
@@ -325,21 +327,33 @@ bool MorphologyLoader::_importMorphology(
                                _geometryParameters.getRadiusMultiplier());
 
                 if (radius > 0.f)
+                {
                     spheres[material].push_back(
                         SpherePtr(new Sphere(material, position, radius,
                                              distance, offset)));
+                    spheres[material].back()->setCellSection(gid,
+                                                             section.getID());
+                }
 
                 bounds.merge(position);
                 if (position != target && radius > 0.f && previousRadius > 0.f)
                 {
                     if (radius == previousRadius)
+                    {
                         cylinders[material].push_back(CylinderPtr(
                             new Cylinder(material, position, target, radius,
                                          distance, offset)));
+                        cylinders[material].back()->setCellSection(
+                            gid, section.getID());
+                    }
                     else
+                    {
                         cones[material].push_back(ConePtr(
                             new Cone(material, position, target, radius,
                                      previousRadius, distance, offset)));
+                        cones[material].back()->setCellSection(
+                            gid, section.getID());
+                    }
                     bounds.merge(target);
                 }
                 previousSample = sample;
@@ -356,7 +370,8 @@ bool MorphologyLoader::_importMorphology(
 }
 
 bool MorphologyLoader::importCircuit(const servus::URI& circuitConfig,
-                                     const std::string& target, Scene& scene)
+                                     const std::string& target, Scene& scene,
+                                     const LoadingCallback& batchLoaded)
 {
     const std::string& filename = circuitConfig.getPath();
     const brion::BlueConfig bc(filename);
@@ -369,6 +384,7 @@ bool MorphologyLoader::importCircuit(const servus::URI& circuitConfig,
         return false;
     }
     const Matrix4fs& transforms = circuit.getTransforms(gids);
+    const uint32_ts cellGids(gids.begin(), gids.end());
 
     const brain::URIs& uris = circuit.getMorphologyURIs(gids);
 
@@ -379,70 +395,84 @@ bool MorphologyLoader::importCircuit(const servus::URI& circuitConfig,
     size_t simulationOffset = 1;
     size_t simulatedCells = 0;
     size_t progress = 0;
-#pragma omp parallel
+
+    // Without callback, all cells are loaded in a single batch
+    size_t batchSize = uris.size();
+    if (batchLoaded && _geometryParameters.getLoadingBatchSize() != 0)
+        batchSize = _geometryParameters.getLoadingBatchSize();
+
+    for (size_t first = 0; first < uris.size(); first += batchSize)
     {
-        SpheresMap private_spheres;
-        CylindersMap private_cylinders;
-        ConesMap private_cones;
-        Boxf private_bounds;
-#pragma omp for nowait
-        for (size_t i = 0; i < uris.size(); ++i)
+        const size_t last = std::min(first + batchSize, uris.size());
+#pragma omp parallel
         {
-            const auto& uri = uris[i];
-            float maxDistanceToSoma = 0.f;
-
-            if (_geometryParameters.useMetaballs())
+            SpheresMap private_spheres;
+            CylindersMap private_cylinders;
+            ConesMap private_cones;
+            Boxf private_bounds;
+#pragma omp for nowait
+            for (size_t i = first; i < last; ++i)
             {
-                _importMorphologyAsMesh(uri, i, scene.getMaterials(),
-                                        transforms[i],
-                                        scene.getTriangleMeshes(),
-                                        scene.getWorldBounds());
-            }
+                const auto& uri = uris[i];
+                float maxDistanceToSoma = 0.f;
 
-            if (_importMorphology(uri, i, transforms[i], 0, private_spheres,
-                                  private_cylinders, private_cones,
-                                  private_bounds, simulationOffset,
-                                  maxDistanceToSoma))
-            {
-                morphologyOffsets[simulatedCells] = maxDistanceToSoma;
-                simulationOffset += maxDistanceToSoma;
-            }
+                if (_geometryParameters.useMetaballs())
+                {
+                    _importMorphologyAsMesh(uri, i, scene.getMaterials(),
+                                            transforms[i],
+                                            scene.getTriangleMeshes(),
+                                            scene.getWorldBounds());
+                }
 
-            BRAYNS_PROGRESS(progress, uris.size());
+                if (_importMorphology(uri, i, cellGids[i], transforms[i], 0,
+                                      private_spheres, private_cylinders,
+                                      private_cones, private_bounds,
+                                      simulationOffset, maxDistanceToSoma))
+                {
+                    morphologyOffsets[simulatedCells] = maxDistanceToSoma;
+                    simulationOffset += maxDistanceToSoma;
+                }
+
+                BRAYNS_PROGRESS(progress, uris.size());
 #pragma omp atomic
-            ++progress;
-        }
+                ++progress;
+            }
 
 #pragma omp critical
-        for (const auto& p : private_spheres)
-        {
-            const size_t material = p.first;
-            scene.getSpheres()[material].insert(
-                scene.getSpheres()[material].end(),
-                private_spheres[material].begin(),
-                private_spheres[material].end());
-        }
+            for (const auto& p : private_spheres)
+            {
+                const size_t material = p.first;
+                scene.getSpheres()[material].insert(
+                    scene.getSpheres()[material].end(),
+                    private_spheres[material].begin(),
+                    private_spheres[material].end());
+            }
 
 #pragma omp critical
-        for (const auto& p : private_cylinders)
-        {
-            const size_t material = p.first;
-            scene.getCylinders()[material].insert(
-                scene.getCylinders()[material].end(),
-                private_cylinders[material].begin(),
-                private_cylinders[material].end());
-        }
+            for (const auto& p : private_cylinders)
+            {
+                const size_t material = p.first;
+                scene.getCylinders()[material].insert(
+                    scene.getCylinders()[material].end(),
+                    private_cylinders[material].begin(),
+                    private_cylinders[material].end());
+            }
 
 #pragma omp critical
-        for (const auto& p : private_cones)
-        {
-            const size_t material = p.first;
-            scene.getCones()[material].insert(scene.getCones()[material].end(),
-                                              private_cones[material].begin(),
-                                              private_cones[material].end());
+            for (const auto& p : private_cones)
+            {
+                const size_t material = p.first;
+                scene.getCones()[material].insert(
+                    scene.getCones()[material].end(),
+                    private_cones[material].begin(),
+                    private_cones[material].end());
+            }
+
+            scene.getWorldBounds().merge(private_bounds);
         }
 
-        scene.getWorldBounds().merge(private_bounds);
+        if (batchLoaded)
+            batchLoaded(last, uris.size());
     }
 
     return true;
@@ -479,6 +509,7 @@ bool MorphologyLoader::importCircuit(const servus::URI& circuitConfig,
 
     brain::URIs cr_uris;
     const brain::GIDSet& cr_gids = compartmentReport.getGIDs();
+    const uint32_ts simulatedGids(cr_gids.begin(), cr_gids.end());
 
     BRAYNS_INFO << "Loading " << cr_gids.size() << " simulated cells"
                 << std::endl;
@@ -512,9 +543,10 @@ bool MorphologyLoader::importCircuit(const servus::URI& circuitConfig,
             }
 
             float maxDistanceToSoma;
-            _importMorphology(uri, i, transforms[i], &simulationInformation,
-                              private_spheres, private_cylinders, private_cones,
-                              private_bounds, 0, maxDistanceToSoma);
+            _importMorphology(uri, i, simulatedGids[i], transforms[i],
+                              &simulationInformation, private_spheres,
+                              private_cylinders, private_cones, private_bounds,
+                              0, maxDistanceToSoma);
 
             BRAYNS_PROGRESS(progress, cr_uris.size());
 #pragma omp atomic
@@ -560,6 +592,7 @@ bool MorphologyLoader::importCircuit(const servus::URI& circuitConfig,
         const brain::GIDSet& allGids = circuit.getGIDs();
         const brain::URIs& allUris = circuit.getMorphologyURIs(allGids);
         const Matrix4fs& allTransforms = circuit.getTransforms(allGids);
+        const uint32_ts allCellGids(allGids.begin(), allGids.end());
 
         cr_uris.clear();
         size_t index = 0;
@@ -590,9 +623,10 @@ bool MorphologyLoader::importCircuit(const servus::URI& circuitConfig,
                 float maxDistanceToSoma;
                 const auto& uri = allUris[i];
 
-                _importMorphology(uri, i, allTransforms[i], 0, private_spheres,
-                                  private_cylinders, private_cones,
-                                  private_bounds, 0, maxDistanceToSoma);
+                _importMorphology(uri, i, allCellGids[i], allTransforms[i], 0,
+                                  private_spheres, private_cylinders,
+                                  private_cones, private_bounds, 0,
+                                  maxDistanceToSoma);
 
                 BRAYNS_PROGRESS(progress, allUris.size());
 #pragma omp atomic
@@ -724,7 +758,7 @@ bool MorphologyLoader::importMorphology(const servus::URI&, const int, Scene&)
 }
 
 bool MorphologyLoader::importCircuit(const servus::URI&, const std::string&,
-                                     Scene&)
+                                     Scene&, const LoadingCallback&)
 {
     BRAYNS_ERROR << "Brion is required to load circuits" << std::endl;
     return false;
@@ -87,11 +87,15 @@ public:
      *        circuit configuration file is used. If such an entry does not
      *        exist, all neurons are loaded.
      * @param scene resulting scene
+     * @param batchLoaded if set, cells are loaded in batches of the loading
+     *        batch size of the geometry parameters, and the function is called
+     *        once the geometry of each batch has been added to the scene
      * @return True if the circuit is successfully loaded, false if the circuit
      *         contains no cells.
      */
     bool importCircuit(const servus::URI& circuitConfig,
-                       const std::string& target, Scene& scene);
+                       const std::string& target, Scene& scene,
+                       const LoadingCallback& batchLoaded = LoadingCallback());
 
     /** Imports simulation data into the scene
      * @param circuitConfig URI of the Circuit Config file
@@ -109,7 +113,7 @@ public:
 
 private:
     bool _importMorphology(const servus::URI& source, size_t morphologyIndex,
-                           const Matrix4f& transformation,
+                           uint32_t gid, const Matrix4f& transformation,
                            const SimulationInformation* simulationInformation,
                            SpheresMap& spheres, CylindersMap& cylinders,
                            ConesMap& cones, Boxf& bounds,
@@ -24,11 +24,13 @@
 #include <brayns/common/log.h>
 #include <brayns/common/simulation/SpikeSimulationHandler.h>
 #include <brayns/common/types.h>
+#include <brayns/common/utils/MemoryMappedFile.h>
 
 #ifdef BRAYNS_USE_BRION
 #include <H5Cpp.h>
 #endif
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 
 namespace
@@ -141,34 +143,36 @@ bool NESTLoader::importSpikeReport(const std::string& filename, Scene& scene)
         return false;
     }
 
-    const uint64_t nbFrames = (_spikesEnd - _spikesStart) / NEST_TIMESTEP;
-    _spikingTimes.resize(_frameSize, -1.f);
+    // The last frame holds the last spike
+    const uint64_t nbFrames =
+        uint64_t((_spikesEnd - _spikesStart) / NEST_TIMESTEP) + 1;
 
-    BRAYNS_INFO << "Cache file does not exist, creating it" << std::endl;
-    std::ofstream file(cacheFile, std::ios::out | std::ios::binary);
-
-    if (!file.is_open())
+    // Spike times are converted to frames, the unit of the timestamp used by
+    // the renderer
+    SpikeEvents events;
+    events.reserve(_spikes.size());
+    for (const auto& spike : _spikes)
     {
-        BRAYNS_ERROR << "Failed to create cache file" << std::endl;
-        return false;
+        const uint64_t gid = uint64_t(spike.gid) - NEST_OFFSET;
+        if (gid < _frameSize)
+            events.push_back(
+                {(spike.time - _spikesStart) / NEST_TIMESTEP, uint32_t(gid)});
     }
+    std::vector<Spike>().swap(_spikes);
 
-    // Write header
+    BRAYNS_INFO << "Cache file does not exist, creating it" << std::endl;
     simulationHandler->setNbFrames(nbFrames);
     simulationHandler->setFrameSize(_frameSize);
-    simulationHandler->writeHeader(file);
-
-    BRAYNS_INFO << "Spike report contains " << nbFrames << " frames of "
-                << _frameSize << " values each" << std::endl;
-
-    // Write body
-    for (float timestamp = _spikesStart; timestamp < _spikesEnd;
-         timestamp += NEST_TIMESTEP)
+    if (!simulationHandler->writeCacheFile(cacheFile, events) ||
+        !simulationHandler->attachSimulationToCacheFile(cacheFile))
     {
-        _load(timestamp);
-        simulationHandler->writeFrame(file, _spikingTimes);
+        BRAYNS_ERROR << "Failed to create cache file" << std::endl;
+        return false;
     }
-    file.close();
+
+    BRAYNS_INFO << "Spike report contains " << nbFrames << " frames and "
+                << events.size() << " spikes for " << _frameSize << " neurons"
+                << std::endl;
 
     scene.setSimulationHandler(simulationHandler);
 
@@ -181,109 +185,50 @@ bool NESTLoader::importSpikeReport(const std::string& filename, Scene& scene)
 
 bool NESTLoader::_loadBinarySpikes(const std::string& spikesFilename)
 {
-    std::ifstream file(spikesFilename, std::ios::out | std::ios::binary);
-    file.seekg(0, std::ios::end);
-    const size_t fileSize = file.tellg();
-    file.seekg(0);
-
-    _nbElements =
-        (fileSize - NEST_HEADER_SIZE) / (sizeof(uint32_t) + sizeof(float));
-    BRAYNS_INFO << "Loading " << _nbElements << " spikes from "
-                << spikesFilename << std::endl;
+    MemoryMappedFile file;
+    if (!file.map(spikesFilename) || file.getSize() < NEST_HEADER_SIZE)
+        return false;
 
     // Parse header
+    const char* data = file.getData();
     uint32_t magic;
-    file.read((char*)&magic, sizeof(uint32_t));
-
+    memcpy(&magic, data, sizeof(uint32_t));
     if (NEST_MAGIC != magic)
         return false;
 
     uint32_t version;
-    file.read((char*)&version, sizeof(uint32_t));
+    memcpy(&version, data + sizeof(uint32_t), sizeof(uint32_t));
     if (NEST_VERSION != version)
         return false;
 
-    // Parse elements
-    uint32_t gid;
-    float value;
-    _values.reserve(_nbElements);
-    _gids.reserve(_nbElements);
-    size_t i = 0;
-    while (!file.eof())
-    {
-        BRAYNS_PROGRESS(i, _nbElements);
-        file.read((char*)&value, sizeof(float));
-        _values.push_back(value);
-        file.read((char*)&gid, sizeof(uint32_t));
-        _gids.push_back(gid);
-        ++i;
-    }
+    // Spikes are stored as (time, gid) pairs, the layout of Spike
+    static_assert(sizeof(Spike) == sizeof(float) + sizeof(uint32_t),
+                  "Spike must match the layout of the spike file");
+    const uint64_t nbSpikes =
+        (file.getSize() - NEST_HEADER_SIZE) / sizeof(Spike);
+    BRAYNS_INFO << "Loading " << nbSpikes << " spikes from " << spikesFilename
+                << std::endl;
+    if (nbSpikes == 0)
+        return false;
 
-    _spikesStart = _values[0];             // First spike timestamp after header
-    _spikesEnd = _values[_nbElements - 1]; // Last spike timestamp
+    _spikes.resize(nbSpikes);
+    memcpy(_spikes.data(), data + NEST_HEADER_SIZE, nbSpikes * sizeof(Spike));
+    file.unmap();
+
+    const auto byTime = [](const Spike& a, const Spike& b) {
+        return a.time < b.time;
+    };
+    if (!std::is_sorted(_spikes.begin(), _spikes.end(), byTime))
+        std::stable_sort(_spikes.begin(), _spikes.end(), byTime);
+
+    _spikesStart = _spikes.front().time;
+    _spikesEnd = _spikes.back().time;
 
-    BRAYNS_INFO << "Loaded " << i << " elements out of " << _nbElements
-                << std::endl;
     BRAYNS_INFO << "Spikes interval: [" << _spikesStart << " - " << _spikesEnd
                 << "]" << std::endl;
-
-    file.close();
     return true;
 }
 
-bool NESTLoader::_load(const float timestamp)
-{
-    const float start = timestamp;
-    const float end = timestamp + NEST_TIMESTEP;
-
-    BRAYNS_DEBUG << "Loading spikes at timestamp: " << timestamp << " ("
-                 << start << " ms)" << std::endl;
-
-    char filename[1024];
-    sprintf(
-        filename,
-        "/home/favreau/medias/volumes/spikes/10pct/events/spikes_%05d.events",
-        int(timestamp * 10));
-    std::ofstream myFile(filename, std::ios::out | std::ios::binary);
-    size_t nbSpikes = 0;
-    for (size_t i = 0; i < _nbElements; ++i)
-    {
-        const float time = _values[i];
-        // Whith the next check, simulation only plays forward because the value
-        // that is stored
-        // is the last time the spike occured for this neuron.
-        if (time < start)
-            continue;
-
-        if (time >= end)
-            break;
-
-        const uint32_t gid = _gids[i] - NEST_OFFSET;
-
-        // We store the frame on which the spike happens, as the renderer keeps
-        // track of the current timestamp
-        _spikingTimes[gid] = time;
-
-        const Vector3f& position = _positions[gid];
-        float value;
-        value = position.x();
-        myFile.write((char*)&value, sizeof(float));
-        value = position.y();
-        myFile.write((char*)&value, sizeof(float));
-        value = position.z();
-        myFile.write((char*)&value, sizeof(float));
-        value = 1.f;
-        myFile.write((char*)&value, sizeof(float));
-        myFile.write((char*)&value, sizeof(float));
-
-        ++nbSpikes;
-    }
-    myFile.close();
-    BRAYNS_INFO << "Nb Spikes for timestamp " << timestamp << " [" << start
-                << "-" << end << "]: " << nbSpikes << std::endl;
-
-    return true;
-}
 #else
 void NESTLoader::importCircuit(const std::string&, Scene&, size_t&)
 {
@@ -302,11 +247,5 @@ bool NESTLoader::_loadBinarySpikes(const std::string&)
     return false;
 }
 
-bool NESTLoader::_load(const float)
-{
-    BRAYNS_ERROR << "Brion is required to load circuits" << std::endl;
-    return false;
-}
-
 #endif
 }
@@ -30,25 +30,13 @@
 
 namespace brayns
 {
-/** Loads a NEST circuit from file and stores it into a cache file containing
- * the activation
- * timestamp for every GUID of every frame. The cache file full path is
- * specified by the
- * --nest-cache-file command line parameter. If the cache file does not exist,
- * it is created and
- * populated by the import process. The format of the cache file is a array of
- * float values
- * representing the activation timestamp by GUID. GUID are ordered in the same
- * way as they are
- * read from the original NEST circuit. All frames of the simulation are stored
- * one after the other.
- * The cache file contains a header of two uint64_t. The first one is the number
- * of frame, and the
- * second one is the frame size (the number of floats per frame). The cache file
- * is handled bu the
- * SpikeSimulationHandler class.
- * Note that in the current implementation, the simulation can only be played
- * forward.
+/** Loads a NEST circuit from file and stores its spikes into a cache file.
+ * The cache file full path is specified by the --nest-cache-file command line
+ * parameter. If the cache file does not exist, it is created and populated by
+ * the import process. The cache file holds the spikes as sparse events sorted
+ * by time, GUID are ordered in the same way as they are read from the
+ * original NEST circuit. The format of the cache file is defined, and the
+ * file is handled, by the SpikeSimulationHandler class.
  * @todo Move this loaded to Brion
  */
 class NESTLoader
@@ -74,10 +62,8 @@ public:
      * Imports a spike report into the memory mapped cache file that will be
      * attached to the
      * specified scene at the end of the loading. If the cache file does not
-     * exists, it is created.
-     * The cache file contains the timestamp for the spike activation, for every
-     * neuron, and for
-     * every frame.
+     * exists, or is not a valid spike cache, it is created.
+     * The cache file contains the spikes of all neurons, sorted by time.
      * @param filename File containing the report
      * @param scene Scene to which the simulation should be attached
      * @return True if report was successfully imported, false otherwise
@@ -85,15 +71,20 @@ public:
     bool importSpikeReport(const std::string& filename, Scene& scene);
 
 private:
+    /** Spike as stored in a binary NEST spike file */
+    struct Spike
+    {
+        float time;
+        uint32_t gid;
+    };
+
     bool _loadBinarySpikes(const std::string& spikesFilename);
-    bool _load(const float timestamp);
 
     const GeometryParameters& _geometryParameters;
-    floats _values;
-    uint32_ts _gids;
     uint64_t _frameSize;
-    uint32_t _nbElements;
-    floats _spikingTimes;
+
+    /** All spikes, sorted by time */
+    std::vector<Spike> _spikes;
     float _spikesStart;
     float _spikesEnd;
 
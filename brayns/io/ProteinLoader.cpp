@@ -24,9 +24,13 @@
 #include <brayns/common/log.h>
 #include <brayns/common/scene/Scene.h>
 #include <brayns/common/types.h>
+#include <brayns/common/utils/MemoryMappedFile.h>
 
-#include <assert.h>
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 
 namespace brayns
 {
@@ -39,20 +43,6 @@ struct PDBCellPositions
     Vector3f unknown;
 };
 
-/** Structure defining an atom as it is stored in a PDB file
- */
-struct Atom
-{
-    int processed;
-    int id;
-    int index;
-    Vector3f position;
-    float radius;
-    int materialId;
-    int chainId;
-    int residue;
-};
-
 /** Structure defining an atom radius in microns
  */
 struct AtomicRadius
@@ -305,6 +295,118 @@ static AtomicRadius atomic_radii[colorMapSize] = // atomic radii in microns
      {"OXT", 25.f, 112},
      {"P", 25.f, 113}};
 
+namespace
+{
+const size_t BYTES_PER_CHUNK = 1 << 22;
+const size_t ATOMS_PER_CHUNK = 1 << 16;
+
+/**
+ * Element symbols have at most two letters, which makes it possible to give
+ * each of them its own slot in a lookup table: the key is a collision free
+ * (perfect) hash of the case insensitive symbol. The empty symbol maps to 0.
+ */
+const size_t NB_LETTERS = 27;
+const size_t NB_ELEMENT_KEYS = NB_LETTERS * NB_LETTERS;
+const size_t INVALID_ELEMENT_KEY = NB_ELEMENT_KEYS;
+
+size_t getElementKey(const char* symbol, const size_t length)
+{
+    if (length > 2)
+        return INVALID_ELEMENT_KEY;
+    size_t key = 0;
+    for (size_t i = 0; i < 2; ++i)
+    {
+        size_t letter = 0;
+        if (i < length)
+        {
+            const char c = std::toupper(static_cast<unsigned char>(symbol[i]));
+            if (c < 'A' || c > 'Z')
+                return INVALID_ELEMENT_KEY;
+            letter = c - 'A' + 1;
+        }
+        key = key * NB_LETTERS + letter;
+    }
+    return key;
+}
+
+/** Color map indices and radii of the elements, indexed by element key */
+struct ElementTables
+{
+    ElementTables()
+    {
+        colorIndices.fill(-1);
+        radii.fill(DEFAULT_RADIUS);
+        std::array<bool, NB_ELEMENT_KEYS> hasRadius;
+        hasRadius.fill(false);
+
+        // First match wins, as with a linear search through the tables
+        for (size_t i = 0; i < colorMapSize; ++i)
+        {
+            const auto& symbol = colorMap[i].symbol;
+            const size_t key = getElementKey(symbol.c_str(), symbol.length());
+            if (key != INVALID_ELEMENT_KEY && colorIndices[key] == -1)
+                colorIndices[key] = i;
+        }
+        for (size_t i = 0; i < colorMapSize; ++i)
+        {
+            const auto& symbol = atomic_radii[i].Symbol;
+            const size_t key = getElementKey(symbol.c_str(), symbol.length());
+            if (key != INVALID_ELEMENT_KEY && !hasRadius[key])
+            {
+                radii[key] = atomic_radii[i].radius;
+                hasRadius[key] = true;
+            }
+        }
+    }
+
+    std::array<int, NB_ELEMENT_KEYS> colorIndices;
+    std::array<float, NB_ELEMENT_KEYS> radii;
+};
+
+const ElementTables& getElementTables()
+{
+    static const ElementTables tables;
+    return tables;
+}
+
+/**
+ * Returns the bounds of a fixed column field of a line, with surrounding
+ * spaces trimmed. Fields beyond the end of the line are empty.
+ */
+void getField(const char* line, const size_t lineLength, const size_t first,
+              const size_t last, const char*& begin, const char*& end)
+{
+    begin = line + std::min(first, lineLength);
+    end = line + std::min(last, lineLength);
+    while (begin < end && std::isspace(static_cast<unsigned char>(*begin)))
+        ++begin;
+    while (end > begin && std::isspace(static_cast<unsigned char>(end[-1])))
+        --end;
+}
+
+template <typename T>
+T parseField(const char* line, const size_t lineLength, const size_t first,
+             const size_t last, T (*convert)(const char*))
+{
+    const char* begin;
+    const char* end;
+    getField(line, lineLength, first, last, begin, end);
+    char value[16] = {0};
+    std::copy(begin, std::min(end, begin + sizeof(value) - 1), value);
+    return convert(value);
+}
+
+float toFloat(const char* value)
+{
+    return std::strtof(value, nullptr);
+}
+
+int toInt(const char* value)
+{
+    return std::atoi(value);
+}
+}
+
 ProteinLoader::ProteinLoader(const GeometryParameters& geometryParameters)
     : _geometryParameters(geometryParameters)
 {
@@ -314,151 +416,190 @@ bool ProteinLoader::importPDBFile(const std::string& filename,
                                   const Vector3f& position,
                                   const size_t proteinIndex, Scene& scene)
 {
-    int index(0);
-    std::ifstream file(filename.c_str());
-    if (!file.is_open())
+    const auto atoms = _getAtoms(filename);
+    if (!atoms)
+        return false;
+
+    std::vector<SpheresMap> chunkSpheres;
+    std::vector<Boxf> chunkBounds;
+    _createSpheres(*atoms, position, proteinIndex, scene.getMaterials().size(),
+                   chunkSpheres, chunkBounds);
+    for (size_t chunk = 0; chunk < chunkSpheres.size(); ++chunk)
+        for (auto& spheres : chunkSpheres[chunk])
+            scene.addSpheres(spheres.first, std::move(spheres.second),
+                             chunkBounds[chunk]);
+    return true;
+}
+
+bool ProteinLoader::importPDBFile(const std::string& filename,
+                                  const size_t proteinIndex,
+                                  const size_t nbMaterials,
+                                  InstancedModel& model)
+{
+    const auto atoms = _getAtoms(filename);
+    if (!atoms)
+        return false;
+
+    std::vector<SpheresMap> chunkSpheres;
+    std::vector<Boxf> chunkBounds;
+    _createSpheres(*atoms, Vector3f(0.f, 0.f, 0.f), proteinIndex, nbMaterials,
+                   chunkSpheres, chunkBounds);
+    auto& modelSpheres = model.getSpheres();
+    for (size_t chunk = 0; chunk < chunkSpheres.size(); ++chunk)
+    {
+        for (auto& spheres : chunkSpheres[chunk])
+        {
+            auto& materialSpheres = modelSpheres[spheres.first];
+            materialSpheres.insert(
+                materialSpheres.end(),
+                std::make_move_iterator(spheres.second.begin()),
+                std::make_move_iterator(spheres.second.end()));
+        }
+        model.getBounds().merge(chunkBounds[chunk]);
+    }
+    return true;
+}
+
+void ProteinLoader::_createSpheres(const PDBAtoms& atoms,
+                                   const Vector3f& position,
+                                   const size_t proteinIndex,
+                                   const size_t nbMaterials,
+                                   std::vector<SpheresMap>& chunkSpheres,
+                                   std::vector<Boxf>& chunkBounds) const
+{
+    const bool byId =
+        _geometryParameters.getColorScheme() == ColorScheme::protein_by_id;
+    const size_t proteinMaterial = proteinIndex % nbMaterials;
+    const float radiusMultiplier = _geometryParameters.getRadiusMultiplier();
+
+    // Spheres are created in parallel chunks, to be appended in file order
+    const size_t nbChunks =
+        (atoms.size() + ATOMS_PER_CHUNK - 1) / ATOMS_PER_CHUNK;
+    chunkSpheres.resize(nbChunks);
+    chunkBounds.resize(nbChunks);
+#pragma omp parallel for schedule(dynamic) if (nbChunks > 1)
+    for (size_t chunk = 0; chunk < nbChunks; ++chunk)
+    {
+        const size_t begin = chunk * ATOMS_PER_CHUNK;
+        const size_t end = std::min(begin + ATOMS_PER_CHUNK, atoms.size());
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto& atom = atoms[i];
+            // Positions are converted from nanometers, radii from angstrom
+            const Vector3f center = position + 0.01f * atom.position;
+            const size_t material = byId ? proteinMaterial : atom.materialId;
+            chunkSpheres[chunk][material].push_back(std::make_shared<Sphere>(
+                0, center, 0.0001f * atom.radius * radiusMultiplier, 0.f,
+                0.f));
+            chunkBounds[chunk].merge(center);
+        }
+    }
+}
+
+ProteinLoader::PDBAtomsPtr ProteinLoader::_getAtoms(
+    const std::string& filename)
+{
+    const auto it = _cache.find(filename);
+    if (it != _cache.end())
+        return it->second;
+
+    std::shared_ptr<PDBAtoms> atoms(new PDBAtoms);
+    if (!_parsePDBFile(filename, *atoms))
+        return nullptr;
+    _cache[filename] = atoms;
+    return atoms;
+}
+
+bool ProteinLoader::_parsePDBFile(const std::string& filename,
+                                  PDBAtoms& atoms) const
+{
+    MemoryMappedFile file;
+    if (!file.map(filename))
     {
         BRAYNS_ERROR << "Could not open " << filename << std::endl;
         return false;
     }
-    else
+
+    const auto& tables = getElementTables();
+    const auto colorScheme = _geometryParameters.getColorScheme();
+    const size_t nbMaterials = NB_MAX_MATERIALS - NB_SYSTEM_MATERIALS;
+
+    const size_t nbChunks = file.getSize() / BYTES_PER_CHUNK + 1;
+    const auto boundaries = file.getLineChunks(nbChunks);
+    std::vector<PDBAtoms> chunkAtoms(nbChunks);
+#pragma omp parallel for schedule(dynamic) if (nbChunks > 1)
+    for (size_t chunk = 0; chunk < nbChunks; ++chunk)
     {
-        while (file.good())
+        const char* line = boundaries[chunk];
+        const char* chunkEnd = boundaries[chunk + 1];
+        while (line < chunkEnd)
         {
-            std::string line;
-            std::string value;
-            std::getline(file, line);
-            if (line.find("ATOM") == 0 || line.find("HETATM") == 0)
+            const void* endOfLine = std::memchr(line, '\n', chunkEnd - line);
+            const char* lineEnd =
+                endOfLine ? static_cast<const char*>(endOfLine) : chunkEnd;
+            const size_t length = lineEnd - line;
+            const char* next = lineEnd + 1;
+
+            // Fixed columns of ATOM and HETATM records
+            if ((length < 4 || std::strncmp(line, "ATOM", 4) != 0) &&
+                (length < 6 || std::strncmp(line, "HETATM", 6) != 0))
             {
-                // Atom
-                Atom atom;
-                atom.chainId = 0;
-                atom.residue = 0;
-                atom.processed = false;
-                atom.index = index;
-                index++;
-                std::string atomName;
-                std::string atomCode;
-                size_t i = 0;
-                while (i < line.length())
+                line = next;
+                continue;
+            }
+
+            // The last digit of the coordinates is ignored, as Brayns always
+            // did: the reference images of the tests rely on it
+            PDBAtom atom;
+            atom.position =
+                Vector3f(parseField(line, length, 30, 37, toFloat),
+                         parseField(line, length, 38, 45, toFloat),
+                         parseField(line, length, 46, 53, toFloat));
+            const int chainId = length > 21 ? int(line[21]) - 64 : 0;
+            const int residue = parseField(line, length, 22, 26, toInt);
+
+            // Element symbol, or the first two columns of the atom name for
+            // files that do not provide it
+            const char* begin;
+            const char* end;
+            getField(line, length, 76, 78, begin, end);
+            if (begin == end)
+                getField(line, length, 12, 14, begin, end);
+            const size_t key = getElementKey(begin, end - begin);
+
+            atom.materialId = 0;
+            atom.radius = DEFAULT_RADIUS;
+            if (key != INVALID_ELEMENT_KEY)
+            {
+                const int colorIndex = tables.colorIndices[key];
+                if (colorIndex != -1)
                 {
-                    switch (i)
+                    switch (colorScheme)
                     {
-                    case 6: // ID
-                    case 12:
-                    case 76: // Atom name
-                    case 22: // ChainID
-                    case 30: // x
-                    case 38: // y
-                    case 46: // z
-                        value = "";
-                        break;
-                    case 21:
-                        atom.chainId = (int)line.at(i) - 64;
-                        break;
-                    case 11:
-                        atom.id = static_cast<int>(atoi(value.c_str()));
-                        break;
-                    case 17:
-                        atomCode = value;
-                        break;
-                    case 79:
-                        atomName = value;
+                    case ColorScheme::protein_chains:
+                        atom.materialId = std::abs(chainId) % nbMaterials;
                         break;
-                    case 26:
-                        atom.residue = static_cast<int>(atoi(value.c_str()));
-                        break;
-                    case 37:
-                        atom.position[0] =
-                            static_cast<float>(atof(value.c_str()));
-                        break;
-                    case 45:
-                        atom.position[1] =
-                            static_cast<float>(atof(value.c_str()));
-                        break;
-                    case 53:
-                        atom.position[2] =
-                            static_cast<float>(atof(value.c_str()));
+                    case ColorScheme::protein_residues:
+                        atom.materialId = std::abs(residue) % nbMaterials;
                         break;
                     default:
-                        if (line.at(i) != ' ')
-                            value += line.at(i);
+                        atom.materialId = colorIndex;
                         break;
                     }
-                    i++;
                 }
-
-                // Material
-                atom.materialId = 0;
-                i = 0;
-                bool found = false;
-                const auto colorScheme = _geometryParameters.getColorScheme();
-                while (!found && i < colorMapSize)
-                {
-                    if (atomName == colorMap[i].symbol)
-                    {
-                        found = true;
-                        switch (colorScheme)
-                        {
-                        case ColorScheme::protein_chains:
-                            atom.materialId =
-                                abs(atom.chainId) %
-                                (NB_MAX_MATERIALS - NB_SYSTEM_MATERIALS);
-                            break;
-                        case ColorScheme::protein_residues:
-                            atom.materialId =
-                                abs(atom.residue) %
-                                (NB_MAX_MATERIALS - NB_SYSTEM_MATERIALS);
-                            break;
-                        default:
-                            atom.materialId = static_cast<int>(i);
-                            break;
-                        }
-                    }
-                    ++i;
-                }
-
-                // Radius
-                atom.radius = DEFAULT_RADIUS;
-                i = 0;
-                found = false;
-                while (!found && i < colorMapSize)
-                {
-                    if (atomName == atomic_radii[i].Symbol)
-                    {
-                        atom.radius = atomic_radii[i].radius;
-                        found = true;
-                    }
-                    ++i;
-                }
-
-                SpherePtr sphere(new Sphere(
-                    0,
-                    Vector3f(position +
-                             0.01f * atom.position), // convert from nanometers
-                    0.0001f * atom.radius *          // convert from angstrom
-                        _geometryParameters.getRadiusMultiplier(),
-                    0.f, 0.f));
-
-                switch (colorScheme)
-                {
-                case ColorScheme::protein_by_id:
-                {
-                    const auto material =
-                        proteinIndex % scene.getMaterials().size();
-                    scene.getSpheres()[material].push_back(sphere);
-                }
-                break;
-                default:
-                    scene.getSpheres()[atom.materialId].push_back(sphere);
-                }
-
-                scene.getWorldBounds().merge(sphere->getCenter());
+                atom.radius = tables.radii[key];
             }
+            chunkAtoms[chunk].push_back(atom);
+            line = next;
         }
-        file.close();
     }
 
+    size_t nbAtoms = 0;
+    for (const auto& c : chunkAtoms)
+        nbAtoms += c.size();
+    atoms.reserve(nbAtoms);
+    for (const auto& c : chunkAtoms)
+        atoms.insert(atoms.end(), c.begin(), c.end());
     return true;
 }
 
@@ -25,6 +25,8 @@
 #include <brayns/common/material/Material.h>
 #include <brayns/common/types.h>
 #include <brayns/parameters/GeometryParameters.h>
+
+#include <map>
 #include <string>
 
 namespace brayns
@@ -37,7 +39,8 @@ class ProteinLoader
 public:
     ProteinLoader(const GeometryParameters& geometryParameters);
 
-    /** Imports atoms from a given PDB file
+    /** Imports atoms from a given PDB file. The file is parsed once, later
+     * imports of the same file reuse the parsed atoms.
      *
      * @param filename PDB file to import
      * @param position Position of protein in space
@@ -48,6 +51,18 @@ public:
     bool importPDBFile(const std::string& filename, const Vector3f& position,
                        const size_t proteinIndex, Scene& scene);
 
+    /** Imports atoms from a given PDB file into an instanced model, in the
+     * model space. The model is then placed in the scene by its instances.
+     *
+     * @param filename PDB file to import
+     * @param proteinIndex Index of the protein when more than one is loaded
+     * @param nbMaterials Number of materials available in the scene
+     * @param model Resulting model
+     * @return true if PDB file was successufully loaded, false otherwize
+     */
+    bool importPDBFile(const std::string& filename, const size_t proteinIndex,
+                       const size_t nbMaterials, InstancedModel& model);
+
     /** Returns the RGB composants for a given atom index, and according to the
      * JMol scheme
      *
@@ -56,7 +71,27 @@ public:
     Vector3f getMaterialKd(size_t index);
 
 private:
+    /** Atom as parsed from a PDB file, before placement in the scene */
+    struct PDBAtom
+    {
+        Vector3f position;
+        float radius;
+        size_t materialId;
+    };
+    typedef std::vector<PDBAtom> PDBAtoms;
+    typedef std::shared_ptr<const PDBAtoms> PDBAtomsPtr;
+
+    PDBAtomsPtr _getAtoms(const std::string& filename);
+    bool _parsePDBFile(const std::string& filename, PDBAtoms& atoms) const;
+    void _createSpheres(const PDBAtoms& atoms, const Vector3f& position,
+                        size_t proteinIndex, size_t nbMaterials,
+                        std::vector<SpheresMap>& chunkSpheres,
+                        std::vector<Boxf>& chunkBounds) const;
+
     GeometryParameters _geometryParameters;
+
+    /** Parsed proteins, keyed by file path, reused by every instance */
+    std::map<std::string, PDBAtomsPtr> _cache;
 };
 }
 
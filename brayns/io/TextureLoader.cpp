@@ -22,6 +22,16 @@
 
 #include <brayns/common/log.h>
 
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+
 #ifdef BRAYNS_USE_MAGICKPP
 #define MAGICKCORE_HDRI_ENABLE true
 #define MAGICKCORE_QUANTUM_DEPTH 32
@@ -30,18 +40,12 @@
 
 namespace brayns
 {
-TextureLoader::TextureLoader()
+namespace
 {
-}
-
 #ifdef BRAYNS_USE_MAGICKPP
-bool TextureLoader::loadTexture(TexturesMap& textures,
-                                const TextureType textureType,
-                                const std::string& filename)
+Texture2DPtr decodeTexture(const TextureType textureType,
+                           const std::string& filename)
 {
-    if (textures.find(filename) != textures.end())
-        return true;
-
     try
     {
         Magick::Image image(filename);
@@ -62,28 +66,177 @@ bool TextureLoader::loadTexture(TexturesMap& textures,
                     << texture->getHeight() << "x" << texture->getNbChannels()
                     << "x" << texture->getDepth()
                     << " added to the texture cache" << std::endl;
-        textures[filename] = texture;
+        return texture;
     }
     catch (Magick::Warning& warning)
     {
         // Handle any other Magick++ warning.
         BRAYNS_WARN << warning.what() << std::endl;
-        return false;
     }
     catch (Magick::ErrorFileOpen& error)
     {
         // Process Magick++ file open error
         BRAYNS_ERROR << error.what() << std::endl;
-        return false;
     }
-    return true;
+    catch (Magick::Exception& error)
+    {
+        BRAYNS_ERROR << error.what() << std::endl;
+    }
+    return nullptr;
 }
 #else
-bool TextureLoader::loadTexture(TexturesMap&, const TextureType,
-                                const std::string& filename)
+Texture2DPtr decodeTexture(const TextureType, const std::string& filename)
 {
     BRAYNS_ERROR << "ImageMagick is required to load " << filename << std::endl;
-    return false;
+    return nullptr;
 }
 #endif
+
+/** Worker threads decoding the requested textures */
+class DecodingPool
+{
+public:
+    DecodingPool()
+        : _stopped(false)
+    {
+        const size_t nbThreads =
+            std::max(1u, std::thread::hardware_concurrency() / 2);
+        for (size_t i = 0; i < nbThreads; ++i)
+            _threads.emplace_back(&DecodingPool::_run, this);
+    }
+
+    ~DecodingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopped = true;
+        }
+        _condition.notify_all();
+        for (auto& thread : _threads)
+            thread.join();
+    }
+
+    std::shared_future<Texture2DPtr> decode(const TextureType textureType,
+                                            const std::string& filename)
+    {
+        std::packaged_task<Texture2DPtr()> task(
+            [textureType, filename]() {
+                return decodeTexture(textureType, filename);
+            });
+        std::shared_future<Texture2DPtr> future = task.get_future().share();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.push_back(std::move(task));
+        }
+        _condition.notify_one();
+        return future;
+    }
+
+private:
+    void _run()
+    {
+        while (true)
+        {
+            std::packaged_task<Texture2DPtr()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock,
+                                [this] { return _stopped || !_tasks.empty(); });
+                if (_stopped)
+                    return;
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> _threads;
+    std::deque<std::packaged_task<Texture2DPtr()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopped;
+};
+
+/** Textures decoded or being decoded, shared by all the scenes */
+class TextureCache
+{
+public:
+    std::shared_future<Texture2DPtr> get(const TextureType textureType,
+                                         const std::string& filename)
+    {
+        struct stat fileStat;
+        const time_t modificationTime =
+            ::stat(filename.c_str(), &fileStat) == 0 ? fileStat.st_mtime : 0;
+
+        // Files that changed on disk since they were decoded are decoded again
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& cachedTexture = _textures[std::make_pair(textureType, filename)];
+        if (!cachedTexture.texture.valid() ||
+            cachedTexture.modificationTime != modificationTime)
+        {
+            cachedTexture.modificationTime = modificationTime;
+            cachedTexture.texture = _pool.decode(textureType, filename);
+        }
+        return cachedTexture.texture;
+    }
+
+private:
+    struct CachedTexture
+    {
+        time_t modificationTime;
+        std::shared_future<Texture2DPtr> texture;
+    };
+
+    // The texture type is part of the key, as it is stored in the texture
+    std::map<std::pair<TextureType, std::string>, CachedTexture> _textures;
+    std::mutex _mutex;
+    DecodingPool _pool;
+};
+
+TextureCache& getTextureCache()
+{
+    static TextureCache cache;
+    return cache;
+}
+}
+
+TextureLoader::TextureLoader()
+{
+}
+
+bool TextureLoader::loadTexture(TexturesMap& textures,
+                                const TextureType textureType,
+                                const std::string& filename)
+{
+    const auto it = textures.find(filename);
+    if (it != textures.end() && it->second)
+        return true;
+
+    const Texture2DPtr texture =
+        getTextureCache().get(textureType, filename).get();
+    if (!texture)
+        return false;
+    textures[filename] = texture;
+    return true;
+}
+
+TextureStatus TextureLoader::requestTexture(TexturesMap& textures,
+                                            const TextureType textureType,
+                                            const std::string& filename)
+{
+    const auto it = textures.find(filename);
+    if (it != textures.end() && it->second)
+        return TextureStatus::loaded;
+
+    const auto future = getTextureCache().get(textureType, filename);
+    if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return TextureStatus::loading;
+
+    const Texture2DPtr texture = future.get();
+    if (!texture)
+        return TextureStatus::failed;
+    textures[filename] = texture;
+    return TextureStatus::loaded;
+}
 }
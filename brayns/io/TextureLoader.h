@@ -26,13 +26,40 @@
 
 namespace brayns
 {
+enum class TextureStatus
+{
+    loaded,
+    loading,
+    failed
+};
+
+/**
+ * Loads textures from files. Decoded textures are kept in a process-wide
+ * cache keyed by texture type, file name and modification time, so that a
+ * file is only decoded again when it changed on disk. Decoding happens on a
+ * pool of worker threads.
+ */
 class TextureLoader
 {
 public:
     TextureLoader();
 
+    /**
+     * Loads a texture and adds it to the given textures, waiting for its
+     * decoding if needed
+     * @return true if the texture was successfully loaded
+     */
     bool loadTexture(TexturesMap& textures, TextureType textureType,
                      const std::string& filename);
+
+    /**
+     * Requests a texture without waiting for its decoding. The texture is
+     * added to the given textures once decoded, the request has to be
+     * repeated until the returned status is no longer TextureStatus::loading
+     */
+    TextureStatus requestTexture(TexturesMap& textures,
+                                 TextureType textureType,
+                                 const std::string& filename);
 };
 }
 
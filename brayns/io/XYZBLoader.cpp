@@ -1,4 +1,4 @@
-/* Copyright (c) 2015-2016, EPFL/Blue Brain Project
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
  * All rights reserved. Do not distribute without permission.
  * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
  *
@@ -20,10 +20,114 @@
 
 #include <brayns/common/log.h>
 #include <brayns/common/scene/Scene.h>
-#include <fstream>
+#include <brayns/common/utils/MemoryMappedFile.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "XYZBLoader.h"
 
+namespace
+{
+const size_t POINTS_PER_CHUNK = 1 << 20;
+const size_t BYTES_PER_TEXT_CHUNK = 1 << 24;
+const size_t MAX_VALUE_LENGTH = 64;
+
+/**
+ * Parses the whitespace separated floats of a line that is not null
+ * terminated
+ * @return false if a value is not a valid float
+ */
+bool parseValues(const char* begin, const char* end, brayns::floats& values)
+{
+    values.clear();
+    char value[MAX_VALUE_LENGTH + 1];
+    const char* c = begin;
+    while (c < end)
+    {
+        while (c < end && std::isspace(static_cast<unsigned char>(*c)))
+            ++c;
+        if (c == end)
+            break;
+
+        size_t length = 0;
+        while (c < end && !std::isspace(static_cast<unsigned char>(*c)))
+        {
+            if (length == MAX_VALUE_LENGTH)
+                return false;
+            value[length++] = *c++;
+        }
+        value[length] = 0;
+
+        char* last = nullptr;
+        values.push_back(std::strtof(value, &last));
+        if (last != value + length)
+            return false;
+    }
+    return true;
+}
+
+/** @return true on the thread that reports the progress of parallel loops */
+bool isReportingThread()
+{
+#ifdef _OPENMP
+    return omp_get_thread_num() == 0;
+#else
+    return true;
+#endif
+}
+
+/**
+ * Creates one sphere per point in parallel and appends them to the first
+ * material of the scene
+ */
+template <typename GetPosition>
+void addPoints(brayns::Scene& scene, const size_t nbPoints, const float radius,
+               const GetPosition& getPosition)
+{
+    if (nbPoints == 0)
+        return;
+
+    brayns::Spheres spheres(nbPoints);
+    brayns::Boxf bounds;
+    const size_t nbChunks =
+        (nbPoints + POINTS_PER_CHUNK - 1) / POINTS_PER_CHUNK;
+    std::atomic<size_t> progress(0);
+#pragma omp parallel
+    {
+        brayns::Boxf privateBounds;
+#pragma omp for schedule(dynamic) nowait
+        for (size_t chunk = 0; chunk < nbChunks; ++chunk)
+        {
+            const size_t begin = chunk * POINTS_PER_CHUNK;
+            const size_t end = std::min(begin + POINTS_PER_CHUNK, nbPoints);
+            for (size_t i = begin; i < end; ++i)
+            {
+                const brayns::Vector3f position = getPosition(i);
+                spheres[i] = std::make_shared<brayns::Sphere>(0, position,
+                                                              radius, 0.f, 0.f);
+                privateBounds.merge(position);
+            }
+
+            const size_t done = progress++;
+            if (isReportingThread())
+                BRAYNS_PROGRESS(done, nbChunks);
+        }
+
+#pragma omp critical
+        bounds.merge(privateBounds);
+    }
+    BRAYNS_PROGRESS(nbChunks - 1, nbChunks);
+    scene.addSpheres(0, std::move(spheres), bounds);
+}
+}
+
 namespace brayns
 {
 XYZBLoader::XYZBLoader(const GeometryParameters& geometryParameters)
@@ -34,88 +138,91 @@ XYZBLoader::XYZBLoader(const GeometryParameters& geometryParameters)
 bool XYZBLoader::importFromFile(const std::string& filename, Scene& scene)
 {
     BRAYNS_INFO << "Loading xyz file from " << filename << std::endl;
-    std::ifstream file(filename, std::ios::in);
-    if (!file.good())
-    {
-        BRAYNS_ERROR << "Could not open file " << filename << std::endl;
+    MemoryMappedFile file;
+    if (!file.map(filename))
         return false;
-    }
 
-    SpheresMap& spheres = scene.getSpheres();
-    bool validParsing = true;
-    std::string line;
+    // Chunks of whole lines are parsed in parallel
+    const size_t nbChunks = file.getSize() / BYTES_PER_TEXT_CHUNK + 1;
+    const auto boundaries = file.getLineChunks(nbChunks);
 
-    while (validParsing && std::getline(file, line))
+    std::vector<Vector3fs> positions(nbChunks);
+    strings invalidLines(nbChunks);
+#pragma omp parallel
     {
-        std::vector<float> lineData;
-        std::stringstream lineStream(line);
-
-        float value;
-        while (lineStream >> value)
-            lineData.push_back(value);
-
-        switch (lineData.size())
-        {
-        case 3:
+        floats values;
+#pragma omp for schedule(dynamic)
+        for (size_t chunk = 0; chunk < nbChunks; ++chunk)
         {
-            const Vector3f position(lineData[0], lineData[1], lineData[2]);
-            BRAYNS_INFO << position << std::endl;
-            spheres[0].push_back(
-                SpherePtr(new Sphere(0, position,
-                                     _geometryParameters.getRadiusMultiplier(),
-                                     0.f, 0.f)));
-            scene.getWorldBounds().merge(position);
-            break;
+            const char* line = boundaries[chunk];
+            const char* chunkEnd = boundaries[chunk + 1];
+            while (line < chunkEnd)
+            {
+                const void* endOfLine =
+                    std::memchr(line, '\n', chunkEnd - line);
+                const char* lineEnd =
+                    endOfLine ? static_cast<const char*>(endOfLine) : chunkEnd;
+                const bool valid = parseValues(line, lineEnd, values);
+                if (valid && values.size() == 3)
+                    positions[chunk].push_back(
+                        Vector3f(values[0], values[1], values[2]));
+                else if (!valid || !values.empty())
+                {
+                    invalidLines[chunk].assign(line, lineEnd);
+                    break;
+                }
+                line = lineEnd + 1;
+            }
         }
-        default:
-            BRAYNS_ERROR << "Invalid line: " << line << std::endl;
-            validParsing = false;
-            break;
+    }
+
+    for (const auto& invalidLine : invalidLines)
+    {
+        if (!invalidLine.empty())
+        {
+            BRAYNS_ERROR << "Invalid line: " << invalidLine << std::endl;
+            return false;
         }
     }
 
-    file.close();
-    return validParsing;
+    Vector3fs points;
+    size_t nbPoints = 0;
+    for (const auto& chunkPositions : positions)
+        nbPoints += chunkPositions.size();
+    points.reserve(nbPoints);
+    for (auto& chunkPositions : positions)
+    {
+        points.insert(points.end(), chunkPositions.begin(),
+                      chunkPositions.end());
+        Vector3fs().swap(chunkPositions);
+    }
+
+    addPoints(scene, nbPoints, _geometryParameters.getRadiusMultiplier(),
+              [&points](const size_t i) { return points[i]; });
+    BRAYNS_INFO << nbPoints << " points loaded" << std::endl;
+    return true;
 }
 
 bool XYZBLoader::importFromBinaryFile(const std::string& filename, Scene& scene)
 {
     BRAYNS_INFO << "Loading xyzb file from " << filename << std::endl;
-    std::ifstream file(filename, std::ios::in | std::fstream::binary);
-    if (!file.good())
-    {
-        BRAYNS_ERROR << "Could not open file " << filename << std::endl;
+    MemoryMappedFile file;
+    if (!file.map(filename))
         return false;
-    }
-
-    uint64_t progress = 0;
-    file.seekg(0, std::ios_base::end);
-    uint64_t nbPoints = file.tellg() / (3 * sizeof(double));
-    file.seekg(0);
-
-    SpheresMap& spheres = scene.getSpheres();
-    while (!file.eof())
-    {
-        if (progress % (nbPoints / 100) == 0)
-            BRAYNS_PROGRESS(progress, nbPoints);
-
-        double x, y, z;
-        file.read((char*)&x, sizeof(double));
-        file.read((char*)&y, sizeof(double));
-        file.read((char*)&z, sizeof(double));
-
-        BRAYNS_DEBUG << x << "," << y << "," << z << std::endl;
-
-        const Vector3f position(x, y, z);
-        spheres[0].push_back(SpherePtr(
-            new Sphere(0, position, _geometryParameters.getRadiusMultiplier(),
-                       0.f, 0.f)));
-        scene.getWorldBounds().merge(position);
-
-        ++progress;
-    }
 
-    file.close();
+    const size_t pointSize = 3 * sizeof(double);
+    const size_t nbPoints = file.getSize() / pointSize;
+    if (file.getSize() % pointSize != 0)
+        BRAYNS_WARN << "Ignoring " << file.getSize() % pointSize
+                    << " trailing bytes in " << filename << std::endl;
+
+    const double* values = reinterpret_cast<const double*>(file.getData());
+    addPoints(scene, nbPoints, _geometryParameters.getRadiusMultiplier(),
+              [values](const size_t i) {
+                  return Vector3f(values[3 * i], values[3 * i + 1],
+                                  values[3 * i + 2]);
+              });
+    BRAYNS_INFO << nbPoints << " points loaded" << std::endl;
     return true;
 }
 }
@@ -32,6 +32,16 @@ const std::string PARAM_BENCHMARKING = "enable-benchmark";
 const std::string PARAM_JPEG_COMPRESSION = "jpeg-compression";
 const std::string PARAM_JPEG_SIZE = "jpeg-size";
 const std::string PARAM_FILTERS = "filters";
+const std::string PARAM_STREAM_TILE_SIZE = "stream-tile-size";
+const std::string PARAM_STREAM_KEYFRAME_INTERVAL = "stream-keyframe-interval";
+const std::string PARAM_DEPTH_RANGE = "depth-range";
+const std::string PARAM_DEPTH_HALF_FLOAT = "depth-half-float";
+const std::string PARAM_FRAME_BUFFERS_COMPRESSION = "frame-buffers-compression";
+const std::string PARAM_VIDEO_FILE = "video-file";
+const std::string PARAM_VIDEO_FRAME_RATE = "video-frame-rate";
+const std::string PARAM_MEMORY_BUDGET = "memory-budget";
+const std::string PARAM_MEMORY_BUDGET_STRICT = "memory-budget-strict";
+const std::string PARAM_NETWORK_PLUGINS = "network-plugins";
 #if BRAYNS_USE_NETWORKING
 const std::string PARAM_ZEROEQ_AUTO_PUBLISH = "zeroeq-auto-publish";
 #endif
@@ -42,6 +52,9 @@ const size_t DEFAULT_JPEG_WIDTH = DEFAULT_WINDOW_WIDTH;
 const size_t DEFAULT_JPEG_HEIGHT = DEFAULT_WINDOW_HEIGHT;
 const size_t DEFAULT_JPEG_COMPRESSION = 100;
 const std::string DEFAULT_CAMERA = "perspective";
+const size_t DEFAULT_STREAM_TILE_SIZE = 64;
+const size_t DEFAULT_STREAM_KEYFRAME_INTERVAL = 100;
+const size_t DEFAULT_VIDEO_FRAME_RATE = 25;
 }
 
 namespace brayns
@@ -53,6 +66,15 @@ ApplicationParameters::ApplicationParameters()
     , _benchmarking(false)
     , _jpegCompression(DEFAULT_JPEG_COMPRESSION)
     , _jpegSize(DEFAULT_JPEG_WIDTH, DEFAULT_JPEG_HEIGHT)
+    , _streamTileSize(DEFAULT_STREAM_TILE_SIZE)
+    , _streamKeyframeInterval(DEFAULT_STREAM_KEYFRAME_INTERVAL)
+    , _depthRange(0.f, 1.f)
+    , _depthHalfFloat(false)
+    , _frameBuffersCompression(false)
+    , _videoFrameRate(DEFAULT_VIDEO_FRAME_RATE)
+    , _memoryBudget(0)
+    , _memoryBudgetStrict(false)
+    , _networkPlugins(true)
     , _autoPublishZeroEQEvents(false)
 {
     _parameters.add_options()(PARAM_WINDOW_SIZE.c_str(),
@@ -64,7 +86,29 @@ ApplicationParameters::ApplicationParameters()
         PARAM_JPEG_COMPRESSION.c_str(), po::value<size_t>(),
         "JPEG compression rate (100 is full quality) [float]")(
         PARAM_JPEG_SIZE.c_str(), po::value<uints>()->multitoken(),
-        "JPEG size [int int]")
+        "JPEG size [int int]")(
+        PARAM_STREAM_TILE_SIZE.c_str(), po::value<size_t>(),
+        "Tile size for delta image streaming, 0 to disable [int]")(
+        PARAM_STREAM_KEYFRAME_INTERVAL.c_str(), po::value<size_t>(),
+        "Number of streamed images between two keyframes [int]")(
+        PARAM_DEPTH_RANGE.c_str(), po::value<floats>()->multitoken(),
+        "Near and far values used to normalize exported depth [float float]")(
+        PARAM_DEPTH_HALF_FLOAT.c_str(), po::value<bool>(),
+        "Export depth as half floats instead of 16-bit integers [bool]")(
+        PARAM_FRAME_BUFFERS_COMPRESSION.c_str(), po::value<bool>(),
+        "Enable|Disable compression of exported frame buffers [bool]")(
+        PARAM_VIDEO_FILE.c_str(), po::value<std::string>(),
+        "Record rendered frames to numbered MJPEG AVI files named after the "
+        "given one [string]")(
+        PARAM_VIDEO_FRAME_RATE.c_str(), po::value<size_t>(),
+        "Frame rate of the recorded video [int]")(
+        PARAM_MEMORY_BUDGET.c_str(), po::value<size_t>(),
+        "Memory budget in MB, 0 for no budget [int]")(
+        PARAM_MEMORY_BUDGET_STRICT.c_str(), po::value<bool>(),
+        "Refuse to load data exceeding the memory budget instead of "
+        "warning [bool]")(
+        PARAM_NETWORK_PLUGINS.c_str(), po::value<bool>(),
+        "Enable|Disable the ZeroEQ and Deflect plugins [bool]")
 #if BRAYNS_USE_NETWORKING
         (PARAM_ZEROEQ_AUTO_PUBLISH.c_str(), po::value<bool>(),
          "Enable|Disable automatic publishing of zeroeq network events [bool]")
@@ -103,6 +147,32 @@ bool ApplicationParameters::_parse(const po::variables_map& vm)
     {
         _filters = vm[PARAM_FILTERS].as<strings>();
     }
+    if (vm.count(PARAM_STREAM_TILE_SIZE))
+        _streamTileSize = vm[PARAM_STREAM_TILE_SIZE].as<size_t>();
+    if (vm.count(PARAM_STREAM_KEYFRAME_INTERVAL))
+        _streamKeyframeInterval =
+            vm[PARAM_STREAM_KEYFRAME_INTERVAL].as<size_t>();
+    if (vm.count(PARAM_DEPTH_RANGE))
+    {
+        floats values = vm[PARAM_DEPTH_RANGE].as<floats>();
+        if (values.size() == 2)
+            _depthRange = Vector2f(values[0], values[1]);
+    }
+    if (vm.count(PARAM_DEPTH_HALF_FLOAT))
+        _depthHalfFloat = vm[PARAM_DEPTH_HALF_FLOAT].as<bool>();
+    if (vm.count(PARAM_FRAME_BUFFERS_COMPRESSION))
+        _frameBuffersCompression =
+            vm[PARAM_FRAME_BUFFERS_COMPRESSION].as<bool>();
+    if (vm.count(PARAM_VIDEO_FILE))
+        _videoFile = vm[PARAM_VIDEO_FILE].as<std::string>();
+    if (vm.count(PARAM_VIDEO_FRAME_RATE))
+        _videoFrameRate = vm[PARAM_VIDEO_FRAME_RATE].as<size_t>();
+    if (vm.count(PARAM_MEMORY_BUDGET))
+        _memoryBudget = vm[PARAM_MEMORY_BUDGET].as<size_t>();
+    if (vm.count(PARAM_MEMORY_BUDGET_STRICT))
+        _memoryBudgetStrict = vm[PARAM_MEMORY_BUDGET_STRICT].as<bool>();
+    if (vm.count(PARAM_NETWORK_PLUGINS))
+        _networkPlugins = vm[PARAM_NETWORK_PLUGINS].as<bool>();
 #if BRAYNS_USE_NETWORKING
     if (vm.count(PARAM_ZEROEQ_AUTO_PUBLISH))
         _autoPublishZeroEQEvents = vm[PARAM_ZEROEQ_AUTO_PUBLISH].as<bool>();
@@ -121,6 +191,23 @@ void ApplicationParameters::print()
     BRAYNS_INFO << "JPEG Compression            : " << _jpegCompression
                 << std::endl;
     BRAYNS_INFO << "JPEG size                   : " << _jpegSize << std::endl;
+    BRAYNS_INFO << "Stream tile size            : " << _streamTileSize
+                << std::endl;
+    BRAYNS_INFO << "Stream keyframe interval    : " << _streamKeyframeInterval
+                << std::endl;
+    BRAYNS_INFO << "Depth range                 : " << _depthRange
+                << std::endl;
+    BRAYNS_INFO << "Depth as half float         : "
+                << (_depthHalfFloat ? "on" : "off") << std::endl;
+    BRAYNS_INFO << "Frame buffers compression   : "
+                << (_frameBuffersCompression ? "on" : "off") << std::endl;
+    BRAYNS_INFO << "Video file                  : " << _videoFile << std::endl;
+    BRAYNS_INFO << "Video frame rate            : " << _videoFrameRate
+                << std::endl;
+    BRAYNS_INFO << "Memory budget (MB)          : " << _memoryBudget
+                << (_memoryBudgetStrict ? " (strict)" : "") << std::endl;
+    BRAYNS_INFO << "Network plugins             : "
+                << (_networkPlugins ? "on" : "off") << std::endl;
 #if BRAYNS_USE_NETWORKING
     BRAYNS_INFO << "Auto-publish ZeroeEQ events : "
                 << (_autoPublishZeroEQEvents ? "on" : "off") << std::endl;
@@ -56,6 +56,52 @@ public:
     const Vector2ui& getJpegSize() const { return _jpegSize; }
     void setJpegSize(const Vector2ui& size) { _jpegSize = size; }
     const strings& getFilters() const { return _filters; }
+    /** Size of the tiles used for delta image streaming. 0 disables delta
+     * streaming and full images are always sent */
+    size_t getStreamTileSize() const { return _streamTileSize; }
+    void setStreamTileSize(const size_t size) { _streamTileSize = size; }
+    /** Number of streamed images between two full keyframes */
+    size_t getStreamKeyframeInterval() const
+    {
+        return _streamKeyframeInterval;
+    }
+    void setStreamKeyframeInterval(const size_t interval)
+    {
+        _streamKeyframeInterval = interval;
+    }
+    /** Depth values exported in frame buffers are normalized between near
+     * and far when quantized to 16-bit integers */
+    const Vector2f& getDepthRange() const { return _depthRange; }
+    void setDepthRange(const Vector2f& range) { _depthRange = range; }
+    /** Export depth values as half floats instead of normalized integers */
+    bool getDepthHalfFloat() const { return _depthHalfFloat; }
+    void setDepthHalfFloat(const bool value) { _depthHalfFloat = value; }
+    /** Lossless compression of exported frame buffers */
+    bool getFrameBuffersCompression() const
+    {
+        return _frameBuffersCompression;
+    }
+    void setFrameBuffersCompression(const bool value)
+    {
+        _frameBuffersCompression = value;
+    }
+    /** Output file of the video recorder. Recording starts with the
+     * application if not empty */
+    const std::string& getVideoFile() const { return _videoFile; }
+    void setVideoFile(const std::string& file) { _videoFile = file; }
+    /** Frame rate of the recorded video */
+    size_t getVideoFrameRate() const { return _videoFrameRate; }
+    /** Memory budget in MB, 0 if there is no budget */
+    size_t getMemoryBudget() const { return _memoryBudget; }
+    void setMemoryBudget(const size_t value) { _memoryBudget = value; }
+    /** True if data exceeding the memory budget is not loaded */
+    bool getMemoryBudgetStrict() const { return _memoryBudgetStrict; }
+    void setMemoryBudgetStrict(const bool value)
+    {
+        _memoryBudgetStrict = value;
+    }
+    /** True if the ZeroEQ and Deflect plugins are created */
+    bool getNetworkPlugins() const { return _networkPlugins; }
     /**
      * @brief Auto publication of ZeroEQ events is used when several
      * applications supporting the ZeroEQ protocol are started and need to
@@ -72,6 +118,16 @@ protected:
     size_t _jpegCompression;
     Vector2ui _jpegSize;
     strings _filters;
+    size_t _streamTileSize;
+    size_t _streamKeyframeInterval;
+    Vector2f _depthRange;
+    bool _depthHalfFloat;
+    bool _frameBuffersCompression;
+    std::string _videoFile;
+    size_t _videoFrameRate;
+    size_t _memoryBudget;
+    bool _memoryBudgetStrict;
+    bool _networkPlugins;
     bool _autoPublishZeroEQEvents;
 };
 }
@@ -34,6 +34,7 @@ const std::string PARAM_PDB_FILE = "pdb-file";
 const std::string PARAM_PDB_FOLDER = "pdb-folder";
 const std::string PARAM_XYZB_FILE = "xyzb-file";
 const std::string PARAM_MESH_FOLDER = "mesh-folder";
+const std::string PARAM_MESH_QUANTIZATION = "mesh-quantization";
 const std::string PARAM_CIRCUIT_CONFIG = "circuit-config";
 const std::string PARAM_LOAD_CACHE_FILE = "load-cache-file";
 const std::string PARAM_SAVE_CACHE_FILE = "save-cache-file";
@@ -60,6 +61,7 @@ const std::string PARAM_METABALLS_GRIDSIZE = "metaballs-grid-size";
 const std::string PARAM_METABALLS_THRESHOLD = "metaballs-threshold";
 const std::string PARAM_METABALLS_SAMPLES_FROM_SOMA =
     "metaballs-samples-from-soma";
+const std::string PARAM_LOADING_BATCH_SIZE = "loading-batch-size";
 
 const std::string COLOR_SCHEMES[8] = {
     "none",           "neuron-by-id",
@@ -90,9 +92,11 @@ GeometryParameters::GeometryParameters()
                                       std::numeric_limits<float>::min()))
     , _simulationHistogramSize(128)
     , _generateMultipleModels(false)
+    , _meshQuantization(false)
     , _metaballsGridSize(0)
     , _metaballsThreshold(1.f)
     , _metaballsSamplesFromSoma(3)
+    , _loadingBatchSize(0)
 {
     _parameters.add_options()(PARAM_MORPHOLOGY_FOLDER.c_str(),
                               po::value<std::string>(),
@@ -102,13 +106,16 @@ GeometryParameters::GeometryParameters()
         PARAM_NEST_REPORT.c_str(), po::value<std::string>(),
         "NEST simulation report file [string]")(
         PARAM_MESH_FOLDER.c_str(), po::value<std::string>(),
-        "Folder containing mesh files [string]")(PARAM_PDB_FILE.c_str(),
+        "Folder containing mesh files [string]")(
+        PARAM_MESH_QUANTIZATION.c_str(), po::value<bool>(),
+        "Enable/Disable quantization of normals, colors and texture "
+        "coordinates of imported meshes [bool]")(PARAM_PDB_FILE.c_str(),
                                                  po::value<std::string>(),
                                                  "PDB filename [string]")(
         PARAM_PDB_FOLDER.c_str(), po::value<std::string>(),
-        "Folder containing PDB files [string]")(PARAM_XYZB_FILE.c_str(),
-                                                po::value<std::string>(),
-                                                "XYZB filename [string]")(
+        "Folder containing PDB files [string]")(
+        PARAM_XYZB_FILE.c_str(), po::value<std::string>(),
+        "XYZB or XYZ filename [string]")(
         PARAM_CIRCUIT_CONFIG.c_str(), po::value<std::string>(),
         "Circuit configuration filename [string]")(
         PARAM_LOAD_CACHE_FILE.c_str(), po::value<std::string>(),
@@ -170,7 +177,11 @@ GeometryParameters::GeometryParameters()
                                "Metaballs threshold [float]")(
         PARAM_METABALLS_SAMPLES_FROM_SOMA.c_str(), po::value<size_t>(),
         "Number of morphology samples (or segments) from soma used by "
-        "automated meshing [int]");
+        "automated meshing [int]")(
+        PARAM_LOADING_BATCH_SIZE.c_str(), po::value<size_t>(),
+        "Number of cells or files loaded before they are rendered [int]. "
+        "Activates progressive loading in the background if different "
+        "from 0");
 }
 
 bool GeometryParameters::_parse(const po::variables_map& vm)
@@ -189,6 +200,8 @@ bool GeometryParameters::_parse(const po::variables_map& vm)
         _xyzbFile = vm[PARAM_XYZB_FILE].as<std::string>();
     if (vm.count(PARAM_MESH_FOLDER))
         _meshFolder = vm[PARAM_MESH_FOLDER].as<std::string>();
+    if (vm.count(PARAM_MESH_QUANTIZATION))
+        _meshQuantization = vm[PARAM_MESH_QUANTIZATION].as<bool>();
     if (vm.count(PARAM_CIRCUIT_CONFIG))
         _circuitConfig = vm[PARAM_CIRCUIT_CONFIG].as<std::string>();
     if (vm.count(PARAM_LOAD_CACHE_FILE))
@@ -282,6 +295,8 @@ bool GeometryParameters::_parse(const po::variables_map& vm)
     if (vm.count(PARAM_METABALLS_SAMPLES_FROM_SOMA))
         _metaballsSamplesFromSoma =
             vm[PARAM_METABALLS_SAMPLES_FROM_SOMA].as<size_t>();
+    if (vm.count(PARAM_LOADING_BATCH_SIZE))
+        _loadingBatchSize = vm[PARAM_LOADING_BATCH_SIZE].as<size_t>();
 
     return true;
 }
@@ -299,6 +314,8 @@ void GeometryParameters::print()
     BRAYNS_INFO << "PDB folder                 : " << _pdbFolder << std::endl;
     BRAYNS_INFO << "XYZB file                  : " << _xyzbFile << std::endl;
     BRAYNS_INFO << "Mesh folder                : " << _meshFolder << std::endl;
+    BRAYNS_INFO << "Mesh quantization          : "
+                << (_meshQuantization ? "on" : "off") << std::endl;
     BRAYNS_INFO << "Cache file to load         : " << _loadCacheFile
                 << std::endl;
     BRAYNS_INFO << "Cache file to save         : " << _saveCacheFile
@@ -351,6 +368,8 @@ void GeometryParameters::print()
                 << std::endl;
     BRAYNS_INFO << " - Samples from soma       : " << _metaballsSamplesFromSoma
                 << std::endl;
+    BRAYNS_INFO << "Loading batch size         : " << _loadingBatchSize
+                << std::endl;
 }
 
 const std::string& GeometryParameters::getColorSchemeAsString(
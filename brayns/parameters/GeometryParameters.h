@@ -77,6 +77,9 @@ public:
     std::string getXYZBFile() const { return _xyzbFile; }
     /** folder containing mesh files */
     std::string getMeshFolder() const { return _meshFolder; }
+    /** Defines if normals, colors and texture coordinates of meshes are
+        quantized */
+    bool getMeshQuantization() const { return _meshQuantization; }
     /** file containing circuit configuration */
     std::string getCircuitConfiguration() const { return _circuitConfig; }
     /** Binary representation of a scene to load */
@@ -168,6 +171,10 @@ public:
 
     /** Metaballs enabled? */
     bool useMetaballs() const { return _metaballsGridSize != 0; }
+    /** Number of cells or files loaded before they are rendered */
+    size_t getLoadingBatchSize() const { return _loadingBatchSize; }
+    /** Progressive loading enabled? */
+    bool useProgressiveLoading() const { return _loadingBatchSize != 0; }
 protected:
     bool _parse(const po::variables_map& vm) final;
 
@@ -199,11 +206,13 @@ protected:
     std::string _simulationCacheFile;
     size_t _simulationHistogramSize;
     bool _generateMultipleModels;
+    bool _meshQuantization;
     std::string _splashSceneFolder;
     std::string _molecularSystemConfig;
     size_t _metaballsGridSize;
     float _metaballsThreshold;
     size_t _metaballsSamplesFromSoma;
+    size_t _loadingBatchSize;
 };
 }
 #endif // GEOMETRYPARAMETERS_H
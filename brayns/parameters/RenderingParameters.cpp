@@ -47,6 +47,8 @@ const std::string PARAM_DETECTION_FAR_COLOR = "detection-far-color";
 const std::string PARAM_EPSILON = "epsilon";
 const std::string PARAM_CAMERA_TYPE = "camera-type";
 const std::string PARAM_HEAD_LIGHT = "head-light";
+const std::string PARAM_TARGET_FPS = "target-fps";
+const std::string PARAM_CLIP_CULLING = "clip-culling";
 
 const std::string RENDERERS[4] = {"exobj", "proximityrenderer",
                                   "simulationrenderer", "particlerenderer"};
@@ -77,6 +79,8 @@ RenderingParameters::RenderingParameters()
     , _epsilon(0.f)
     , _cameraType(CameraType::perspective)
     , _headLight(false)
+    , _targetFPS(0.f)
+    , _clipCulling(false)
 {
     _parameters.add_options()(PARAM_ENGINE.c_str(), po::value<std::string>(),
                               "Engine name [ospray|optix|livre]")(
@@ -112,7 +116,14 @@ RenderingParameters::RenderingParameters()
         PARAM_CAMERA_TYPE.c_str(), po::value<std::string>(),
         "Camera type [perspective|stereo|orthographic|panoramic]")(
         PARAM_HEAD_LIGHT.c_str(), po::value<bool>(),
-        "Enable/Disable light source attached to camera origin [bool]");
+        "Enable/Disable light source attached to camera origin [bool]")(
+        PARAM_TARGET_FPS.c_str(), po::value<float>(),
+        "Frame rate to reach while the view changes [float]. Activates "
+        "rendering at a reduced resolution during interaction if different "
+        "from 0")(
+        PARAM_CLIP_CULLING.c_str(), po::value<bool>(),
+        "Enable/Disable the removal of the geometry lying entirely behind the "
+        "clip planes [bool]");
 
     // Add default renderers
     _renderers.push_back(RendererType::basic);
@@ -188,6 +199,10 @@ bool RenderingParameters::_parse(const po::variables_map& vm)
     }
     if (vm.count(PARAM_HEAD_LIGHT))
         _headLight = vm[PARAM_HEAD_LIGHT].as<bool>();
+    if (vm.count(PARAM_TARGET_FPS))
+        _targetFPS = vm[PARAM_TARGET_FPS].as<float>();
+    if (vm.count(PARAM_CLIP_CULLING))
+        _clipCulling = vm[PARAM_CLIP_CULLING].as<bool>();
     return true;
 }
 
@@ -227,6 +242,10 @@ void RenderingParameters::print()
                 << std::endl;
     BRAYNS_INFO << "Camera type                       : "
                 << getCameraTypeAsString(_cameraType) << std::endl;
+    BRAYNS_INFO << "Target FPS                        : " << _targetFPS
+                << std::endl;
+    BRAYNS_INFO << "Clip culling                      : "
+                << (_clipCulling ? "on" : "off") << std::endl;
 }
 
 const std::string& RenderingParameters::getRendererAsString(
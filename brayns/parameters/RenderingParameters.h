@@ -148,6 +148,16 @@ public:
        Light source follow camera origin
     */
     bool getHeadLight() const { return _headLight; }
+    /**
+       Frame rate to reach while the view changes, by reducing the rendering
+       resolution. 0 if the resolution is never reduced.
+    */
+    float getTargetFPS() const { return _targetFPS; }
+    /**
+       Primitives lying entirely behind the clip planes are removed from the
+       model, rebuilt in the background when the planes change
+    */
+    bool getClipCulling() const { return _clipCulling; }
 protected:
     bool _parse(const po::variables_map& vm) final;
 
@@ -169,6 +179,8 @@ protected:
     float _epsilon;
     CameraType _cameraType;
     bool _headLight;
+    float _targetFPS;
+    bool _clipCulling;
 };
 }
 #endif // RENDERINGPARAMETERS_H
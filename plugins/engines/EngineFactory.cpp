@@ -35,8 +35,10 @@
 namespace brayns
 {
 EngineFactory::EngineFactory(int argc, const char** argv,
-                             ParametersManager& parametersManager)
+                             ParametersManager& parametersManager,
+                             PerformanceCounters& performanceCounters)
     : _parametersManager(parametersManager)
+    , _performanceCounters(performanceCounters)
 {
     for (int i = 0; i < argc; ++i)
         _arguments.push_back(argv[i]);
@@ -55,7 +57,8 @@ EnginePtr EngineFactory::get(const std::string& name)
             for (size_t i = 0; i < _arguments.size(); ++i)
                 argv[i] = _arguments[i].c_str();
             _engines[name] = EnginePtr(
-                new OSPRayEngine(_arguments.size(), argv, _parametersManager));
+                new OSPRayEngine(_arguments.size(), argv, _parametersManager,
+                                 _performanceCounters));
             delete[] argv;
             return _engines[name];
         }
@@ -67,7 +70,8 @@ EnginePtr EngineFactory::get(const std::string& name)
             for (size_t i = 0; i < _arguments.size(); ++i)
                 argv[i] = _arguments[i].c_str();
             _engines[name] = EnginePtr(
-                new OptiXEngine(_arguments.size(), argv, _parametersManager));
+                new OptiXEngine(_arguments.size(), argv, _parametersManager,
+                                _performanceCounters));
             delete[] argv;
             return _engines[name];
         }
@@ -79,7 +83,8 @@ EnginePtr EngineFactory::get(const std::string& name)
             for (size_t i = 0; i < _arguments.size(); ++i)
                 argv[i] = const_cast<char*>(_arguments[i].c_str());
             _engines[name] = EnginePtr(
-                new LivreEngine(_arguments.size(), argv, _parametersManager));
+                new LivreEngine(_arguments.size(), argv, _parametersManager,
+                                _performanceCounters));
             delete[] argv;
             return _engines[name];
         }
@@ -22,6 +22,7 @@
 #define ENGINEFACTORY_H
 
 #include <brayns/common/types.h>
+#include <brayns/common/utils/PerformanceCounters.h>
 
 namespace brayns
 {
@@ -40,9 +41,12 @@ public:
      * @param argv Command line arguments
      * @param parametersManager Container for all parameters (application,
      *        rendering, geometry, scene)
+     * @param performanceCounters Timings shared by all engines, so that they
+     *        are kept when the engine is recreated
      */
     EngineFactory(int argc, const char** argv,
-                  ParametersManager& parametersManager);
+                  ParametersManager& parametersManager,
+                  PerformanceCounters& performanceCounters);
     ~EngineFactory() {}
     /**
      * @brief Gets the instance of the engine corresponding the given name. If
@@ -63,6 +67,7 @@ public:
 private:
     strings _arguments;
     ParametersManager& _parametersManager;
+    PerformanceCounters& _performanceCounters;
     EngineMap _engines;
 };
 }
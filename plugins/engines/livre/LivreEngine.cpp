@@ -43,8 +43,9 @@
 namespace brayns
 {
 LivreEngine::LivreEngine(int argc, char** argv,
-                         ParametersManager& parametersManager)
-    : Engine(parametersManager)
+                         ParametersManager& parametersManager,
+                         PerformanceCounters& performanceCounters)
+    : Engine(parametersManager, performanceCounters)
 {
     // force offscreen rendering
     ::setenv("EQ_WINDOW_IATTR_HINT_DRAWABLE", "-12" /*FBO*/, 1 /*overwrite*/);
@@ -142,6 +143,7 @@ void LivreEngine::commit()
 {
     Engine::commit();
     _renderers[_activeRenderer]->commit();
+    _frameBuffer->clear();
 }
 
 void LivreEngine::render()
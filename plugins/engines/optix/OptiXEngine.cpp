@@ -31,8 +31,9 @@
 namespace brayns
 {
 OptiXEngine::OptiXEngine(int, const char**,
-                         ParametersManager& parametersManager)
-    : Engine(parametersManager)
+                         ParametersManager& parametersManager,
+                         PerformanceCounters& performanceCounters)
+    : Engine(parametersManager, performanceCounters)
     , _context(nullptr)
 {
     BRAYNS_INFO << "Initializing OptiX" << std::endl;
@@ -157,6 +158,7 @@ void OptiXEngine::commit()
         _renderers[renderer.first]->commit();
     }
     _camera->commit();
+    _frameBuffer->clear();
 }
 
 void OptiXEngine::render()
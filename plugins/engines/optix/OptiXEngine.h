@@ -36,7 +36,8 @@ class OptiXEngine : public Engine
 {
 public:
     OptiXEngine(int argc, const char** argv,
-                ParametersManager& parametersManager);
+                ParametersManager& parametersManager,
+                PerformanceCounters& performanceCounters);
 
     ~OptiXEngine();
 
@@ -118,6 +118,8 @@ void OptiXScene::reset()
     // Geometry
     _geometryInstances.clear();
     _geometryGroup = nullptr;
+    _instances.clear();
+    _optixInstancedModels.clear();
 
     // Volume
     _volumeBuffer = nullptr;
@@ -195,8 +197,29 @@ void OptiXScene::commit()
                 << _geometryGroup->getAcceleration()->getDataSize()
                 << std::endl;
 
-    _context["top_object"]->set(_geometryGroup);
-    _context["top_shadower"]->set(_geometryGroup);
+    if (_instances.empty())
+    {
+        _context["top_object"]->set(_geometryGroup);
+        _context["top_shadower"]->set(_geometryGroup);
+    }
+    else
+    {
+        // Instanced models are placed next to the scene geometry by
+        // transform nodes sharing the same geometry group
+        optix::Group group = _context->createGroup();
+        group->setAcceleration(
+            _context->createAcceleration(_accelerationStructure,
+                                         _accelerationStructure));
+        group->setChildCount(_instances.size() + 1);
+        group->setChild(0, _geometryGroup);
+        for (size_t i = 0; i < _instances.size(); ++i)
+            group->setChild(i + 1, _instances[i]);
+
+        BRAYNS_INFO << "Adding " << _instances.size() << " instances"
+                    << std::endl;
+        _context["top_object"]->set(group);
+        _context["top_shadower"]->set(group);
+    }
 
     _context->validate();
 }
@@ -449,10 +472,203 @@ uint64_t OptiXScene::serializeGeometry()
         _cylindersDirty ? _serializeCylinders() : 0;
     const uint64_t conesMemSize = _conesDirty ? _serializeCones() : 0;
 
+    const uint64_t instancesMemSize =
+        _instancedModelsDirty ? _buildInstancedModels() : 0;
+
     _spheresDirty = false;
     _cylindersDirty = false;
     _conesDirty = false;
-    return spheresMemSize + cylindersMemSize + conesMemSize;
+    _instancedModelsDirty = false;
+    return spheresMemSize + cylindersMemSize + conesMemSize +
+           instancesMemSize;
+}
+
+template <typename PrimitivesMap>
+void OptiXScene::_createPrimitivesGeometry(
+    const PrimitivesMap& primitivesMap, optix::Program boundsProgram,
+    optix::Program intersectProgram, const std::string& bufferName,
+    std::vector<optix::GeometryInstance>& geometryInstances, uint64_t& memSize)
+{
+    for (const auto& primitives : primitivesMap)
+    {
+        const size_t materialId = primitives.first;
+        if (primitives.second.empty() || materialId >= _optixMaterials.size())
+            continue;
+
+        floats data;
+        for (const auto& primitive : primitives.second)
+            primitive->serializeData(data);
+
+        optix::Geometry geometry = _context->createGeometry();
+        geometry->setPrimitiveCount(primitives.second.size());
+        geometry->setBoundingBoxProgram(boundsProgram);
+        geometry->setIntersectionProgram(intersectProgram);
+        optix::Buffer buffer =
+            _context->createBuffer(RT_BUFFER_INPUT, RT_FORMAT_FLOAT,
+                                   data.size());
+        memcpy(buffer->map(), data.data(), data.size() * sizeof(float));
+        buffer->unmap();
+        geometry[bufferName]->setBuffer(buffer);
+        geometryInstances.push_back(_context->createGeometryInstance(
+            geometry, &_optixMaterials[materialId],
+            &_optixMaterials[materialId] + 1));
+        memSize += _getBvhSize(data.size() * sizeof(float));
+    }
+}
+
+uint64_t OptiXScene::_buildInstancedModels()
+{
+    _instances.clear();
+
+    // Models that were removed or replaced since the last build are released,
+    // the others keep their geometry group
+    for (auto it = _optixInstancedModels.begin();
+         it != _optixInstancedModels.end();)
+    {
+        const auto model = _instancedModels.find(it->first);
+        if (model == _instancedModels.end() ||
+            model->second != it->second.source)
+            it = _optixInstancedModels.erase(it);
+        else
+            ++it;
+    }
+
+    uint64_t memSize = 0;
+    size_t totalNbInstances = 0;
+    for (const auto& instancedModel : _instancedModels)
+    {
+        auto& model = *instancedModel.second;
+        if (model.getInstances().empty())
+            continue;
+
+        // The geometry of the model is built once in its own group
+        auto& optixModel = _optixInstancedModels[instancedModel.first];
+        if (optixModel.source != instancedModel.second)
+        {
+            optixModel.source = instancedModel.second;
+            optixModel.group = nullptr;
+
+            std::vector<optix::GeometryInstance> geometryInstances;
+            _createPrimitivesGeometry(model.getSpheres(),
+                                      _spheresBoundsProgram,
+                                      _spheresIntersectProgram, "spheres",
+                                      geometryInstances, memSize);
+            _createPrimitivesGeometry(model.getCylinders(),
+                                      _cylindersBoundsProgram,
+                                      _cylindersIntersectProgram, "cylinders",
+                                      geometryInstances, memSize);
+            _createPrimitivesGeometry(model.getCones(), _conesBoundsProgram,
+                                      _conesIntersectProgram, "cones",
+                                      geometryInstances, memSize);
+
+            optix::Geometry mesh =
+                _createMeshGeometry(model.getTriangleMeshes(), memSize);
+            if (mesh)
+                geometryInstances.push_back(_context->createGeometryInstance(
+                    mesh, &_optixMaterials[0],
+                    &_optixMaterials[0] + _optixMaterials.size()));
+
+            if (!geometryInstances.empty())
+            {
+                optixModel.group = _context->createGeometryGroup();
+                optixModel.group->setAcceleration(
+                    _context->createAcceleration(_accelerationStructure,
+                                                 _accelerationStructure));
+                optixModel.group->setChildCount(geometryInstances.size());
+                for (size_t i = 0; i < geometryInstances.size(); ++i)
+                    optixModel.group->setChild(i, geometryInstances[i]);
+            }
+        }
+        if (!optixModel.group)
+            continue;
+
+        // Instances only hold a reference to the group and a transformation
+        for (const auto& transformation : model.getInstances())
+        {
+            float matrix[16];
+            for (size_t row = 0; row < 4; ++row)
+                for (size_t column = 0; column < 4; ++column)
+                    matrix[row * 4 + column] = transformation(row, column);
+
+            optix::Transform transform = _context->createTransform();
+            transform->setMatrix(false, matrix, nullptr);
+            transform->setChild(optixModel.group);
+            _instances.push_back(transform);
+        }
+        totalNbInstances += model.getInstances().size();
+    }
+
+    BRAYNS_DEBUG << "- Instances : " << totalNbInstances << " [" << memSize
+                 << " bytes]" << std::endl;
+    return memSize;
+}
+
+optix::Geometry OptiXScene::_createMeshGeometry(TrianglesMeshMap& meshes,
+                                                uint64_t& memSize)
+{
+    Vector3fs vertices;
+    Vector3uis indices;
+    Vector3fs normals;
+    Vector2fs texCoords;
+    ints materials;
+    for (auto& trianglesMesh : meshes)
+    {
+        const size_t materialId = trianglesMesh.first;
+        auto& mesh = trianglesMesh.second;
+        if (mesh.getIndices().empty() || materialId >= _optixMaterials.size())
+            continue;
+
+        const uint32_t offset = vertices.size();
+        for (auto index : mesh.getIndices())
+        {
+            index += offset;
+            indices.push_back(index);
+            materials.push_back(materialId);
+        }
+        vertices.insert(vertices.end(), mesh.getVertices().begin(),
+                        mesh.getVertices().end());
+        normals.insert(normals.end(), mesh.getNormals().begin(),
+                       mesh.getNormals().end());
+        texCoords.insert(texCoords.end(),
+                         mesh.getTextureCoordinates().begin(),
+                         mesh.getTextureCoordinates().end());
+    }
+    if (indices.empty())
+        return nullptr;
+
+    // Buffers are attached to the geometry, and hide the ones of the
+    // context that hold the scene meshes
+    optix::Geometry geometry = _context->createGeometry();
+    geometry->setIntersectionProgram(_meshIntersectProgram);
+    geometry->setBoundingBoxProgram(_meshBoundsProgram);
+    geometry->setPrimitiveCount(indices.size());
+
+    const auto setBuffer = [&](const std::string& name, RTformat format,
+                               const void* data, const size_t size,
+                               const size_t elementSize) {
+        optix::Buffer buffer =
+            _context->createBuffer(RT_BUFFER_INPUT, format, size);
+        if (size != 0)
+        {
+            memcpy(buffer->map(), data, size * elementSize);
+            buffer->unmap();
+        }
+        geometry[name]->setBuffer(buffer);
+        memSize += size * elementSize;
+    };
+    setBuffer("vertices_buffer", RT_FORMAT_FLOAT3, vertices.data(),
+              vertices.size(), 3 * sizeof(float));
+    setBuffer("indices_buffer", RT_FORMAT_INT3, indices.data(), indices.size(),
+              3 * sizeof(int));
+    setBuffer("normal_buffer", RT_FORMAT_FLOAT3, normals.data(),
+              normals.size(), 3 * sizeof(float));
+    setBuffer("texcoord_buffer", RT_FORMAT_FLOAT2, texCoords.data(),
+              texCoords.size(), 2 * sizeof(float));
+    setBuffer("material_buffer", RT_FORMAT_INT, materials.data(),
+              materials.size(), sizeof(int));
+
+    memSize += _getBvhSize(indices.size());
+    return geometry;
 }
 
 uint64_t OptiXScene::_processMeshes()
@@ -95,10 +95,28 @@ private:
     uint64_t _serializeCylinders();
     uint64_t _serializeCones();
     uint64_t _processMeshes();
+    uint64_t _buildInstancedModels();
+    template <typename PrimitivesMap>
+    void _createPrimitivesGeometry(
+        const PrimitivesMap& primitivesMap, optix::Program boundsProgram,
+        optix::Program intersectProgram, const std::string& bufferName,
+        std::vector<optix::GeometryInstance>& geometryInstances,
+        uint64_t& memSize);
+    optix::Geometry _createMeshGeometry(TrianglesMeshMap& meshes,
+                                        uint64_t& memSize);
 
     optix::Context& _context;
     optix::GeometryGroup _geometryGroup;
     std::vector<optix::GeometryInstance> _geometryInstances;
+    std::vector<optix::Transform> _instances;
+
+    /** Geometry group of an instanced model, shared by all its instances */
+    struct OptiXInstancedModel
+    {
+        InstancedModelPtr source;
+        optix::GeometryGroup group;
+    };
+    std::map<std::string, OptiXInstancedModel> _optixInstancedModels;
     std::vector<optix::Material> _optixMaterials;
     optix::Buffer _lightBuffer;
     std::vector<BasicLight> _optixLights;
@@ -23,10 +23,17 @@
 #include <brayns/common/log.h>
 #include <ospray/SDK/common/OSPCommon.h>
 
+namespace
+{
+// Vertical field of view of OSPRay cameras when none is set
+const float OSPRAY_DEFAULT_FIELD_OF_VIEW = 60.f;
+}
+
 namespace brayns
 {
 OSPRayCamera::OSPRayCamera(const CameraType cameraType)
     : Camera(cameraType)
+    , _committed(false)
 {
     std::string cameraAsString;
     switch (getType())
@@ -48,6 +55,10 @@ OSPRayCamera::OSPRayCamera(const CameraType cameraType)
         break;
     }
     _camera = ospNewCamera(cameraAsString.c_str());
+
+    // Images keep being rendered with OSPRay's field of view, which picking
+    // rays get from getFieldOfView()
+    setFieldOfView(OSPRAY_DEFAULT_FIELD_OF_VIEW);
 }
 
 void OSPRayCamera::commit()
@@ -56,18 +67,53 @@ void OSPRayCamera::commit()
     const auto& target = getTarget();
     const auto dir = normalize(target - position);
     const auto& up = getUp();
+    const auto& windowStart = getWindowStart();
+    const auto& windowEnd = getWindowEnd();
+    const auto& clipPlanes = getClipPlanes();
+
+    floats attributes = {position.x(),
+                         position.y(),
+                         position.z(),
+                         dir.x(),
+                         dir.y(),
+                         dir.z(),
+                         up.x(),
+                         up.y(),
+                         up.z(),
+                         getAspectRatio(),
+                         getFieldOfView(),
+                         getAperture(),
+                         getFocalLength(),
+                         float(getStereoMode()),
+                         getEyeSeparation(),
+                         windowStart.x(),
+                         windowStart.y(),
+                         windowEnd.x(),
+                         windowEnd.y()};
+    if (clipPlanes.size() == 6)
+        for (const auto& clipPlane : clipPlanes)
+            attributes.insert(attributes.end(),
+                              {clipPlane.x(), clipPlane.y(), clipPlane.z(),
+                               clipPlane.w()});
+
+    if (attributes == _committedAttributes)
+        return;
 
     ospSet3f(_camera, "pos", position.x(), position.y(), position.z());
     ospSet3f(_camera, "dir", dir.x(), dir.y(), dir.z());
     ospSet3f(_camera, "up", up.x(), up.y(), up.z());
     ospSet1f(_camera, "aspect", getAspectRatio());
+    ospSet1f(_camera, "fovy", getFieldOfView());
     ospSet1f(_camera, "apertureRadius", getAperture());
     ospSet1f(_camera, "focusDistance", getFocalLength());
     ospSet1i(_camera, "stereoMode", static_cast<uint>(getStereoMode()));
     ospSet1f(_camera, "interpupillaryDistance", getEyeSeparation());
 
+    // Region of the image plane covered by the frame buffer
+    ospSet2f(_camera, "imageStart", windowStart.x(), windowStart.y());
+    ospSet2f(_camera, "imageEnd", windowEnd.x(), windowEnd.y());
+
     // Clip planes
-    const auto& clipPlanes = getClipPlanes();
     if (clipPlanes.size() == 6)
     {
         const std::string clipPlaneNames[6] = {"clipPlane1", "clipPlane2",
@@ -81,6 +127,8 @@ void OSPRayCamera::commit()
         }
     }
     ospCommit(_camera);
+    _committedAttributes.swap(attributes);
+    _committed = true;
 }
 
 void OSPRayCamera::setEnvironmentMap(const bool)
@@ -38,10 +38,19 @@ public:
 
     /**
        Commits the changes held by the camera object so that
-       attributes become available to the OSPRay rendering engine
+       attributes become available to the OSPRay rendering engine. Nothing is
+       committed if the attributes did not change since the last commit.
     */
     void commit() final;
 
+    /**
+       @return true if attributes were committed to OSPRay since the last
+       resetCommitted(), in which case the rendered image changes
+    */
+    bool getCommitted() const { return _committed; }
+    /** Reset the committed flag */
+    void resetCommitted() { _committed = false; }
+
     /**
        Gets the OSPRay implementation of the camera object
        @return OSPRay implementation of the camera object
@@ -52,6 +61,8 @@ public:
 
 private:
     OSPCamera _camera;
+    floats _committedAttributes;
+    bool _committed;
 };
 }
 #endif // OSPRAYCAMERA_H
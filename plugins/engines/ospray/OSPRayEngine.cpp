@@ -27,11 +27,25 @@
 #include <plugins/engines/ospray/OSPRayRenderer.h>
 #include <plugins/engines/ospray/OSPRayScene.h>
 
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Resolution scales are multiples of this step, so that the reduced frame
+// buffer is not recreated for every small variation of the frame duration
+const float RESOLUTION_SCALE_STEP = 0.125f;
+// Delay without modification after which the full resolution is restored
+const std::chrono::milliseconds IDLE_DELAY(250);
+}
+
 namespace brayns
 {
 OSPRayEngine::OSPRayEngine(int argc, const char** argv,
-                           ParametersManager& parametersManager)
-    : Engine(parametersManager)
+                           ParametersManager& parametersManager,
+                           PerformanceCounters& performanceCounters)
+    : Engine(parametersManager, performanceCounters)
+    , _lastFrameDuration(0.f)
 {
     BRAYNS_INFO << "Initializing OSPRay" << std::endl;
     try
@@ -46,23 +60,15 @@ OSPRayEngine::OSPRayEngine(int argc, const char** argv,
                     << std::endl;
     }
 
-    BRAYNS_INFO << "Initializing renderers" << std::endl;
+    BRAYNS_INFO << "Initializing renderer" << std::endl;
     _activeRenderer = _parametersManager.getRenderingParameters().getRenderer();
+    _createRenderer(_activeRenderer);
 
-    Renderers renderersForScene;
-    for (const auto renderer :
-         parametersManager.getRenderingParameters().getRenderers())
-    {
-        const auto& rendererName =
-            parametersManager.getRenderingParameters().getRendererAsString(
-                renderer);
-        _renderers[renderer].reset(
-            new OSPRayRenderer(rendererName, _parametersManager));
-        renderersForScene.push_back(_renderers[renderer]);
-    }
-
+    // The scene only feeds the active renderer, other renderers are created
+    // and fed when they become active
     BRAYNS_INFO << "Initializing scene" << std::endl;
-    _scene.reset(new OSPRayScene(renderersForScene, _parametersManager));
+    _scene.reset(
+        new OSPRayScene({_renderers[_activeRenderer]}, _parametersManager));
 
     _scene->setMaterials(MT_DEFAULT, NB_MAX_MATERIALS);
 
@@ -76,6 +82,8 @@ OSPRayEngine::OSPRayEngine(int argc, const char** argv,
         new OSPRayFrameBuffer(_frameSize, FBF_RGBA_I8, accumulation));
     _camera.reset(new OSPRayCamera(
         _parametersManager.getRenderingParameters().getCameraType()));
+    _renderers[_activeRenderer]->setScene(_scene);
+    _renderers[_activeRenderer]->setCamera(_camera);
 
     BRAYNS_INFO << "Engine initialization complete" << std::endl;
 }
@@ -92,30 +100,143 @@ std::string OSPRayEngine::name() const
 void OSPRayEngine::commit()
 {
     Engine::commit();
-    for (const auto& renderer : _renderers)
-    {
-        _renderers[renderer.first]->setScene(_scene);
-        _renderers[renderer.first]->setCamera(_camera);
-        _renderers[renderer.first]->commit();
-    }
+    _renderers[_activeRenderer]->commit();
     _camera->commit();
 }
 
-void OSPRayEngine::render()
+void OSPRayEngine::setActiveRenderer(const RendererType renderer)
 {
+    if (_activeRenderer == renderer)
+        return;
+
+    const auto& parameters = _parametersManager.getRenderingParameters();
+    const auto& renderers = parameters.getRenderers();
+    if (std::find(renderers.begin(), renderers.end(), renderer) ==
+        renderers.end())
+    {
+        BRAYNS_ERROR << "Renderer " << parameters.getRendererAsString(renderer)
+                     << " is not available" << std::endl;
+        return;
+    }
+
+    _activeRenderer = renderer;
+    if (_renderers.find(renderer) == _renderers.end())
+        _createRenderer(renderer);
+
+    auto& activeRenderer = _renderers[renderer];
+    activeRenderer->setScene(_scene);
+    activeRenderer->setCamera(_camera);
+    static_cast<OSPRayRenderer*>(activeRenderer.get())->invalidate();
+
+    // The renderer missed the scene updates while it was inactive
+    _scene->getRenderers() = {activeRenderer};
+    static_cast<OSPRayScene*>(_scene.get())->invalidateFrameData();
+    _scene->commitLights();
+    _scene->commitMaterials();
+    _scene->commitTransferFunctionData();
     _scene->commitVolumeData();
     _scene->commitSimulationData();
-    _renderers[_activeRenderer]->commit();
-    _renderers[_activeRenderer]->render(_frameBuffer);
+}
+
+void OSPRayEngine::_createRenderer(const RendererType renderer)
+{
+    const auto& rendererName =
+        _parametersManager.getRenderingParameters().getRendererAsString(
+            renderer);
+    BRAYNS_INFO << "Creating " << rendererName << " renderer" << std::endl;
+    _renderers[renderer].reset(
+        new OSPRayRenderer(rendererName, _parametersManager));
+}
+
+void OSPRayEngine::render()
+{
+    {
+        PerformanceCounters::ScopedTimer timer(_performanceCounters,
+                                               counters::VOLUME_UPLOAD);
+        _scene->commitVolumeData();
+    }
+    {
+        PerformanceCounters::ScopedTimer timer(_performanceCounters,
+                                               counters::SIMULATION_UPLOAD);
+        _scene->commitSimulationData();
+    }
+
+    static_cast<OSPRayScene*>(_scene.get())->commitPendingTextures();
+
+    PerformanceCounters::ScopedTimer timer(_performanceCounters,
+                                           counters::RENDER);
+    // Renderer and camera commits only push what changed, and the
+    // accumulation is only restarted when the image is affected
+    auto& renderer = *_renderers[_activeRenderer];
+    renderer.commit();
+    auto& camera = static_cast<OSPRayCamera&>(*_camera);
+    const bool modified = renderer.getModified() || camera.getCommitted();
+    if (modified)
+    {
+        _frameBuffer->clear();
+        renderer.resetModified();
+        camera.resetCommitted();
+    }
+    _updateResolutionScale(modified);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    renderer.render(_frameBuffer);
+    const std::chrono::duration<float, std::milli> elapsed =
+        std::chrono::high_resolution_clock::now() - start;
+    _lastFrameDuration = elapsed.count();
+
+    static_cast<OSPRayFrameBuffer*>(_frameBuffer.get())->upscale();
+}
+
+void OSPRayEngine::_updateResolutionScale(const bool modified)
+{
+    auto& frameBuffer = static_cast<OSPRayFrameBuffer&>(*_frameBuffer);
+    const float targetFPS =
+        _parametersManager.getRenderingParameters().getTargetFPS();
+    if (targetFPS <= 0.f)
+    {
+        frameBuffer.setScale(1.f);
+        return;
+    }
+
+    const auto now = std::chrono::high_resolution_clock::now();
+    if (modified)
+        _lastModification = now;
+    else if (now - _lastModification > IDLE_DELAY)
+    {
+        frameBuffer.setScale(1.f);
+        return;
+    }
+    if (!modified || _lastFrameDuration <= 0.f)
+        return;
+
+    // The number of rendered pixels follows the square of the scale. The scale
+    // drops as soon as frames are too slow, and only grows by one step when
+    // frames are clearly faster than needed, so that it does not oscillate.
+    const float scale = frameBuffer.getScale();
+    const float estimate =
+        scale * std::sqrt(1000.f / targetFPS / _lastFrameDuration);
+    float newScale = scale;
+    if (estimate < scale)
+        newScale = std::floor(estimate / RESOLUTION_SCALE_STEP) *
+                   RESOLUTION_SCALE_STEP;
+    else if (estimate >= scale + 2.f * RESOLUTION_SCALE_STEP)
+        newScale = scale + RESOLUTION_SCALE_STEP;
+    frameBuffer.setScale(
+        std::max(RESOLUTION_SCALE_STEP, std::min(newScale, 1.f)));
 }
 
 void OSPRayEngine::preRender()
 {
+    PerformanceCounters::ScopedTimer timer(_performanceCounters,
+                                           counters::FRAME_BUFFER_MAP);
     _frameBuffer->map();
 }
 
 void OSPRayEngine::postRender()
 {
+    PerformanceCounters::ScopedTimer timer(_performanceCounters,
+                                           counters::FRAME_BUFFER_UNMAP);
     _frameBuffer->unmap();
 }
 }
@@ -23,6 +23,8 @@
 
 #include <brayns/common/engine/Engine.h>
 
+#include <chrono>
+
 namespace brayns
 {
 /**
@@ -32,7 +34,8 @@ class OSPRayEngine : public Engine
 {
 public:
     OSPRayEngine(int argc, const char** argv,
-                 ParametersManager& parametersManager);
+                 ParametersManager& parametersManager,
+                 PerformanceCounters& performanceCounters);
 
     ~OSPRayEngine();
 
@@ -42,7 +45,20 @@ public:
     /** @copydoc Engine::commit */
     void commit() final;
 
-    /** @copydoc Engine::render */
+    /**
+     * Renderers are created the first time they become active, and the
+     * scene data is then committed to the active renderer only.
+     * @copydoc Engine::setActiveRenderer
+     */
+    void setActiveRenderer(RendererType renderer) final;
+
+    /**
+     * With a target frame rate, images are rendered at a reduced resolution
+     * while the renderer is modified, e.g. while the camera moves. The
+     * resolution follows the measured frame duration, and the full resolution
+     * is restored with accumulation once nothing changed for a short delay.
+     * @copydoc Engine::render
+     */
     void render() final;
 
     /** @copydoc Engine::preRender */
@@ -50,6 +66,13 @@ public:
 
     /** @copydoc Engine::postRender */
     void postRender() final;
+
+private:
+    void _createRenderer(RendererType renderer);
+    void _updateResolutionScale(bool modified);
+
+    std::chrono::high_resolution_clock::time_point _lastModification;
+    float _lastFrameDuration;
 };
 }
 
@@ -21,8 +21,43 @@
 #include "OSPRayFrameBuffer.h"
 
 #include <brayns/common/log.h>
+#include <brayns/common/utils/MemoryRegistry.h>
 #include <ospray/SDK/common/OSPCommon.h>
 
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+OSPFrameBufferFormat toOSPFrameBufferFormat(
+    const brayns::FrameBufferFormat format)
+{
+    switch (format)
+    {
+    case brayns::FBF_RGBA_I8:
+        return OSP_FB_RGBA8;
+    case brayns::FBF_RGBA_F32:
+        return OSP_FB_RGBA32F;
+    default:
+        return OSP_FB_NONE;
+    }
+}
+
+/** @return the size in bytes of the color of a pixel */
+size_t getPixelSize(const brayns::FrameBufferFormat format)
+{
+    switch (format)
+    {
+    case brayns::FBF_RGBA_I8:
+        return 4;
+    case brayns::FBF_RGBA_F32:
+        return 4 * sizeof(float);
+    default:
+        return 0;
+    }
+}
+}
+
 namespace brayns
 {
 OSPRayFrameBuffer::OSPRayFrameBuffer(const Vector2ui& frameSize,
@@ -32,6 +67,8 @@ OSPRayFrameBuffer::OSPRayFrameBuffer(const Vector2ui& frameSize,
     , _frameBuffer(0)
     , _colorBuffer(0)
     , _depthBuffer(0)
+    , _scale(1.f)
+    , _scaledFrameBuffer(0)
 {
     resize(frameSize);
 }
@@ -39,6 +76,7 @@ OSPRayFrameBuffer::OSPRayFrameBuffer(const Vector2ui& frameSize,
 OSPRayFrameBuffer::~OSPRayFrameBuffer()
 {
     unmap();
+    _destroyScaledFrameBuffer();
     ospFreeFrameBuffer(_frameBuffer);
 }
 
@@ -52,19 +90,8 @@ void OSPRayFrameBuffer::resize(const Vector2ui& frameSize)
         ospFreeFrameBuffer(_frameBuffer);
     }
 
-    OSPFrameBufferFormat format;
-    switch (_frameBufferFormat)
-    {
-    case FBF_RGBA_I8:
-        format = OSP_FB_RGBA8;
-        break;
-    case FBF_RGBA_F32:
-        format = OSP_FB_RGBA32F;
-        break;
-    default:
-        format = OSP_FB_NONE;
-    }
-
+    const OSPFrameBufferFormat format =
+        toOSPFrameBufferFormat(_frameBufferFormat);
     osp::vec2i size = {_frameSize.x(), _frameSize.y()};
 
     size_t attributes = OSP_FB_COLOR | OSP_FB_DEPTH;
@@ -74,6 +101,9 @@ void OSPRayFrameBuffer::resize(const Vector2ui& frameSize)
     _frameBuffer = ospNewFrameBuffer(size, format, attributes);
     ospCommit(_frameBuffer);
     clear();
+
+    if (_scale < 1.f)
+        _createScaledFrameBuffer();
 }
 
 void OSPRayFrameBuffer::clear()
@@ -86,12 +116,26 @@ void OSPRayFrameBuffer::clear()
 
 void OSPRayFrameBuffer::map()
 {
+    // Images rendered at a reduced size are read from their upscaled copy
+    if (_scale < 1.f)
+    {
+        _colorBuffer = _upscaledColorBuffer.data();
+        _depthBuffer = _upscaledDepthBuffer.data();
+        return;
+    }
     _colorBuffer = (uint8_t*)ospMapFrameBuffer(_frameBuffer, OSP_FB_COLOR);
     _depthBuffer = (float*)ospMapFrameBuffer(_frameBuffer, OSP_FB_DEPTH);
 }
 
 void OSPRayFrameBuffer::unmap()
 {
+    if (_scale < 1.f)
+    {
+        _colorBuffer = 0;
+        _depthBuffer = 0;
+        return;
+    }
+
     if (_colorBuffer)
     {
         ospUnmapFrameBuffer(_colorBuffer, _frameBuffer);
@@ -104,4 +148,112 @@ void OSPRayFrameBuffer::unmap()
         _depthBuffer = 0;
     }
 }
+
+MemoryUsage OSPRayFrameBuffer::getMemoryUsage() const
+{
+    MemoryUsage usage = FrameBuffer::getMemoryUsage();
+    if (_scale < 1.f)
+    {
+        const uint64_t scaledPixels = uint64_t(_scaledSize.x()) *
+                                      _scaledSize.y();
+        MemoryUsage scaledUsage;
+        scaledUsage.reserved =
+            scaledPixels * (getPixelSize(_frameBufferFormat) + sizeof(float)) +
+            _upscaledColorBuffer.capacity() +
+            _upscaledDepthBuffer.capacity() * sizeof(float);
+        scaledUsage.resident = scaledUsage.reserved;
+        usage += scaledUsage;
+    }
+    return usage;
+}
+
+void OSPRayFrameBuffer::setScale(const float scale)
+{
+    const float newScale = std::max(0.f, std::min(scale, 1.f));
+    if (newScale == _scale)
+        return;
+
+    // The frame buffer may be mapped when the scale changes
+    const bool mapped = _colorBuffer != 0;
+    if (mapped)
+        unmap();
+
+    _scale = newScale;
+    if (_scale < 1.f)
+        _createScaledFrameBuffer();
+    else
+    {
+        _destroyScaledFrameBuffer();
+        clear();
+    }
+
+    if (mapped)
+        map();
+}
+
+void OSPRayFrameBuffer::upscale()
+{
+    if (_scale >= 1.f)
+        return;
+
+    const auto colors = static_cast<const uint8_t*>(
+        ospMapFrameBuffer(_scaledFrameBuffer, OSP_FB_COLOR));
+    const auto depths = static_cast<const float*>(
+        ospMapFrameBuffer(_scaledFrameBuffer, OSP_FB_DEPTH));
+
+    // Nearest neighbour, which keeps the cost of upscaling well below the cost
+    // of rendering the pixels it saves
+    const size_t pixelSize = getPixelSize(_frameBufferFormat);
+    const size_t width = _frameSize.x();
+    const size_t height = _frameSize.y();
+#pragma omp parallel for
+    for (int y = 0; y < int(height); ++y)
+    {
+        const size_t scaledY = size_t(y) * _scaledSize.y() / height;
+        for (size_t x = 0; x < width; ++x)
+        {
+            const size_t scaledX = x * _scaledSize.x() / width;
+            const size_t from = scaledY * _scaledSize.x() + scaledX;
+            const size_t to = size_t(y) * width + x;
+            memcpy(&_upscaledColorBuffer[to * pixelSize],
+                   &colors[from * pixelSize], pixelSize);
+            _upscaledDepthBuffer[to] = depths[from];
+        }
+    }
+
+    ospUnmapFrameBuffer(colors, _scaledFrameBuffer);
+    ospUnmapFrameBuffer(depths, _scaledFrameBuffer);
+}
+
+void OSPRayFrameBuffer::_createScaledFrameBuffer()
+{
+    const Vector2ui scaledSize(
+        std::max(1u, static_cast<unsigned int>(_frameSize.x() * _scale)),
+        std::max(1u, static_cast<unsigned int>(_frameSize.y() * _scale)));
+    const size_t nbPixels = size_t(_frameSize.x()) * _frameSize.y();
+    if (_scaledFrameBuffer && scaledSize == _scaledSize &&
+        _upscaledDepthBuffer.size() == nbPixels)
+        return;
+
+    _destroyScaledFrameBuffer();
+    _scaledSize = scaledSize;
+    osp::vec2i size = {int(_scaledSize.x()), int(_scaledSize.y())};
+    _scaledFrameBuffer =
+        ospNewFrameBuffer(size, toOSPFrameBufferFormat(_frameBufferFormat),
+                          OSP_FB_COLOR | OSP_FB_DEPTH);
+    ospCommit(_scaledFrameBuffer);
+
+    _upscaledColorBuffer.resize(nbPixels * getPixelSize(_frameBufferFormat));
+    _upscaledDepthBuffer.resize(nbPixels);
+}
+
+void OSPRayFrameBuffer::_destroyScaledFrameBuffer()
+{
+    if (_scaledFrameBuffer)
+        ospFreeFrameBuffer(_scaledFrameBuffer);
+    _scaledFrameBuffer = 0;
+    _scaledSize = Vector2ui(0, 0);
+    uint8_ts().swap(_upscaledColorBuffer);
+    floats().swap(_upscaledDepthBuffer);
+}
 }
@@ -40,11 +40,37 @@ public:
 
     uint8_t* getColorBuffer() final { return _colorBuffer; }
     float* getDepthBuffer() final { return _depthBuffer; }
-    OSPFrameBuffer impl() { return _frameBuffer; }
+    MemoryUsage getMemoryUsage() const final;
+
+    /**
+     * Sets the fraction of the frame size at which images are rendered. Below
+     * 1, images are rendered without accumulation into a smaller frame buffer,
+     * and upscale() copies them to the frame size.
+     */
+    void setScale(float scale);
+    float getScale() const final { return _scale; }
+    /** Upscales the image rendered at a reduced size to the frame size */
+    void upscale();
+
+    /** @return the frame buffer to render into */
+    OSPFrameBuffer impl()
+    {
+        return _scale < 1.f ? _scaledFrameBuffer : _frameBuffer;
+    }
+
 private:
+    void _createScaledFrameBuffer();
+    void _destroyScaledFrameBuffer();
+
     OSPFrameBuffer _frameBuffer;
     uint8_t* _colorBuffer;
     float* _depthBuffer;
+
+    float _scale;
+    Vector2ui _scaledSize;
+    OSPFrameBuffer _scaledFrameBuffer;
+    uint8_ts _upscaledColorBuffer;
+    floats _upscaledDepthBuffer;
 };
 }
 #endif // OSPRAYFRAMEBUFFER_H
@@ -43,6 +43,10 @@ OSPRayRenderer::OSPRayRenderer(const std::string& name,
     : Renderer(parametersManager)
     , _name(name)
     , _camera(0)
+    , _timestamp(0.f)
+    , _model(0)
+    , _ospCamera(0)
+    , _committed(false)
 {
     RenderingParameters& rp = _parametersManager.getRenderingParameters();
     if (rp.getModule() != "")
@@ -60,55 +64,143 @@ void OSPRayRenderer::render(FrameBufferPtr frameBuffer)
                    OSP_FB_COLOR | OSP_FB_DEPTH | OSP_FB_ACCUM);
 }
 
+bool OSPRayRenderer::Settings::operator==(const Settings& rhs) const
+{
+    return backgroundColor == rhs.backgroundColor && shadows == rhs.shadows &&
+           softShadows == rhs.softShadows &&
+           ambientOcclusionStrength == rhs.ambientOcclusionStrength &&
+           shading == rhs.shading && spp == rhs.spp && epsilon == rhs.epsilon &&
+           detectionDistance == rhs.detectionDistance &&
+           detectionOnDifferentMaterial == rhs.detectionOnDifferentMaterial &&
+           detectionNearColor == rhs.detectionNearColor &&
+           detectionFarColor == rhs.detectionFarColor;
+}
+
 void OSPRayRenderer::commit()
 {
     RenderingParameters& rp = _parametersManager.getRenderingParameters();
     SceneParameters& sp = _parametersManager.getSceneParameters();
-    ShadingType mt = rp.getShading();
-
-    Vector3f color = rp.getBackgroundColor();
-    ospSet3f(_renderer, "bgColor", color.x(), color.y(), color.z());
-    ospSet1i(_renderer, "shadowsEnabled", rp.getShadows());
-    ospSet1i(_renderer, "softShadowsEnabled", rp.getSoftShadows());
-    ospSet1f(_renderer, "ambientOcclusionStrength",
-             rp.getAmbientOcclusionStrength());
-
-    ospSet1i(_renderer, "shadingEnabled", (mt == ShadingType::diffuse));
-    ospSet1f(_renderer, "timestamp", sp.getTimestamp());
-    ospSet1i(_renderer, "randomNumber", rand() % 10000);
-    ospSet1i(_renderer, "spp", rp.getSamplesPerPixel());
-    ospSet1i(_renderer, "electronShading", (mt == ShadingType::electron));
-    ospSet1f(_renderer, "epsilon", rp.getEpsilon());
-    ospSet1i(_renderer, "moving", false);
-    ospSet1f(_renderer, "detectionDistance", rp.getDetectionDistance());
-    ospSet1i(_renderer, "detectionOnDifferentMaterial",
-             rp.getDetectionOnDifferentMaterial());
-    color = rp.getDetectionNearColor();
-    ospSet3f(_renderer, "detectionNearColor", color.x(), color.y(), color.z());
-    color = rp.getDetectionFarColor();
-    ospSet3f(_renderer, "detectionFarColor", color.x(), color.y(), color.z());
-    ospSet1i(_renderer, "materialForSimulation", MATERIAL_SIMULATION);
 
     OSPRayScene* osprayScene = static_cast<OSPRayScene*>(_scene.get());
     assert(osprayScene);
 
-    const float ts =
-        _scene->getParametersManager().getSceneParameters().getTimestamp();
+    // Clip planes of the camera apply to all rays, and optionally remove the
+    // geometry they entirely clip from the model
+    ClipPlanes clipPlanes;
+    if (_camera && _camera->getType() == CameraType::clipped &&
+        _camera->getClipPlanes().size() == 6)
+        clipPlanes = _camera->getClipPlanes();
+    osprayScene->cullGeometry(rp.getClipCulling() ? clipPlanes : ClipPlanes());
+    osprayScene->commitCulledModel();
+
+    const float ts = sp.getTimestamp();
     const auto model = osprayScene->modelImpl(ts);
-    if (model)
+    if (!model)
+    {
+        BRAYNS_ERROR << "No model found for timestamp " << ts << std::endl;
+        return;
+    }
+
+    const Settings settings = {rp.getBackgroundColor(),
+                               rp.getShadows(),
+                               rp.getSoftShadows(),
+                               rp.getAmbientOcclusionStrength(),
+                               rp.getShading(),
+                               rp.getSamplesPerPixel(),
+                               rp.getEpsilon(),
+                               rp.getDetectionDistance(),
+                               rp.getDetectionOnDifferentMaterial(),
+                               rp.getDetectionNearColor(),
+                               rp.getDetectionFarColor()};
+
+    bool modified = false;
+    if (!_committed || !(settings == _settings))
+    {
+        const ShadingType mt = settings.shading;
+        Vector3f color = settings.backgroundColor;
+        ospSet3f(_renderer, "bgColor", color.x(), color.y(), color.z());
+        ospSet1i(_renderer, "shadowsEnabled", settings.shadows);
+        ospSet1i(_renderer, "softShadowsEnabled", settings.softShadows);
+        ospSet1f(_renderer, "ambientOcclusionStrength",
+                 settings.ambientOcclusionStrength);
+        ospSet1i(_renderer, "shadingEnabled", (mt == ShadingType::diffuse));
+        ospSet1i(_renderer, "spp", settings.spp);
+        ospSet1i(_renderer, "electronShading", (mt == ShadingType::electron));
+        ospSet1f(_renderer, "epsilon", settings.epsilon);
+        ospSet1i(_renderer, "moving", false);
+        ospSet1f(_renderer, "detectionDistance", settings.detectionDistance);
+        ospSet1i(_renderer, "detectionOnDifferentMaterial",
+                 settings.detectionOnDifferentMaterial);
+        color = settings.detectionNearColor;
+        ospSet3f(_renderer, "detectionNearColor", color.x(), color.y(),
+                 color.z());
+        color = settings.detectionFarColor;
+        ospSet3f(_renderer, "detectionFarColor", color.x(), color.y(),
+                 color.z());
+        ospSet1i(_renderer, "materialForSimulation", MATERIAL_SIMULATION);
+        _settings = settings;
+        modified = true;
+    }
+
+    // The timestamp only affects the image of time dependent scenes
+    if (!_committed || (ts != _timestamp && osprayScene->isTimeDependent()))
+    {
+        ospSet1f(_renderer, "timestamp", ts);
+        _timestamp = ts;
+        modified = true;
+    }
+
+    if (!_committed || clipPlanes != _clipPlanes)
+    {
+        OSPData data = nullptr;
+        if (!clipPlanes.empty())
+        {
+            floats values;
+            for (const auto& plane : clipPlanes)
+                values.insert(values.end(),
+                              {plane.x(), plane.y(), plane.z(), plane.w()});
+            data = ospNewData(clipPlanes.size(), OSP_FLOAT4, values.data());
+        }
+        ospSetData(_renderer, "clipPlanes", data);
+        if (data)
+            ospRelease(data);
+        _clipPlanes = clipPlanes;
+        modified = true;
+    }
+
+    if (!_committed || *model != _model)
     {
         ospSetObject(_renderer, "world", *model);
-        ospCommit(_renderer);
+        _model = *model;
+        modified = true;
     }
-    else
-        BRAYNS_ERROR << "No model found for timestamp " << ts << std::endl;
+
+    const OSPCamera camera = _camera ? _camera->impl() : nullptr;
+    if (camera && (!_committed || camera != _ospCamera))
+    {
+        ospSetObject(_renderer, "camera", camera);
+        _ospCamera = camera;
+        modified = true;
+    }
+
+    if (!modified)
+        return;
+
+    ospSet1i(_renderer, "randomNumber", rand() % 10000);
+    ospCommit(_renderer);
+    _committed = true;
+    _modified = true;
+}
+
+void OSPRayRenderer::invalidate()
+{
+    _committed = false;
 }
 
 void OSPRayRenderer::setCamera(CameraPtr camera)
 {
+    // The camera is attached to the renderer by the next commit
     _camera = static_cast<OSPRayCamera*>(camera.get());
     assert(_camera);
-    ospSetObject(_renderer, "camera", _camera->impl());
-    ospCommit(_renderer);
 }
 }
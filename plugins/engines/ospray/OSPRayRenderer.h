@@ -37,16 +37,50 @@ public:
                    ParametersManager& parametersMamager);
 
     void render(FrameBufferPtr frameBuffer) final;
+
+    /**
+     * Commits the rendering parameters, the camera and the model of the
+     * current timestamp to OSPRay. Only the groups of parameters that changed
+     * since the last commit are set, and nothing is committed if none of them
+     * changed. The renderer is then flagged as modified.
+     */
     void commit() final;
 
+    /** Forces the next commit, e.g. when the renderer becomes active again */
+    void invalidate();
+
     void setCamera(CameraPtr camera) final;
 
     const std::string& getName() const { return _name; }
     OSPRenderer impl() const { return _renderer; }
 private:
+    /** Rendering settings, as last committed */
+    struct Settings
+    {
+        Vector3f backgroundColor;
+        bool shadows;
+        bool softShadows;
+        float ambientOcclusionStrength;
+        ShadingType shading;
+        size_t spp;
+        float epsilon;
+        float detectionDistance;
+        bool detectionOnDifferentMaterial;
+        Vector3f detectionNearColor;
+        Vector3f detectionFarColor;
+
+        bool operator==(const Settings& rhs) const;
+    };
+
     std::string _name;
     OSPRayCamera* _camera;
     OSPRenderer _renderer;
+    Settings _settings;
+    float _timestamp;
+    OSPModel _model;
+    OSPCamera _ospCamera;
+    ClipPlanes _clipPlanes;
+    bool _committed;
 };
 }
 
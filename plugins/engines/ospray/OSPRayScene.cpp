@@ -26,6 +26,7 @@
 #include <brayns/common/log.h>
 #include <brayns/common/material/Texture2D.h>
 #include <brayns/common/simulation/AbstractSimulationHandler.h>
+#include <brayns/common/utils/MemoryRegistry.h>
 #include <brayns/common/volume/VolumeHandler.h>
 #include <brayns/io/TextureLoader.h>
 #include <brayns/parameters/GeometryParameters.h>
@@ -33,6 +34,58 @@
 
 #include <boost/algorithm/string/predicate.hpp> // ends_with
 
+#include <chrono>
+#include <limits>
+#include <set>
+
+namespace
+{
+/**
+ * @return true if the spheres bounding both ends of a primitive lie entirely on
+ * the removed side of the same clip plane
+ */
+bool isClipped(const brayns::ClipPlanes& clipPlanes, const float* begin,
+               const float beginRadius, const float* end,
+               const float endRadius)
+{
+    for (const auto& plane : clipPlanes)
+    {
+        const float beginDistance = plane.x() * begin[0] +
+                                    plane.y() * begin[1] +
+                                    plane.z() * begin[2] + plane.w();
+        const float endDistance = plane.x() * end[0] + plane.y() * end[1] +
+                                  plane.z() * end[2] + plane.w();
+        if (beginDistance + beginRadius < 0.f && endDistance + endRadius < 0.f)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @return the serialized primitives that are not clipped
+ * @param stride Number of floats per primitive
+ * @param endOffset Offset of the end of the primitive, 0 for spheres
+ * @param radiusOffset Offset of the radius at the beginning of the primitive
+ * @param endRadiusOffset Offset of the radius at its end
+ */
+brayns::floats cullPrimitives(const brayns::ClipPlanes& clipPlanes,
+                              const brayns::floats& data, const size_t stride,
+                              const size_t endOffset,
+                              const size_t radiusOffset,
+                              const size_t endRadiusOffset)
+{
+    brayns::floats culled;
+    for (size_t i = 0; i + stride <= data.size(); i += stride)
+    {
+        const float* primitive = &data[i];
+        if (!isClipped(clipPlanes, primitive, primitive[radiusOffset],
+                       primitive + endOffset, primitive[endRadiusOffset]))
+            culled.insert(culled.end(), primitive, primitive + stride);
+    }
+    return culled;
+}
+}
+
 namespace brayns
 {
 const size_t CACHE_VERSION = 6;
@@ -57,13 +110,23 @@ OSPRayScene::OSPRayScene(Renderers renderers,
     , _ospSimulationData(0)
     , _ospTransferFunctionDiffuseData(0)
     , _ospTransferFunctionEmissionData(0)
+    , _culledModel(0)
+    , _culledGeometrySize(0)
 {
+    invalidateFrameData();
 }
 
 void OSPRayScene::reset()
 {
     Scene::reset();
 
+    _invalidateCulling();
+    _removeInstances();
+    for (const auto& ospModel : _ospInstancedModels)
+        ospRelease(ospModel.second.model);
+    _ospInstancedModels.clear();
+    invalidateFrameData();
+
     for (const auto& model : _models)
     {
         for (size_t materialId = 0; materialId < _materials.size();
@@ -81,6 +144,7 @@ void OSPRayScene::reset()
 
     _ospMaterials.clear();
     _ospTextures.clear();
+    _pendingTextures.clear();
     _ospLights.clear();
 
     _serializedSpheresData.clear();
@@ -101,8 +165,78 @@ void OSPRayScene::commit()
         ospCommit(model.second);
 }
 
+void OSPRayScene::setSphereCenters(const size_t materialId,
+                                   const Vector3f* centers,
+                                   const size_t nbCenters)
+{
+    Scene::setSphereCenters(materialId, centers, nbCenters);
+    if (_spheresDirty ||
+        _ospExtendedSpheres.find(materialId) == _ospExtendedSpheres.end())
+        return;
+
+    _invalidateCulling();
+
+    // The OSPRay data shares the serialized buffer, so only the centers need
+    // to be updated before committing the geometry again
+    auto& data = _serializedSpheresData[materialId];
+    const size_t stride = Sphere::getSerializationSize();
+    const size_t nbSpheres = std::min(nbCenters, data.size() / stride);
+    for (size_t i = 0; i < nbSpheres; ++i)
+    {
+        float* sphere = &data[i * stride];
+        sphere[0] = centers[i].x();
+        sphere[1] = centers[i].y();
+        sphere[2] = centers[i].z();
+    }
+    ospCommit(_ospExtendedSpheresData[materialId]);
+    ospCommit(_ospExtendedSpheres[materialId]);
+}
+
+void OSPRayScene::reportMemoryUsage(MemoryRegistry& registry)
+{
+    Scene::reportMemoryUsage(registry);
+
+    // OSPRay data objects share these buffers, so they are counted once
+    MemoryUsage serializationUsage;
+    for (const auto& data : _serializedSpheresData)
+        addMemoryUsage(data.second, serializationUsage);
+    for (const auto& data : _serializedCylindersData)
+        addMemoryUsage(data.second, serializationUsage);
+    for (const auto& data : _serializedConesData)
+        addMemoryUsage(data.second, serializationUsage);
+    for (const auto& ospModel : _ospInstancedModels)
+        for (const auto& data : ospModel.second.serializedSpheres)
+            addMemoryUsage(data.second, serializationUsage);
+    registry.set("ospray/serialized geometry", serializationUsage);
+
+    // OSPRay keeps its own copy of the culled geometry
+    MemoryUsage culledUsage;
+    culledUsage.resident = _culledGeometrySize;
+    culledUsage.reserved = _culledGeometrySize;
+    registry.set("ospray/culled geometry", culledUsage);
+
+    // OSPRay keeps its own copy of the texture data
+    MemoryUsage texturesUsage;
+    for (const auto& ospTexture : _ospTextures)
+    {
+        const auto it = _textures.find(ospTexture.first);
+        if (it == _textures.end())
+            continue;
+        const auto& texture = it->second;
+        const uint64_t size = uint64_t(texture->getWidth()) *
+                              texture->getHeight() *
+                              texture->getNbChannels() * texture->getDepth();
+        texturesUsage.resident += size;
+        texturesUsage.reserved += size;
+    }
+    registry.set("ospray/textures", texturesUsage);
+}
+
 OSPModel* OSPRayScene::modelImpl(const size_t timestamp)
 {
+    if (_culledModel)
+        return &_culledModel;
+
     if (_models.find(timestamp) != _models.end())
         return &_models[timestamp];
 
@@ -117,6 +251,10 @@ OSPModel* OSPRayScene::modelImpl(const size_t timestamp)
 
 void OSPRayScene::_saveCacheFile()
 {
+    // The culling in progress reads the serialized geometry
+    if (_culling.valid())
+        _culling.wait();
+
     const std::string& filename =
         _parametersManager.getGeometryParameters().getSaveCacheFile();
     BRAYNS_INFO << "Saving scene to binary file: " << filename << std::endl;
@@ -530,33 +668,12 @@ uint64_t OSPRayScene::_serializeSpheres(const size_t materialId)
                     ospRemoveGeometry(model.second,
                                       _ospExtendedSpheres[materialId]);
 
-                _ospExtendedSpheres[materialId] =
-                    ospNewGeometry("extendedspheres");
-
                 _ospExtendedSpheresData[materialId] =
                     ospNewData(spheresBufferSize, OSP_FLOAT,
                                &_serializedSpheresData[materialId][0],
                                OSP_DATA_SHARED_BUFFER);
-
-                ospSetObject(_ospExtendedSpheres[materialId], "extendedspheres",
-                             _ospExtendedSpheresData[materialId]);
-                ospSet1i(_ospExtendedSpheres[materialId],
-                         "bytes_per_extended_sphere",
-                         Sphere::getSerializationSize() * sizeof(float));
-                ospSet1i(_ospExtendedSpheres[materialId], "materialID",
-                         materialId);
-                ospSet1i(_ospExtendedSpheres[materialId], "offset_radius",
-                         3 * sizeof(float));
-                ospSet1i(_ospExtendedSpheres[materialId], "offset_timestamp",
-                         4 * sizeof(float));
-                ospSet1i(_ospExtendedSpheres[materialId], "offset_value",
-                         5 * sizeof(float));
-
-                if (_ospMaterials[materialId])
-                    ospSetMaterial(_ospExtendedSpheres[materialId],
-                                   _ospMaterials[materialId]);
-
-                ospCommit(_ospExtendedSpheres[materialId]);
+                _ospExtendedSpheres[materialId] = _createExtendedSpheres(
+                    materialId, _ospExtendedSpheresData[materialId]);
 
                 ospAddGeometry(model.second, _ospExtendedSpheres[materialId]);
             }
@@ -565,6 +682,63 @@ uint64_t OSPRayScene::_serializeSpheres(const size_t materialId)
     return size;
 }
 
+OSPGeometry OSPRayScene::_createExtendedSpheres(const size_t materialId,
+                                                OSPData data)
+{
+    OSPGeometry geometry = ospNewGeometry("extendedspheres");
+    ospSetObject(geometry, "extendedspheres", data);
+    ospSet1i(geometry, "bytes_per_extended_sphere",
+             Sphere::getSerializationSize() * sizeof(float));
+    ospSet1i(geometry, "materialID", materialId);
+    ospSet1i(geometry, "offset_radius", 3 * sizeof(float));
+    ospSet1i(geometry, "offset_timestamp", 4 * sizeof(float));
+    ospSet1i(geometry, "offset_value", 5 * sizeof(float));
+
+    if (_ospMaterials[materialId])
+        ospSetMaterial(geometry, _ospMaterials[materialId]);
+
+    ospCommit(geometry);
+    return geometry;
+}
+
+OSPGeometry OSPRayScene::_createExtendedCylinders(const size_t materialId,
+                                                  OSPData data)
+{
+    OSPGeometry geometry = ospNewGeometry("extendedcylinders");
+    assert(geometry);
+    ospSet1i(geometry, "materialID", materialId);
+    ospSetObject(geometry, "extendedcylinders", data);
+    ospSet1i(geometry, "bytes_per_extended_cylinder",
+             Cylinder::getSerializationSize() * sizeof(float));
+    ospSet1i(geometry, "offset_timestamp", 7 * sizeof(float));
+    ospSet1i(geometry, "offset_value", 8 * sizeof(float));
+
+    if (_ospMaterials[materialId])
+        ospSetMaterial(geometry, _ospMaterials[materialId]);
+
+    ospCommit(geometry);
+    return geometry;
+}
+
+OSPGeometry OSPRayScene::_createExtendedCones(const size_t materialId,
+                                              OSPData data)
+{
+    OSPGeometry geometry = ospNewGeometry("extendedcones");
+    assert(geometry);
+    ospSet1i(geometry, "materialID", materialId);
+    ospSetObject(geometry, "extendedcones", data);
+    ospSet1i(geometry, "bytes_per_extended_cone",
+             Cone::getSerializationSize() * sizeof(float));
+    ospSet1i(geometry, "offset_timestamp", 8 * sizeof(float));
+    ospSet1i(geometry, "offset_value", 9 * sizeof(float));
+
+    if (_ospMaterials[materialId])
+        ospSetMaterial(geometry, _ospMaterials[materialId]);
+
+    ospCommit(geometry);
+    return geometry;
+}
+
 uint64_t OSPRayScene::_serializeCylinders(const size_t materialId)
 {
     uint64_t size = 0;
@@ -597,33 +771,13 @@ uint64_t OSPRayScene::_serializeCylinders(const size_t materialId)
                     ospRemoveGeometry(model.second,
                                       _ospExtendedCylinders[materialId]);
 
-                _ospExtendedCylinders[materialId] =
-                    ospNewGeometry("extendedcylinders");
-                assert(_ospExtendedCylinders[materialId]);
-
                 _ospExtendedCylindersData[materialId] =
                     ospNewData(cylindersBufferSize, OSP_FLOAT,
                                &_serializedCylindersData[materialId][0],
                                OSP_DATA_SHARED_BUFFER);
+                _ospExtendedCylinders[materialId] = _createExtendedCylinders(
+                    materialId, _ospExtendedCylindersData[materialId]);
 
-                ospSet1i(_ospExtendedCylinders[materialId], "materialID",
-                         materialId);
-                ospSetObject(_ospExtendedCylinders[materialId],
-                             "extendedcylinders",
-                             _ospExtendedCylindersData[materialId]);
-                ospSet1i(_ospExtendedCylinders[materialId],
-                         "bytes_per_extended_cylinder",
-                         Cylinder::getSerializationSize() * sizeof(float));
-                ospSet1i(_ospExtendedCylinders[materialId], "offset_timestamp",
-                         7 * sizeof(float));
-                ospSet1i(_ospExtendedCylinders[materialId], "offset_value",
-                         8 * sizeof(float));
-
-                if (_ospMaterials[materialId])
-                    ospSetMaterial(_ospExtendedCylinders[materialId],
-                                   _ospMaterials[materialId]);
-
-                ospCommit(_ospExtendedCylinders[materialId]);
                 ospAddGeometry(model.second, _ospExtendedCylinders[materialId]);
             }
         }
@@ -660,31 +814,13 @@ uint64_t OSPRayScene::_serializeCones(const size_t materialId)
                     ospRemoveGeometry(model.second,
                                       _ospExtendedCones[materialId]);
 
-                _ospExtendedCones[materialId] = ospNewGeometry("extendedcones");
-                assert(_ospExtendedCones[materialId]);
-
                 _ospExtendedConesData[materialId] =
                     ospNewData(conesBufferSize, OSP_FLOAT,
                                &_serializedConesData[materialId][0],
                                OSP_DATA_SHARED_BUFFER);
+                _ospExtendedCones[materialId] = _createExtendedCones(
+                    materialId, _ospExtendedConesData[materialId]);
 
-                ospSet1i(_ospExtendedCones[materialId], "materialID",
-                         materialId);
-                ospSetObject(_ospExtendedCones[materialId], "extendedcones",
-                             _ospExtendedConesData[materialId]);
-                ospSet1i(_ospExtendedCones[materialId],
-                         "bytes_per_extended_cone",
-                         Cone::getSerializationSize() * sizeof(float));
-                ospSet1i(_ospExtendedCones[materialId], "offset_timestamp",
-                         8 * sizeof(float));
-                ospSet1i(_ospExtendedCones[materialId], "offset_value",
-                         9 * sizeof(float));
-
-                if (_ospMaterials[materialId])
-                    ospSetMaterial(_ospExtendedCones[materialId],
-                                   _ospMaterials[materialId]);
-
-                ospCommit(_ospExtendedCones[materialId]);
                 ospRemoveGeometry(model.second, _ospExtendedCones[materialId]);
                 ospAddGeometry(model.second, _ospExtendedCones[materialId]);
             }
@@ -697,6 +833,10 @@ uint64_t OSPRayScene::serializeGeometry()
 {
     uint64_t size = 0;
 
+    if (_spheresDirty || _cylindersDirty || _conesDirty ||
+        _trianglesMeshesDirty || _instancedModelsDirty)
+        _invalidateCulling();
+
     if (_spheresDirty)
     {
         _serializedSpheresDataSize.clear();
@@ -748,6 +888,12 @@ uint64_t OSPRayScene::serializeGeometry()
             size += _buildMeshOSPGeometry(materialId);
         _trianglesMeshesDirty = false;
     }
+
+    if (_instancedModelsDirty)
+    {
+        size += _buildInstancedModels();
+        _instancedModelsDirty = false;
+    }
     return size;
 }
 
@@ -789,6 +935,9 @@ void OSPRayScene::buildGeometry()
     size_t totalNbCones = 0;
     size_t totalNbVertices = 0;
     size_t totalNbIndices = 0;
+    size_t totalNbInstances = 0;
+    for (const auto& ospModel : _ospInstancedModels)
+        totalNbInstances += ospModel.second.instances.size();
     for (size_t materialId = 0; materialId < _materials.size(); ++materialId)
     {
         totalNbSpheres += _serializedSpheresDataSize[materialId];
@@ -809,6 +958,8 @@ void OSPRayScene::buildGeometry()
     BRAYNS_INFO << "Cones    : " << totalNbCones << std::endl;
     BRAYNS_INFO << "Vertices : " << totalNbVertices << std::endl;
     BRAYNS_INFO << "Indices  : " << totalNbIndices << std::endl;
+    BRAYNS_INFO << "Instances: " << totalNbInstances << " of "
+                << _ospInstancedModels.size() << " models" << std::endl;
     BRAYNS_INFO << "Total    : " << size << " bytes" << std::endl;
     BRAYNS_INFO << "--------------------" << std::endl;
 
@@ -822,68 +973,322 @@ uint64_t OSPRayScene::_buildMeshOSPGeometry(const size_t materialId)
     // Triangle meshes
     if (_trianglesMeshes.find(materialId) != _trianglesMeshes.end())
     {
-        _ospMeshes[materialId] = ospNewGeometry("trianglemesh");
-        assert(_ospMeshes[materialId]);
+        _ospMeshes[materialId] = _createTrianglesMesh(
+            materialId, _trianglesMeshes[materialId], size);
 
-        size += _trianglesMeshes[materialId].getVertices().size() * 3 *
-                sizeof(float);
-        OSPData vertices =
-            ospNewData(_trianglesMeshes[materialId].getVertices().size(),
-                       OSP_FLOAT3,
-                       &_trianglesMeshes[materialId].getVertices()[0],
-                       OSP_DATA_SHARED_BUFFER);
-
-        size += _trianglesMeshes[materialId].getNormals().size() * 3 *
-                sizeof(float);
-        OSPData normals =
-            ospNewData(_trianglesMeshes[materialId].getNormals().size(),
-                       OSP_FLOAT3,
-                       &_trianglesMeshes[materialId].getNormals()[0],
-                       OSP_DATA_SHARED_BUFFER);
+        // Meshes are by default added to all timestamps
+        for (const auto& model : _models)
+            ospAddGeometry(model.second, _ospMeshes[materialId]);
+    }
+    return size;
+}
 
-        size +=
-            _trianglesMeshes[materialId].getIndices().size() * 3 * sizeof(int);
-        OSPData indices =
-            ospNewData(_trianglesMeshes[materialId].getIndices().size(),
-                       OSP_INT3, &_trianglesMeshes[materialId].getIndices()[0],
-                       OSP_DATA_SHARED_BUFFER);
+OSPGeometry OSPRayScene::_createTrianglesMesh(const size_t materialId,
+                                              TrianglesMesh& mesh,
+                                              uint64_t& size)
+{
+    OSPGeometry geometry = ospNewGeometry("trianglemesh");
+    assert(geometry);
+
+    size += mesh.getVertices().size() * 3 * sizeof(float);
+    OSPData vertices =
+        ospNewData(mesh.getVertices().size(), OSP_FLOAT3,
+                   &mesh.getVertices()[0], OSP_DATA_SHARED_BUFFER);
+
+    size += mesh.getNormals().size() * 3 * sizeof(float);
+    OSPData normals = ospNewData(mesh.getNormals().size(), OSP_FLOAT3,
+                                 &mesh.getNormals()[0], OSP_DATA_SHARED_BUFFER);
+
+    size += mesh.getIndices().size() * 3 * sizeof(int);
+    OSPData indices = ospNewData(mesh.getIndices().size(), OSP_INT3,
+                                 &mesh.getIndices()[0], OSP_DATA_SHARED_BUFFER);
+
+    size += mesh.getColors().size() * 4 * sizeof(float);
+    OSPData colors = ospNewData(mesh.getColors().size(), OSP_FLOAT3A,
+                                &mesh.getColors()[0], OSP_DATA_SHARED_BUFFER);
+
+    size += mesh.getTextureCoordinates().size() * 2 * sizeof(float);
+    OSPData texCoords =
+        ospNewData(mesh.getTextureCoordinates().size(), OSP_FLOAT2,
+                   &mesh.getTextureCoordinates()[0], OSP_DATA_SHARED_BUFFER);
+
+    ospSetObject(geometry, "position", vertices);
+    ospSetObject(geometry, "index", indices);
+    ospSetObject(geometry, "vertex.normal", normals);
+    ospSetObject(geometry, "vertex.color", colors);
+    ospSetObject(geometry, "vertex.texcoord", texCoords);
+    ospSet1i(geometry, "alpha_type", 0);
+    ospSet1i(geometry, "alpha_component", 4);
+
+    if (_ospMaterials[materialId])
+        ospSetMaterial(geometry, _ospMaterials[materialId]);
+
+    ospCommit(geometry);
+    return geometry;
+}
 
-        size +=
-            _trianglesMeshes[materialId].getColors().size() * 4 * sizeof(float);
-        OSPData colors =
-            ospNewData(_trianglesMeshes[materialId].getColors().size(),
-                       OSP_FLOAT3A,
-                       &_trianglesMeshes[materialId].getColors()[0],
-                       OSP_DATA_SHARED_BUFFER);
+uint64_t OSPRayScene::_buildInstancedModels()
+{
+    _removeInstances();
 
-        size += _trianglesMeshes[materialId].getTextureCoordinates().size() *
-                2 * sizeof(float);
-        OSPData texCoords = ospNewData(
-            _trianglesMeshes[materialId].getTextureCoordinates().size(),
-            OSP_FLOAT2,
-            &_trianglesMeshes[materialId].getTextureCoordinates()[0],
-            OSP_DATA_SHARED_BUFFER);
+    // Models that were removed or replaced since the last build are released,
+    // the others keep their OSPRay geometry
+    for (auto it = _ospInstancedModels.begin();
+         it != _ospInstancedModels.end();)
+    {
+        const auto model = _instancedModels.find(it->first);
+        if (model == _instancedModels.end() ||
+            model->second != it->second.source)
+        {
+            ospRelease(it->second.model);
+            it = _ospInstancedModels.erase(it);
+        }
+        else
+            ++it;
+    }
 
-        ospSetObject(_ospMeshes[materialId], "position", vertices);
-        ospSetObject(_ospMeshes[materialId], "index", indices);
-        ospSetObject(_ospMeshes[materialId], "vertex.normal", normals);
-        ospSetObject(_ospMeshes[materialId], "vertex.color", colors);
-        ospSetObject(_ospMeshes[materialId], "vertex.texcoord", texCoords);
-        ospSet1i(_ospMeshes[materialId], "alpha_type", 0);
-        ospSet1i(_ospMeshes[materialId], "alpha_component", 4);
+    uint64_t size = 0;
+    for (const auto& instancedModel : _instancedModels)
+    {
+        auto& model = *instancedModel.second;
+        if (model.getInstances().empty())
+            continue;
 
-        if (_ospMaterials[materialId])
-            ospSetMaterial(_ospMeshes[materialId], _ospMaterials[materialId]);
+        // The geometry of the model is built once in its own OSPRay model
+        auto& ospModel = _ospInstancedModels[instancedModel.first];
+        if (ospModel.source != instancedModel.second)
+        {
+            ospModel.source = instancedModel.second;
+            ospModel.model = ospNewModel();
+            for (const auto& spheres : model.getSpheres())
+            {
+                const size_t materialId = spheres.first;
+                if (spheres.second.empty() ||
+                    materialId >= _ospMaterials.size())
+                    continue;
+
+                auto& data = ospModel.serializedSpheres[materialId];
+                for (const auto& sphere : spheres.second)
+                    size += sphere->serializeData(data);
+                OSPData ospData =
+                    ospNewData(data.size(), OSP_FLOAT, data.data(),
+                               OSP_DATA_SHARED_BUFFER);
+                ospAddGeometry(ospModel.model,
+                               _createExtendedSpheres(materialId, ospData));
+            }
+            for (const auto& cylinders : model.getCylinders())
+            {
+                const size_t materialId = cylinders.first;
+                if (cylinders.second.empty() ||
+                    materialId >= _ospMaterials.size())
+                    continue;
+
+                auto& data = ospModel.serializedCylinders[materialId];
+                for (const auto& cylinder : cylinders.second)
+                    size += cylinder->serializeData(data);
+                OSPData ospData =
+                    ospNewData(data.size(), OSP_FLOAT, data.data(),
+                               OSP_DATA_SHARED_BUFFER);
+                ospAddGeometry(ospModel.model,
+                               _createExtendedCylinders(materialId, ospData));
+            }
+            for (const auto& cones : model.getCones())
+            {
+                const size_t materialId = cones.first;
+                if (cones.second.empty() || materialId >= _ospMaterials.size())
+                    continue;
+
+                auto& data = ospModel.serializedCones[materialId];
+                for (const auto& cone : cones.second)
+                    size += cone->serializeData(data);
+                OSPData ospData =
+                    ospNewData(data.size(), OSP_FLOAT, data.data(),
+                               OSP_DATA_SHARED_BUFFER);
+                ospAddGeometry(ospModel.model,
+                               _createExtendedCones(materialId, ospData));
+            }
+            for (auto& mesh : model.getTriangleMeshes())
+            {
+                const size_t materialId = mesh.first;
+                if (mesh.second.getIndices().empty() ||
+                    materialId >= _ospMaterials.size())
+                    continue;
+                ospAddGeometry(ospModel.model,
+                               _createTrianglesMesh(materialId, mesh.second,
+                                                    size));
+            }
+            ospCommit(ospModel.model);
+        }
 
-        ospCommit(_ospMeshes[materialId]);
+        // Instances only hold a reference to the model and a transformation
+        for (const auto& transformation : model.getInstances())
+        {
+            osp::affine3f xfm;
+            xfm.l.vx = {transformation(0, 0), transformation(1, 0),
+                        transformation(2, 0)};
+            xfm.l.vy = {transformation(0, 1), transformation(1, 1),
+                        transformation(2, 1)};
+            xfm.l.vz = {transformation(0, 2), transformation(1, 2),
+                        transformation(2, 2)};
+            xfm.p = {transformation(0, 3), transformation(1, 3),
+                     transformation(2, 3)};
+            ospModel.instances.push_back(ospNewInstance(ospModel.model, xfm));
+        }
 
-        // Meshes are by default added to all timestamps
-        for (const auto& model : _models)
-            ospAddGeometry(model.second, _ospMeshes[materialId]);
+        // Instances are added to all timestamps, like meshes
+        for (const auto& timestampModel : _models)
+            for (const auto& instance : ospModel.instances)
+                ospAddGeometry(timestampModel.second, instance);
     }
     return size;
 }
 
+void OSPRayScene::_removeInstances()
+{
+    for (auto& ospModel : _ospInstancedModels)
+    {
+        for (const auto& instance : ospModel.second.instances)
+        {
+            for (const auto& model : _models)
+                ospRemoveGeometry(model.second, instance);
+            ospRelease(instance);
+        }
+        ospModel.second.instances.clear();
+    }
+}
+
+void OSPRayScene::cullGeometry(const ClipPlanes& clipPlanes)
+{
+    if (clipPlanes == _cullingPlanes)
+        return;
+
+    // The full model is rendered until the geometry is culled by the new
+    // planes. A culling in progress is restarted once complete.
+    _releaseCulledModel();
+    _cullingPlanes = clipPlanes;
+    if (!_culling.valid())
+        _startCulling();
+}
+
+void OSPRayScene::commitCulledModel()
+{
+    if (!_culling.valid() ||
+        _culling.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+    const CulledGeometry culledGeometry = _culling.get();
+    if (culledGeometry.clipPlanes != _cullingPlanes)
+    {
+        _startCulling();
+        return;
+    }
+
+    _culledModel = ospNewModel();
+    size_t nbPrimitives = 0;
+    for (const auto& spheres : culledGeometry.spheres)
+    {
+        const floats& data = spheres.second;
+        if (data.empty())
+            continue;
+        OSPData ospData = ospNewData(data.size(), OSP_FLOAT, data.data());
+        _culledGeometries.push_back(
+            _createExtendedSpheres(spheres.first, ospData));
+        ospRelease(ospData);
+        _culledGeometrySize += data.size() * sizeof(float);
+        nbPrimitives += data.size() / Sphere::getSerializationSize();
+    }
+    for (const auto& cylinders : culledGeometry.cylinders)
+    {
+        const floats& data = cylinders.second;
+        if (data.empty())
+            continue;
+        OSPData ospData = ospNewData(data.size(), OSP_FLOAT, data.data());
+        _culledGeometries.push_back(
+            _createExtendedCylinders(cylinders.first, ospData));
+        ospRelease(ospData);
+        _culledGeometrySize += data.size() * sizeof(float);
+        nbPrimitives += data.size() / Cylinder::getSerializationSize();
+    }
+    for (const auto& cones : culledGeometry.cones)
+    {
+        const floats& data = cones.second;
+        if (data.empty())
+            continue;
+        OSPData ospData = ospNewData(data.size(), OSP_FLOAT, data.data());
+        _culledGeometries.push_back(_createExtendedCones(cones.first, ospData));
+        ospRelease(ospData);
+        _culledGeometrySize += data.size() * sizeof(float);
+        nbPrimitives += data.size() / Cone::getSerializationSize();
+    }
+    for (const auto& geometry : _culledGeometries)
+        ospAddGeometry(_culledModel, geometry);
+
+    // Meshes and instances are shared with the full model
+    for (const auto& mesh : _ospMeshes)
+        if (mesh.second)
+            ospAddGeometry(_culledModel, mesh.second);
+    for (const auto& ospModel : _ospInstancedModels)
+        for (const auto& instance : ospModel.second.instances)
+            ospAddGeometry(_culledModel, instance);
+
+    ospCommit(_culledModel);
+    BRAYNS_INFO << "Culled model committed with " << nbPrimitives
+                << " primitives" << std::endl;
+}
+
+OSPRayScene::CulledGeometry OSPRayScene::_cullGeometry(
+    const ClipPlanes& clipPlanes) const
+{
+    CulledGeometry culledGeometry;
+    culledGeometry.clipPlanes = clipPlanes;
+    for (const auto& spheres : _serializedSpheresData)
+        culledGeometry.spheres[spheres.first] =
+            cullPrimitives(clipPlanes, spheres.second,
+                           Sphere::getSerializationSize(), 0, 3, 3);
+    for (const auto& cylinders : _serializedCylindersData)
+        culledGeometry.cylinders[cylinders.first] =
+            cullPrimitives(clipPlanes, cylinders.second,
+                           Cylinder::getSerializationSize(), 3, 6, 6);
+    for (const auto& cones : _serializedConesData)
+        culledGeometry.cones[cones.first] =
+            cullPrimitives(clipPlanes, cones.second,
+                           Cone::getSerializationSize(), 3, 6, 7);
+    return culledGeometry;
+}
+
+void OSPRayScene::_startCulling()
+{
+    // Only the single model of scenes that are not time dependent is culled
+    if (_cullingPlanes.empty() || _models.size() != 1)
+        return;
+
+    _culling = std::async(std::launch::async,
+                          std::bind(&OSPRayScene::_cullGeometry, this,
+                                    _cullingPlanes));
+}
+
+void OSPRayScene::_releaseCulledModel()
+{
+    if (!_culledModel)
+        return;
+
+    for (const auto& geometry : _culledGeometries)
+        ospRelease(geometry);
+    _culledGeometries.clear();
+    ospRelease(_culledModel);
+    _culledModel = 0;
+    _culledGeometrySize = 0;
+}
+
+void OSPRayScene::_invalidateCulling()
+{
+    if (_culling.valid())
+        _culling.wait();
+    _culling = std::future<CulledGeometry>();
+    _releaseCulledModel();
+    _cullingPlanes.clear();
+}
+
 void OSPRayScene::commitLights()
 {
     for (auto renderer : _renderers)
@@ -937,11 +1342,14 @@ void OSPRayScene::commitLights()
             ++lightCount;
         }
 
+        // Lights are updated in place, the renderer only needs to be
+        // committed when it gets the light data
         if (_ospLightData == 0)
         {
             _ospLightData = ospNewData(_lights.size(), OSP_OBJECT,
                                        &_ospLights[0], OSP_DATA_SHARED_BUFFER);
             ospCommit(_ospLightData);
+            osprayRenderer->invalidate();
         }
         ospSetData(osprayRenderer->impl(), "lights", _ospLightData);
     }
@@ -975,19 +1383,19 @@ void OSPRayScene::commitMaterials(const bool updateOnly)
 
             if (!updateOnly)
             {
-                // Textures
-                for (auto texture : material->getTextures())
+                // Textures are decoded asynchronously, placeholders are used
+                // until they are available
+                TextureLoader textureLoader;
+                for (const auto& texture : material->getTextures())
                 {
-                    TextureLoader textureLoader;
-                    if (texture.second != TEXTURE_NAME_SIMULATION)
-                        textureLoader.loadTexture(_textures, texture.first,
-                                                  texture.second);
-
-                    OSPTexture2D ospTexture = _createTexture2D(texture.second);
-                    ospSetObject(ospMaterial,
-                                 textureTypeMaterialAttribute[texture.first]
-                                     .attribute.c_str(),
-                                 ospTexture);
+                    if (texture.second != TEXTURE_NAME_SIMULATION &&
+                        textureLoader.requestTexture(
+                            _textures, texture.first, texture.second) ==
+                            TextureStatus::loading)
+                    {
+                        _pendingTextures[texture.second] = texture.first;
+                    }
+                    _setTexture(ospMaterial, texture.first, texture.second);
 
                     BRAYNS_DEBUG
                         << "OSPRay texture assigned to "
@@ -1052,6 +1460,7 @@ void OSPRayScene::commitTransferFunctionData()
         ospSet1f(osprayRenderer->impl(), "transferFunctionRange",
                  _transferFunction.getValuesRange().y() -
                      _transferFunction.getValuesRange().x());
+        osprayRenderer->invalidate();
     }
 }
 
@@ -1065,41 +1474,50 @@ void OSPRayScene::commitVolumeData()
         _parametersManager.getSceneParameters().getTimestamp();
     volumeHandler->setTimestamp(timestamp);
     void* data = volumeHandler->getData();
-    if (data)
+    if (!data)
+        return;
+
+    const auto& volumeParameters = _parametersManager.getVolumeParameters();
+    const Vector3f& elementSpacing = volumeParameters.getElementSpacing();
+    const Vector3f& offset = volumeParameters.getOffset();
+    const float epsilon = volumeHandler->getEpsilon(
+        elementSpacing, volumeParameters.getSamplesPerRay());
+
+    // The volume is only pushed to the renderers when it changed, the mapped
+    // data of a given timestamp does not change
+    if (volumeHandler->getTimestamp() == _ospVolumeTimestamp &&
+        elementSpacing == _ospVolumeElementSpacing &&
+        offset == _ospVolumeOffset && epsilon == _ospVolumeEpsilon)
     {
-        for (const auto& renderer : _renderers)
-        {
-            OSPRayRenderer* osprayRenderer =
-                dynamic_cast<OSPRayRenderer*>(renderer.get());
-
-            const size_t size = volumeHandler->getSize();
-
-            _ospVolumeData =
-                ospNewData(size, OSP_UCHAR, data, OSP_DATA_SHARED_BUFFER);
-            ospCommit(_ospVolumeData);
-            ospSetData(osprayRenderer->impl(), "volumeData", _ospVolumeData);
-
-            const Vector3ui& dimensions = volumeHandler->getDimensions();
-            ospSet3i(osprayRenderer->impl(), "volumeDimensions", dimensions.x(),
-                     dimensions.y(), dimensions.z());
-
-            const Vector3f& elementSpacing =
-                _parametersManager.getVolumeParameters().getElementSpacing();
-            ospSet3f(osprayRenderer->impl(), "volumeElementSpacing",
-                     elementSpacing.x(), elementSpacing.y(),
-                     elementSpacing.z());
-
-            const Vector3f& offset =
-                _parametersManager.getVolumeParameters().getOffset();
-            ospSet3f(osprayRenderer->impl(), "volumeOffset", offset.x(),
-                     offset.y(), offset.z());
-
-            const float epsilon = volumeHandler->getEpsilon(
-                elementSpacing,
-                _parametersManager.getVolumeParameters().getSamplesPerRay());
-            ospSet1f(osprayRenderer->impl(), "volumeEpsilon", epsilon);
-        }
+        return;
     }
+
+    _ospVolumeData = ospNewData(volumeHandler->getSize(), OSP_UCHAR, data,
+                                OSP_DATA_SHARED_BUFFER);
+    ospCommit(_ospVolumeData);
+
+    for (const auto& renderer : _renderers)
+    {
+        OSPRayRenderer* osprayRenderer =
+            dynamic_cast<OSPRayRenderer*>(renderer.get());
+
+        ospSetData(osprayRenderer->impl(), "volumeData", _ospVolumeData);
+
+        const Vector3ui& dimensions = volumeHandler->getDimensions();
+        ospSet3i(osprayRenderer->impl(), "volumeDimensions", dimensions.x(),
+                 dimensions.y(), dimensions.z());
+        ospSet3f(osprayRenderer->impl(), "volumeElementSpacing",
+                 elementSpacing.x(), elementSpacing.y(), elementSpacing.z());
+        ospSet3f(osprayRenderer->impl(), "volumeOffset", offset.x(),
+                 offset.y(), offset.z());
+        ospSet1f(osprayRenderer->impl(), "volumeEpsilon", epsilon);
+        osprayRenderer->invalidate();
+    }
+
+    _ospVolumeTimestamp = volumeHandler->getTimestamp();
+    _ospVolumeElementSpacing = elementSpacing;
+    _ospVolumeOffset = offset;
+    _ospVolumeEpsilon = epsilon;
 }
 
 void OSPRayScene::commitSimulationData()
@@ -1107,25 +1525,38 @@ void OSPRayScene::commitSimulationData()
     if (!_simulationHandler)
         return;
 
+    // Simulation data is only pushed to the renderers when the frame changed
+    _simulationHandler->setTimestamp(
+        _parametersManager.getSceneParameters().getTimestamp());
+    if (_simulationHandler->getTimestamp() == _ospSimulationTimestamp)
+        return;
+
+    _ospSimulationData =
+        ospNewData(_simulationHandler->getFrameSize(), OSP_FLOAT,
+                   _simulationHandler->getFrameData(), OSP_DATA_SHARED_BUFFER);
+    ospCommit(_ospSimulationData);
+
     for (const auto& renderer : _renderers)
     {
         OSPRayRenderer* osprayRenderer =
             dynamic_cast<OSPRayRenderer*>(renderer.get());
-
-        // Simulation data
-        const uint64_t frame =
-            _parametersManager.getSceneParameters().getTimestamp();
-
-        _simulationHandler->setTimestamp(frame);
-        _ospSimulationData =
-            ospNewData(_simulationHandler->getFrameSize(), OSP_FLOAT,
-                       _simulationHandler->getFrameData(),
-                       OSP_DATA_SHARED_BUFFER);
-        ospCommit(_ospSimulationData);
         ospSetData(osprayRenderer->impl(), "simulationData",
                    _ospSimulationData);
-        ospCommit(osprayRenderer->impl());
+        osprayRenderer->invalidate();
     }
+
+    _ospSimulationTimestamp = _simulationHandler->getTimestamp();
+}
+
+bool OSPRayScene::isTimeDependent() const
+{
+    return _models.size() > 1 || _simulationHandler;
+}
+
+void OSPRayScene::invalidateFrameData()
+{
+    _ospSimulationTimestamp = -std::numeric_limits<float>::max();
+    _ospVolumeTimestamp = -std::numeric_limits<float>::max();
 }
 
 OSPTexture2D OSPRayScene::_createTexture2D(const std::string& textureName)
@@ -1133,7 +1564,8 @@ OSPTexture2D OSPRayScene::_createTexture2D(const std::string& textureName)
     if (_ospTextures.find(textureName) != _ospTextures.end())
         return _ospTextures[textureName];
 
-    Texture2DPtr texture = _textures[textureName];
+    const auto it = _textures.find(textureName);
+    Texture2DPtr texture = it == _textures.end() ? nullptr : it->second;
     if (!texture)
     {
         BRAYNS_WARN << "Texture " << textureName << " is not in the cache"
@@ -1173,6 +1605,92 @@ OSPTexture2D OSPRayScene::_createTexture2D(const std::string& textureName)
     return ospTexture;
 }
 
+OSPTexture2D OSPRayScene::_getPlaceholderTexture(const TextureType textureType)
+{
+    // Placeholders are single texels that leave the material unchanged. Other
+    // texture types are left unset until their texture is available.
+    static const unsigned char white[3] = {255, 255, 255};
+    static const unsigned char flatNormal[3] = {128, 128, 255};
+    const unsigned char* texel = nullptr;
+    switch (textureType)
+    {
+    case TT_DIFFUSE:
+    case TT_SPECULAR:
+    case TT_OPACITY:
+        texel = white;
+        break;
+    case TT_NORMALS:
+        texel = flatNormal;
+        break;
+    default:
+        return nullptr;
+    }
+
+    auto& ospTexture = _ospPlaceholderTextures[textureType];
+    if (!ospTexture)
+    {
+        osp::vec2i texSize{1, 1};
+        ospTexture = ospNewTexture2D(texSize, OSP_TEXTURE_RGB8,
+                                     const_cast<unsigned char*>(texel), 0);
+        ospCommit(ospTexture);
+    }
+    return ospTexture;
+}
+
+void OSPRayScene::_setTexture(OSPMaterial material,
+                              const TextureType textureType,
+                              const std::string& textureName)
+{
+    OSPTexture2D ospTexture =
+        _pendingTextures.find(textureName) == _pendingTextures.end()
+            ? _createTexture2D(textureName)
+            : _getPlaceholderTexture(textureType);
+    ospSetObject(material,
+                 textureTypeMaterialAttribute[textureType].attribute.c_str(),
+                 ospTexture);
+}
+
+bool OSPRayScene::commitPendingTextures()
+{
+    if (_pendingTextures.empty())
+        return false;
+
+    TextureLoader textureLoader;
+    std::set<std::string> decodedTextures;
+    for (auto it = _pendingTextures.begin(); it != _pendingTextures.end();)
+    {
+        if (textureLoader.requestTexture(_textures, it->second, it->first) ==
+            TextureStatus::loading)
+        {
+            ++it;
+            continue;
+        }
+        decodedTextures.insert(it->first);
+        it = _pendingTextures.erase(it);
+    }
+
+    if (decodedTextures.empty())
+        return false;
+
+    for (size_t index = 0; index < _ospMaterials.size(); ++index)
+    {
+        bool modified = false;
+        for (const auto& texture : _materials[index]->getTextures())
+        {
+            if (decodedTextures.find(texture.second) == decodedTextures.end())
+                continue;
+            _setTexture(_ospMaterials[index], texture.first, texture.second);
+            modified = true;
+        }
+        if (modified)
+            ospCommit(_ospMaterials[index]);
+    }
+
+    for (const auto& renderer : _renderers)
+        static_cast<OSPRayRenderer*>(renderer.get())->invalidate();
+    return true;
+}
+
 void OSPRayScene::saveSceneToCacheFile()
 {
     _saveCacheFile();
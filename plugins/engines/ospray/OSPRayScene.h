@@ -30,6 +30,7 @@
 #include <ospray_cpp/Texture2D.h>
 
 #include <fstream>
+#include <future>
 
 namespace brayns
 {
@@ -69,6 +70,13 @@ public:
     /** @copydoc Scene::commitTransferFunctionData */
     void commitTransferFunctionData() final;
 
+    /**
+     * Replaces the placeholders of the textures that finished decoding since
+     * the last call by the actual textures
+     * @return true if materials were updated
+     */
+    bool commitPendingTextures();
+
     /** @copydoc Scene::reset */
     void reset() final;
 
@@ -78,29 +86,100 @@ public:
     /** @copydoc Scene::isVolumeSupported */
     bool isVolumeSupported(const std::string& volumeFile) const final;
 
+    /** @copydoc Scene::reportMemoryUsage */
+    void reportMemoryUsage(MemoryRegistry& registry) final;
+
+    /** @copydoc Scene::setSphereCenters */
+    void setSphereCenters(size_t materialId, const Vector3f* centers,
+                          size_t nbCenters) final;
+
+    /**
+     * @return the model of the given timestamp, or the culled model if one is
+     * built for the current clip planes
+     */
     OSPModel* modelImpl(const size_t timestamp);
 
+    /**
+     * Builds in the background a model without the spheres, cylinders and
+     * cones lying entirely on the removed side of one of the clip planes. The
+     * full model is used until the culled one is committed. Triangle meshes
+     * and instances are not culled, nor are the models of time dependent
+     * scenes. Empty clip planes restore the full model.
+     */
+    void cullGeometry(const ClipPlanes& clipPlanes);
+
+    /**
+     * Replaces the full model by the culled one once its background build is
+     * complete, or starts a new build if the clip planes changed meanwhile
+     */
+    void commitCulledModel();
+
+    /** @return true if the rendered image depends on the timestamp */
+    bool isTimeDependent() const;
+
+    /**
+     * Forces the next volume and simulation commits to push the data of the
+     * current frame, e.g. to a renderer that just became active
+     */
+    void invalidateFrameData();
+
 private:
     OSPTexture2D _createTexture2D(const std::string& textureName);
+    OSPTexture2D _getPlaceholderTexture(TextureType textureType);
+    void _setTexture(OSPMaterial material, TextureType textureType,
+                     const std::string& textureName);
     void _createModel(const size_t timestamp);
 
     uint64_t _serializeSpheres(const size_t materialId);
     uint64_t _serializeCylinders(const size_t materialId);
     uint64_t _serializeCones(const size_t materialId);
     uint64_t _buildMeshOSPGeometry(const size_t materialId);
+    uint64_t _buildInstancedModels();
+    void _removeInstances();
+
+    OSPGeometry _createExtendedSpheres(size_t materialId, OSPData data);
+    OSPGeometry _createExtendedCylinders(size_t materialId, OSPData data);
+    OSPGeometry _createExtendedCones(size_t materialId, OSPData data);
+    OSPGeometry _createTrianglesMesh(size_t materialId, TrianglesMesh& mesh,
+                                     uint64_t& size);
 
     void _loadCacheFile();
     void _saveCacheFile();
 
+    /** Spheres, cylinders and cones kept by the clip planes, per material */
+    struct CulledGeometry
+    {
+        ClipPlanes clipPlanes;
+        std::map<size_t, floats> spheres;
+        std::map<size_t, floats> cylinders;
+        std::map<size_t, floats> cones;
+    };
+    CulledGeometry _cullGeometry(const ClipPlanes& clipPlanes) const;
+    void _startCulling();
+    void _releaseCulledModel();
+
+    /**
+     * Waits for the culling in progress and drops the culled model, before
+     * the serialized geometry it is built from is modified
+     */
+    void _invalidateCulling();
+
     std::map<size_t, OSPModel> _models;
     std::vector<OSPMaterial> _ospMaterials;
     std::map<std::string, OSPTexture2D> _ospTextures;
+    std::map<TextureType, OSPTexture2D> _ospPlaceholderTextures;
+    std::map<std::string, TextureType> _pendingTextures;
 
     std::vector<OSPLight> _ospLights;
     OSPData _ospLightData;
     OSPData _ospMaterialData;
     OSPData _ospVolumeData;
     OSPData _ospSimulationData;
+    float _ospSimulationTimestamp;
+    float _ospVolumeTimestamp;
+    Vector3f _ospVolumeElementSpacing;
+    Vector3f _ospVolumeOffset;
+    float _ospVolumeEpsilon;
     OSPData _ospTransferFunctionDiffuseData;
     OSPData _ospTransferFunctionEmissionData;
 
@@ -121,11 +200,30 @@ private:
     std::map<size_t, size_t> _serializedCylindersDataSize;
     std::map<size_t, size_t> _serializedConesDataSize;
 
+    /** OSPRay model of an instanced model, shared by all its instances */
+    struct OSPInstancedModel
+    {
+        InstancedModelPtr source;
+        OSPModel model;
+        std::map<size_t, floats> serializedSpheres;
+        std::map<size_t, floats> serializedCylinders;
+        std::map<size_t, floats> serializedCones;
+        std::vector<OSPGeometry> instances;
+    };
+    std::map<std::string, OSPInstancedModel> _ospInstancedModels;
+
     std::map<size_t, std::map<size_t, size_t>> _timestampSpheresIndices;
     std::map<size_t, std::map<size_t, size_t>> _timestampCylindersIndices;
     std::map<size_t, std::map<size_t, size_t>> _timestampConesIndices;
 
     float _currentTimestamp;
+
+    ClipPlanes _cullingPlanes;
+    OSPModel _culledModel;
+    std::vector<OSPGeometry> _culledGeometries;
+    uint64_t _culledGeometrySize;
+    // Declared last so that the destruction waits for the culling in progress
+    std::future<CulledGeometry> _culling;
 };
 }
 #endif // OSPRAYSCENE_H
@@ -21,6 +21,7 @@
  */
 
 #include "AbstractRenderer.h"
+#include "AbstractRenderer_ispc.h"
 
 // obj
 #include <plugins/engines/ospray/ispc/render/ExtendedOBJMaterial.h>
@@ -69,6 +70,13 @@ void AbstractRenderer::commit()
             _materialArray.push_back(
                 ((ospray::Material**)_materialData->data)[i]->getIE());
     _materialPtr = _materialArray.empty() ? nullptr : &_materialArray[0];
+
+    // Clip planes restrict all rays, not only the primary ones generated by
+    // the camera
+    _clipPlaneData = (ospray::Data*)getParamData("clipPlanes");
+    ispc::AbstractRenderer_setClipPlanes(
+        getIE(), _clipPlaneData ? _clipPlaneData->data : nullptr,
+        _clipPlaneData ? _clipPlaneData->size() : 0);
 }
 
 /*! \brief create a material of given type */
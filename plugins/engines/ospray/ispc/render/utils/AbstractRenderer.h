@@ -58,6 +58,7 @@ protected:
     Camera* _camera;
     ospray::Data* _materialData;
     ospray::Data* _lightData;
+    ospray::Data* _clipPlaneData;
 
     ospray::vec3f _bgColor;
     bool _shadowsEnabled;
@@ -20,10 +20,14 @@
 
 #include "ExtensionPluginFactory.h"
 
+#include <brayns/parameters/ParametersManager.h>
 #include <plugins/extensions/plugins/ExtensionPlugin.h>
 #if BRAYNS_USE_NETWORKING
 #include <plugins/extensions/plugins/ZeroEQPlugin.h>
 #endif
+#if BRAYNS_USE_LIBJPEGTURBO
+#include <plugins/extensions/plugins/VideoRecorderPlugin.h>
+#endif
 #ifdef BRAYNS_USE_DEFLECT
 #include <plugins/extensions/plugins/DeflectPlugin.h>
 #endif
@@ -31,17 +35,34 @@
 namespace brayns
 {
 ExtensionPluginFactory::ExtensionPluginFactory(
-#if BRAYNS_USE_NETWORKING || BRAYNS_USE_DEFLECT
+#if BRAYNS_USE_NETWORKING || BRAYNS_USE_DEFLECT || BRAYNS_USE_LIBJPEGTURBO
     ParametersManager& parametersManager,
-#ifdef BRAYNS_USE_DEFLECT
-    KeyboardHandler& keyboardHandler, AbstractManipulator& cameraManipulator)
 #else
-    KeyboardHandler&, AbstractManipulator&)
+    ParametersManager&,
 #endif
+#if BRAYNS_USE_DEFLECT || BRAYNS_USE_LIBJPEGTURBO
+    KeyboardHandler& keyboardHandler,
+#else
+    KeyboardHandler&,
+#endif
+#ifdef BRAYNS_USE_DEFLECT
+    AbstractManipulator& cameraManipulator)
 #else
-    ParametersManager&, KeyboardHandler&, AbstractManipulator&)
+    AbstractManipulator&)
 #endif
 {
+#if BRAYNS_USE_LIBJPEGTURBO
+    // Registered first so that every rendered frame gets recorded
+    add(std::make_shared<VideoRecorderPlugin>(parametersManager,
+                                              keyboardHandler));
+#endif
+
+#if BRAYNS_USE_NETWORKING || BRAYNS_USE_DEFLECT
+    // Batch instances neither serve nor stream anything
+    if (!parametersManager.getApplicationParameters().getNetworkPlugins())
+        return;
+#endif
+
 #if BRAYNS_USE_NETWORKING
     auto zeroeqPlugin = std::make_shared<ZeroEQPlugin>(parametersManager);
     add(zeroeqPlugin);
@@ -49,10 +70,11 @@ ExtensionPluginFactory::ExtensionPluginFactory(
 
 #ifdef BRAYNS_USE_DEFLECT
 #if BRAYNS_USE_NETWORKING
-    add(std::make_shared<DeflectPlugin>(keyboardHandler, cameraManipulator,
-                                        *zeroeqPlugin));
+    add(std::make_shared<DeflectPlugin>(parametersManager, keyboardHandler,
+                                        cameraManipulator, *zeroeqPlugin));
 #else
-    add(std::make_shared<DeflectPlugin>(keyboardHandler, cameraManipulator));
+    add(std::make_shared<DeflectPlugin>(parametersManager, keyboardHandler,
+                                        cameraManipulator));
 #endif
 #endif
 }
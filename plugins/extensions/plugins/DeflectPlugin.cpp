@@ -28,6 +28,7 @@
 #include <brayns/common/renderer/Renderer.h>
 #include <brayns/common/scene/Scene.h>
 #include <brayns/parameters/ApplicationParameters.h>
+#include <brayns/parameters/ParametersManager.h>
 
 #if BRAYNS_USE_NETWORKING
 #include "ZeroEQPlugin.h"
@@ -36,30 +37,45 @@
 namespace
 {
 const float wheelFactor = 1.f / 40.f;
+const size_t NB_FRAMES_IN_FLIGHT = 3;
 
-template <typename T>
-std::future<T> make_ready_future(const T value)
+deflect::PixelFormat getDeflectPixelFormat(
+    const brayns::FrameBufferFormat format)
 {
-    std::promise<T> promise;
-    promise.set_value(value);
-    return promise.get_future();
+    switch (format)
+    {
+    case brayns::FrameBufferFormat::FBF_BGRA_I8:
+        return deflect::BGRA;
+    case brayns::FrameBufferFormat::FBF_RGB_I8:
+        return deflect::RGB;
+    default:
+        return deflect::RGBA;
+    }
 }
 }
 
 namespace brayns
 {
 #if BRAYNS_USE_NETWORKING
-DeflectPlugin::DeflectPlugin(KeyboardHandler& keyboardHandler,
+DeflectPlugin::DeflectPlugin(ParametersManager& parametersManager,
+                             KeyboardHandler& keyboardHandler,
                              AbstractManipulator& cameraManipulator,
                              ZeroEQPlugin& zeroeq)
 #else
-DeflectPlugin::DeflectPlugin(KeyboardHandler& keyboardHandler,
+DeflectPlugin::DeflectPlugin(ParametersManager& parametersManager,
+                             KeyboardHandler& keyboardHandler,
                              AbstractManipulator& cameraManipulator)
 #endif
     : ExtensionPlugin()
+    , _parametersManager(parametersManager)
     , _keyboardHandler(keyboardHandler)
     , _cameraManipulator(cameraManipulator)
-    , _sendFuture(make_ready_future(true))
+    , _imageDelta(parametersManager.getApplicationParameters()
+                      .getStreamTileSize(),
+                  parametersManager.getApplicationParameters()
+                      .getStreamKeyframeInterval())
+    , _images(NB_FRAMES_IN_FLIGHT)
+    , _sendFailed(false)
 {
     _keyboardHandler.registerKeyboardShortcut(
         '*', "Enable/Disable Deflect streaming",
@@ -78,6 +94,11 @@ DeflectPlugin::DeflectPlugin(KeyboardHandler& keyboardHandler,
 #endif
 }
 
+DeflectPlugin::~DeflectPlugin()
+{
+    _closeStream();
+}
+
 bool DeflectPlugin::run(Engine& engine)
 {
     if (_stream)
@@ -85,7 +106,7 @@ bool DeflectPlugin::run(Engine& engine)
         const bool changed = _stream->getId() != _params.getIdString() ||
                              _stream->getHost() != _params.getHostString();
         if (changed)
-            _stream.reset();
+            _closeStream();
     }
 
     if (_previousHost != _params.getHostString())
@@ -98,7 +119,7 @@ bool DeflectPlugin::run(Engine& engine)
     if (_stream && _stream->isConnected() && !deflectEnabled)
     {
         BRAYNS_INFO << "Closing Deflect stream" << std::endl;
-        _stream.reset();
+        _closeStream();
     }
 
     if (deflectEnabled && !_stream)
@@ -138,6 +159,15 @@ void DeflectPlugin::_initializeDeflect()
 
         _params.setId(_stream->getId());
         _params.setHost(_stream->getHost());
+
+        _freeImages.clear();
+        _pendingImages.clear();
+        for (size_t i = 0; i < _images.size(); ++i)
+            _freeImages.push_back(i);
+        _imageDelta.reset();
+        _sendFailed = false;
+        _stopSending = false;
+        _sendThread = std::thread(&DeflectPlugin::_sendImages, this);
     }
     catch (std::runtime_error& ex)
     {
@@ -148,34 +178,114 @@ void DeflectPlugin::_initializeDeflect()
     }
 }
 
+void DeflectPlugin::_closeStream()
+{
+    if (_sendThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+            _stopSending = true;
+        }
+        _queueCondition.notify_all();
+        _sendThread.join();
+    }
+    _stream.reset();
+}
+
 void DeflectPlugin::_sendDeflectFrame(Engine& engine)
 {
-    if (!_sendFuture.get())
+    if (_sendFailed)
     {
         if (!_stream->isConnected())
             BRAYNS_INFO << "Stream closed, exiting." << std::endl;
         else
             BRAYNS_ERROR << "failure in deflectStreamSend()" << std::endl;
+        _sendFailed = false;
+        // The tiles of the failed image never reached the wall
+        _imageDelta.reset();
         return;
     }
 
     auto& frameBuffer = engine.getFrameBuffer();
-    const Vector2i& frameSize = frameBuffer.getSize();
-    void* data = frameBuffer.getColorBuffer();
+    const uint8_t* data = frameBuffer.getColorBuffer();
+    if (!data)
+        return;
 
-    if (data)
+    size_t index;
     {
-        const size_t bufferSize =
-            frameSize.x() * frameSize.y() * frameBuffer.getColorDepth();
-        _lastImage.data.resize(bufferSize);
-        memcpy(_lastImage.data.data(), data, bufferSize);
-        _lastImage.size = frameSize;
-        _lastImage.format = frameBuffer.getFrameBufferFormat();
-
-        _send(true);
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        if (_freeImages.empty())
+            return; // All images are in flight, skip this frame
+        index = _freeImages.front();
+        _freeImages.pop_front();
+    }
+
+    const Vector2ui frameSize = frameBuffer.getSize();
+    const size_t pixelSize = frameBuffer.getColorDepth();
+    const auto& appParameters = _parametersManager.getApplicationParameters();
+    const size_t tileSize = appParameters.getStreamTileSize();
+    _imageDelta.setTileSize(tileSize == 0 ? frameSize.find_max() : tileSize);
+    _imageDelta.setKeyframeInterval(appParameters.getStreamKeyframeInterval());
+    if (tileSize == 0)
+        _imageDelta.reset();
+
+    // Tiles are computed on the bottom-up frame buffer, and only the pixels to
+    // send are copied into the ring, flipped to the top-down rows of Deflect
+    Image& image = _images[index];
+    image.keyframe = _imageDelta.update(data, frameSize, pixelSize);
+    image.size = frameSize;
+    image.format = frameBuffer.getFrameBufferFormat();
+    image.compressionQuality = _params.getQuality();
+    image.compression = _params.getCompression();
+    image.tiles.clear();
+
+    const size_t pitch = frameSize.x() * pixelSize;
+    const size_t height = frameSize.y();
+    if (image.keyframe)
+    {
+        image.data.resize(pitch * height);
+        char* dst = image.data.data();
+#pragma omp parallel for
+        for (size_t y = 0; y < height; ++y)
+            memcpy(dst + y * pitch, data + (height - 1 - y) * pitch, pitch);
     }
     else
-        _sendFuture = make_ready_future(true);
+    {
+        const auto& tiles = _imageDelta.getTiles();
+        std::vector<size_t> offsets(tiles.size() + 1, 0);
+        for (size_t i = 0; i < tiles.size(); ++i)
+            offsets[i + 1] =
+                offsets[i] + tiles[i].size.x() * tiles[i].size.y() * pixelSize;
+        image.data.resize(offsets.back());
+
+        image.tiles.resize(tiles.size());
+        char* dst = image.data.data();
+#pragma omp parallel for
+        for (size_t i = 0; i < tiles.size(); ++i)
+        {
+            const auto& tile = tiles[i];
+            const size_t rowSize = tile.size.x() * pixelSize;
+            const uint8_t* src = data + tile.origin.x() * pixelSize;
+            for (size_t row = 0; row < tile.size.y(); ++row)
+                memcpy(dst + offsets[i] + row * rowSize,
+                       src + (tile.origin.y() + tile.size.y() - 1 - row) *
+                                 pitch,
+                       rowSize);
+            image.tiles[i].origin =
+                Vector2ui(tile.origin.x(),
+                          height - tile.origin.y() - tile.size.y());
+            image.tiles[i].size = tile.size;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        if (!image.keyframe && image.tiles.empty())
+            _freeImages.push_back(index); // Nothing changed
+        else
+            _pendingImages.push_back(index);
+    }
+    _queueCondition.notify_one();
 }
 
 bool DeflectPlugin::_handleDeflectEvents(Engine& engine)
@@ -241,8 +351,7 @@ bool DeflectPlugin::_handleDeflectEvents(Engine& engine)
             _params.setEnabled(false);
             _params.setHost("");
             _previousHost.clear();
-            _stream.reset();
-            _sendFuture = make_ready_future(true);
+            _closeStream();
             return true;
         default:
             break;
@@ -252,35 +361,61 @@ bool DeflectPlugin::_handleDeflectEvents(Engine& engine)
     return true;
 }
 
-void DeflectPlugin::_send(const bool swapYAxis)
+void DeflectPlugin::_sendImages()
 {
-    deflect::PixelFormat format = deflect::RGBA;
-    switch (_lastImage.format)
+    for (;;)
     {
-    case FrameBufferFormat::FBF_BGRA_I8:
-        format = deflect::BGRA;
-        break;
-    case FrameBufferFormat::FBF_RGB_I8:
-        format = deflect::RGB;
-        break;
-    default:
-        format = deflect::RGBA;
-    }
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _queueCondition.wait(lock, [this] {
+                return _stopSending || !_pendingImages.empty();
+            });
+            if (_stopSending)
+                return;
+            index = _pendingImages.front();
+            _pendingImages.pop_front();
+        }
 
-    deflect::ImageWrapper deflectImage(_lastImage.data.data(),
-                                       _lastImage.size.x(), _lastImage.size.y(),
-                                       format);
+        const bool success = _send(_images[index]);
 
-    deflectImage.compressionQuality = _params.getQuality();
-    deflectImage.compressionPolicy = _params.getCompression()
-                                         ? deflect::COMPRESSION_ON
-                                         : deflect::COMPRESSION_OFF;
-    if (swapYAxis)
-        deflect::ImageWrapper::swapYAxis((void*)_lastImage.data.data(),
-                                         _lastImage.size.x(),
-                                         _lastImage.size.y(), 4);
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+            _freeImages.push_back(index);
+        }
+        if (!success)
+            _sendFailed = true;
+    }
+}
+
+bool DeflectPlugin::_send(const Image& image)
+{
+    const deflect::PixelFormat format = getDeflectPixelFormat(image.format);
+    const auto compressionPolicy = image.compression ? deflect::COMPRESSION_ON
+                                                     : deflect::COMPRESSION_OFF;
+    if (image.keyframe)
+    {
+        deflect::ImageWrapper deflectImage(image.data.data(), image.size.x(),
+                                           image.size.y(), format);
+        deflectImage.compressionQuality = image.compressionQuality;
+        deflectImage.compressionPolicy = compressionPolicy;
+        return _stream->send(deflectImage) && _stream->finishFrame();
+    }
 
-    _sendFuture = _stream->asyncSend(deflectImage);
+    // The tiles are stored one after the other, each with contiguous rows
+    const char* tileData = image.data.data();
+    for (const auto& tile : image.tiles)
+    {
+        deflect::ImageWrapper deflectImage(tileData, tile.size.x(),
+                                           tile.size.y(), format,
+                                           tile.origin.x(), tile.origin.y());
+        deflectImage.compressionQuality = image.compressionQuality;
+        deflectImage.compressionPolicy = compressionPolicy;
+        if (!_stream->send(deflectImage))
+            return false;
+        tileData += deflectImage.getBufferSize();
+    }
+    return _stream->finishFrame();
 }
 
 Vector2d DeflectPlugin::_getWindowPos(const deflect::Event& event,
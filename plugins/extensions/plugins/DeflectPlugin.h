@@ -24,9 +24,16 @@
 #include "ExtensionPlugin.h"
 
 #include <brayns/api.h>
+#include <brayns/common/utils/ImageDelta.h>
 #include <deflect/Stream.h>
 #include <lexis/render/stream.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 namespace brayns
 {
 #if BRAYNS_USE_NETWORKING
@@ -35,22 +42,32 @@ class ZeroEQPlugin;
 
 struct Image
 {
+    // Top-down rows, as expected by Deflect, of the whole image for keyframes
+    // and of each tile, one after the other, otherwise
     std::vector<char> data;
     Vector2ui size;
     FrameBufferFormat format;
+    bool keyframe;
+    ImageTiles tiles; // Tiles to send if the image is not a keyframe
+    unsigned int compressionQuality;
+    bool compression;
 };
 
 class DeflectPlugin : public ExtensionPlugin
 {
 public:
 #if BRAYNS_USE_NETWORKING
-    DeflectPlugin(KeyboardHandler& keyboardHandler,
+    DeflectPlugin(ParametersManager& parametersManager,
+                  KeyboardHandler& keyboardHandler,
                   AbstractManipulator& cameraManipulator, ZeroEQPlugin& zeroeq);
 #else
-    DeflectPlugin(KeyboardHandler& keyboardHandler,
+    DeflectPlugin(ParametersManager& parametersManager,
+                  KeyboardHandler& keyboardHandler,
                   AbstractManipulator& cameraManipulator);
 #endif
 
+    ~DeflectPlugin();
+
     /** @copydoc ExtensionPlugin::run */
     BRAYNS_API bool run(Engine& engine) final;
 
@@ -73,20 +90,28 @@ private:
     };
 
     void _initializeDeflect();
+    void _closeStream();
     void _sendDeflectFrame(Engine& engine);
     bool _handleDeflectEvents(Engine& engine);
 
-    /** Send an image to DisplayCluster
+    /** Sends the queued images until the stream is closed. Runs in
+     * _sendThread.
+     */
+    void _sendImages();
+
+    /** Send an image, or its dirty tiles, to DisplayCluster
      *
-     * @param swapYAxis enables a vertical flip operation on the image
+     * @param image the image to send
+     * @return true if the image was successfully sent
      */
-    void _send(bool swapYAxis);
+    bool _send(const Image& image);
 
     Vector2d _getWindowPos(const deflect::Event& event,
                            const Vector2ui& windowSize) const;
     double _getZoomDelta(const deflect::Event& pinchEvent,
                          const Vector2ui& windowSize) const;
 
+    ParametersManager& _parametersManager;
     KeyboardHandler& _keyboardHandler;
     AbstractManipulator& _cameraManipulator;
 
@@ -96,8 +121,18 @@ private:
     std::unique_ptr<deflect::Stream> _stream;
     ::lexis::render::Stream _params;
     std::string _previousHost;
-    Image _lastImage;
-    deflect::Stream::Future _sendFuture;
+    ImageDelta _imageDelta;
+
+    // Ring of images: the render loop fills free images while _sendThread
+    // streams the pending ones, which bounds the number of frames in flight
+    std::vector<Image> _images;
+    std::deque<size_t> _freeImages;
+    std::deque<size_t> _pendingImages;
+    std::mutex _queueMutex;
+    std::condition_variable _queueCondition;
+    std::thread _sendThread;
+    bool _stopSending = false;
+    std::atomic<bool> _sendFailed;
 };
 }
 #endif // DEFLECTPLUGIN_H
@@ -0,0 +1,450 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "VideoRecorderPlugin.h"
+
+#include <brayns/common/engine/Engine.h>
+#include <brayns/common/input/KeyboardHandler.h>
+#include <brayns/common/log.h>
+#include <brayns/common/renderer/FrameBuffer.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#include <cstdio>
+
+namespace
+{
+const size_t NB_QUEUED_FRAMES = 8;
+const uint32_t AVIF_HASINDEX = 0x10;
+const uint32_t AVIIF_KEYFRAME = 0x10;
+
+// Most players only support AVI 1.0 files smaller than 1 GB
+const uint64_t MAX_FILE_SIZE = 1ull << 30;
+const size_t INDEX_ENTRY_SIZE = 16;
+const size_t CHUNK_HEADER_SIZE = 8;
+
+/** @return the name of the file with the given number, e.g. video_0002.avi */
+std::string getNumberedFilename(const std::string& filename,
+                                const size_t number)
+{
+    std::string extension;
+    const size_t dot = filename.find_last_of('.');
+    const size_t slash = filename.find_last_of('/');
+    if (dot != std::string::npos &&
+        (slash == std::string::npos || dot > slash))
+        extension = filename.substr(dot);
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "_%04zu", number);
+    return filename.substr(0, filename.size() - extension.size()) + suffix +
+           extension;
+}
+}
+
+namespace brayns
+{
+VideoRecorderPlugin::VideoRecorderPlugin(ParametersManager& parametersManager,
+                                         KeyboardHandler& keyboardHandler)
+    : ExtensionPlugin()
+    , _parametersManager(parametersManager)
+    , _recordingEnabled(!parametersManager.getApplicationParameters()
+                             .getVideoFile()
+                             .empty())
+    , _recording(false)
+    , _compressor(tjInitCompress())
+    , _fileNumber(0)
+    , _frameRate(0)
+    , _quality(0)
+    , _nbFrames(0)
+    , _maxFrameSize(0)
+    , _frames(NB_QUEUED_FRAMES)
+    , _stopEncoding(false)
+    , _encodingFailed(false)
+{
+    keyboardHandler.registerKeyboardShortcut(
+        'v', "Start/Stop video recording",
+        [&] { _recordingEnabled = !_recordingEnabled; });
+}
+
+VideoRecorderPlugin::~VideoRecorderPlugin()
+{
+    if (_recording)
+        _stopRecording();
+    if (_compressor)
+        tjDestroy(_compressor);
+}
+
+bool VideoRecorderPlugin::run(Engine& engine)
+{
+    if (!_recordingEnabled)
+    {
+        if (_recording)
+            _stopRecording();
+        return true;
+    }
+
+    auto& frameBuffer = engine.getFrameBuffer();
+    const uint8_t* colorBuffer = frameBuffer.getColorBuffer();
+    if (!colorBuffer)
+        return true;
+
+    const Vector2ui frameSize = frameBuffer.getSize();
+    if (!_recording && !_startRecording(frameSize))
+    {
+        _recordingEnabled = false;
+        return true;
+    }
+
+    if (frameSize != _frameSize)
+    {
+        // A video has a single size: the frames recorded so far are flushed
+        // and the recording goes on in a new file, as when rolling over
+        BRAYNS_INFO << "Frame size changed from " << _frameSize << " to "
+                    << frameSize << ", starting a new video file"
+                    << std::endl;
+        _stopRecording();
+        if (!_startRecording(frameSize))
+        {
+            _recordingEnabled = false;
+            return true;
+        }
+    }
+
+    size_t index;
+    {
+        // Wait for the encoder rather than dropping frames from the video
+        std::unique_lock<std::mutex> lock(_queueMutex);
+        _queueCondition.wait(lock, [this] {
+            return _encodingFailed || !_freeFrames.empty();
+        });
+        if (!_encodingFailed)
+        {
+            index = _freeFrames.front();
+            _freeFrames.pop_front();
+        }
+    }
+    if (_encodingFailed)
+    {
+        _stopRecording();
+        _recordingEnabled = false;
+        return true;
+    }
+
+    Frame& frame = _frames[index];
+    switch (frameBuffer.getFrameBufferFormat())
+    {
+    case FrameBufferFormat::FBF_BGRA_I8:
+        frame.pixelFormat = TJPF_BGRA;
+        break;
+    case FrameBufferFormat::FBF_RGB_I8:
+        frame.pixelFormat = TJPF_RGB;
+        break;
+    default:
+        frame.pixelFormat = TJPF_RGBA;
+    }
+    frame.pixelSize = frameBuffer.getColorDepth();
+    const size_t size = frameSize.x() * frameSize.y() * frame.pixelSize;
+    frame.data.assign(colorBuffer, colorBuffer + size);
+
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _pendingFrames.push_back(index);
+    }
+    _queueCondition.notify_all();
+    return true;
+}
+
+bool VideoRecorderPlugin::_startRecording(const Vector2ui& frameSize)
+{
+    const auto& applicationParameters =
+        _parametersManager.getApplicationParameters();
+    _filename = applicationParameters.getVideoFile();
+    if (_filename.empty())
+    {
+        BRAYNS_ERROR << "No video file specified, recording is disabled"
+                     << std::endl;
+        return false;
+    }
+
+    _frameSize = frameSize;
+    _frameRate =
+        std::max(applicationParameters.getVideoFrameRate(), size_t(1));
+    _quality = applicationParameters.getJpegCompression();
+    if (!_openFile())
+        return false;
+
+    _freeFrames.clear();
+    _pendingFrames.clear();
+    for (size_t i = 0; i < _frames.size(); ++i)
+        _freeFrames.push_back(i);
+    _stopEncoding = false;
+    _encodingFailed = false;
+    _encoderThread = std::thread(&VideoRecorderPlugin::_encodeFrames, this);
+    _recording = true;
+    return true;
+}
+
+void VideoRecorderPlugin::_stopRecording()
+{
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _stopEncoding = true;
+    }
+    _queueCondition.notify_all();
+    _encoderThread.join();
+
+    _closeFile();
+    _recording = false;
+    BRAYNS_INFO << "Video recording stopped" << std::endl;
+}
+
+bool VideoRecorderPlugin::_openFile()
+{
+    // Existing files, e.g. of previous recordings, are never overwritten
+    std::string filename;
+    do
+        filename = getNumberedFilename(_filename, ++_fileNumber);
+    while (std::ifstream(filename).good());
+
+    _file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!_file.is_open())
+    {
+        BRAYNS_ERROR << "Failed to open video file " << filename << std::endl;
+        return false;
+    }
+
+    _nbFrames = 0;
+    _maxFrameSize = 0;
+    _index.clear();
+    _writeHeaders(0, 0);
+
+    BRAYNS_INFO << "Recording " << _frameSize << " video to " << filename
+                << std::endl;
+    return true;
+}
+
+void VideoRecorderPlugin::_closeFile()
+{
+    if (!_file.is_open())
+        return;
+
+    const uint32_t moviSize = uint32_t(_file.tellp() - _moviStart);
+    _writeIndex();
+    const uint32_t riffSize = uint32_t(_file.tellp()) - 8;
+    _file.seekp(0);
+    _writeHeaders(riffSize, moviSize);
+    if (!_file.good())
+        BRAYNS_ERROR << "Failed to finalize video file" << std::endl;
+    _file.close();
+
+    BRAYNS_INFO << "Video file completed after " << _nbFrames << " frames"
+                << std::endl;
+}
+
+void VideoRecorderPlugin::_encodeFrames()
+{
+    for (;;)
+    {
+        size_t index;
+        {
+            // Pending frames are flushed before the encoder stops
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _queueCondition.wait(lock, [this] {
+                return _stopEncoding || !_pendingFrames.empty();
+            });
+            if (_pendingFrames.empty())
+                return;
+            index = _pendingFrames.front();
+            _pendingFrames.pop_front();
+        }
+
+        const bool encoded = _encodeFrame(_frames[index]);
+
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+            _freeFrames.push_back(index);
+            _encodingFailed = !encoded;
+        }
+        _queueCondition.notify_all();
+        if (!encoded)
+        {
+            BRAYNS_ERROR << "Video recording stopped after a frame failed to "
+                         << "be recorded" << std::endl;
+            return;
+        }
+    }
+}
+
+bool VideoRecorderPlugin::_encodeFrame(const Frame& frame)
+{
+    // Frame buffer rows are stored bottom-up, libjpeg-turbo reverses them
+    // while compressing
+    uint8_t* jpegData = nullptr;
+    unsigned long jpegSize = 0;
+    const int32_t success =
+        tjCompress2(_compressor, const_cast<uint8_t*>(frame.data.data()),
+                    _frameSize.x(), _frameSize.x() * frame.pixelSize,
+                    _frameSize.y(), frame.pixelFormat, &jpegData, &jpegSize,
+                    TJSAMP_420, _quality, TJFLAG_BOTTOMUP);
+    if (success != 0)
+    {
+        BRAYNS_ERROR << "libjpeg-turbo image conversion failure" << std::endl;
+        return false;
+    }
+
+    // The file, including the index written when it is closed, must stay
+    // below the maximum size
+    const uint64_t chunkSize = CHUNK_HEADER_SIZE + jpegSize + jpegSize % 2;
+    const uint64_t indexSize =
+        CHUNK_HEADER_SIZE + (_index.size() + 1) * INDEX_ENTRY_SIZE;
+    if (_nbFrames > 0 &&
+        uint64_t(_file.tellp()) + chunkSize + indexSize > MAX_FILE_SIZE)
+    {
+        _closeFile();
+        if (!_openFile())
+        {
+            tjFree(jpegData);
+            return false;
+        }
+    }
+
+    const uint32_t offset = uint32_t(_file.tellp() - _moviStart);
+    _writeFourCC("00dc");
+    _write32(jpegSize);
+    _file.write(reinterpret_cast<const char*>(jpegData), jpegSize);
+    if (jpegSize % 2 != 0)
+        _file.put(0); // Chunks are word aligned
+    tjFree(jpegData);
+    if (!_file.good())
+    {
+        BRAYNS_ERROR << "Failed to write video frame" << std::endl;
+        return false;
+    }
+
+    _index.push_back(std::make_pair(offset, uint32_t(jpegSize)));
+    _maxFrameSize = std::max(_maxFrameSize, uint32_t(jpegSize));
+    ++_nbFrames;
+    return true;
+}
+
+void VideoRecorderPlugin::_writeHeaders(const uint32_t riffSize,
+                                        const uint32_t moviSize)
+{
+    const uint32_t width = _frameSize.x();
+    const uint32_t height = _frameSize.y();
+
+    _writeFourCC("RIFF");
+    _write32(riffSize);
+    _writeFourCC("AVI ");
+
+    _writeFourCC("LIST");
+    _write32(192);
+    _writeFourCC("hdrl");
+
+    // Main AVI header
+    _writeFourCC("avih");
+    _write32(56);
+    _write32(1000000 / _frameRate);
+    _write32(_maxFrameSize * _frameRate);
+    _write32(0);
+    _write32(AVIF_HASINDEX);
+    _write32(_nbFrames);
+    _write32(0);
+    _write32(1);
+    _write32(_maxFrameSize);
+    _write32(width);
+    _write32(height);
+    for (size_t i = 0; i < 4; ++i)
+        _write32(0);
+
+    _writeFourCC("LIST");
+    _write32(116);
+    _writeFourCC("strl");
+
+    // Stream header
+    _writeFourCC("strh");
+    _write32(56);
+    _writeFourCC("vids");
+    _writeFourCC("MJPG");
+    _write32(0);
+    _write16(0);
+    _write16(0);
+    _write32(0);
+    _write32(1);
+    _write32(_frameRate);
+    _write32(0);
+    _write32(_nbFrames);
+    _write32(_maxFrameSize);
+    _write32(0xFFFFFFFF);
+    _write32(0);
+    _write16(0);
+    _write16(0);
+    _write16(width);
+    _write16(height);
+
+    // Stream format (BITMAPINFOHEADER)
+    _writeFourCC("strf");
+    _write32(40);
+    _write32(40);
+    _write32(width);
+    _write32(height);
+    _write16(1);
+    _write16(24);
+    _writeFourCC("MJPG");
+    _write32(width * height * 3);
+    for (size_t i = 0; i < 4; ++i)
+        _write32(0);
+
+    _writeFourCC("LIST");
+    _write32(moviSize);
+    _moviStart = _file.tellp();
+    _writeFourCC("movi");
+}
+
+void VideoRecorderPlugin::_writeIndex()
+{
+    _writeFourCC("idx1");
+    _write32(_index.size() * 16);
+    for (const auto& entry : _index)
+    {
+        _writeFourCC("00dc");
+        _write32(AVIIF_KEYFRAME);
+        _write32(entry.first);
+        _write32(entry.second);
+    }
+}
+
+void VideoRecorderPlugin::_write32(const uint32_t value)
+{
+    const char bytes[4] = {char(value & 0xFF), char((value >> 8) & 0xFF),
+                           char((value >> 16) & 0xFF),
+                           char((value >> 24) & 0xFF)};
+    _file.write(bytes, 4);
+}
+
+void VideoRecorderPlugin::_write16(const uint16_t value)
+{
+    const char bytes[2] = {char(value & 0xFF), char((value >> 8) & 0xFF)};
+    _file.write(bytes, 2);
+}
+
+void VideoRecorderPlugin::_writeFourCC(const char* fourCC)
+{
+    _file.write(fourCC, 4);
+}
+}
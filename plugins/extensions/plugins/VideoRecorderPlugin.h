@@ -0,0 +1,113 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef VIDEORECORDERPLUGIN_H
+#define VIDEORECORDERPLUGIN_H
+
+#include "ExtensionPlugin.h"
+
+#include <brayns/api.h>
+#include <turbojpeg.h>
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace brayns
+{
+/**
+   The VideoRecorderPlugin records the rendered frames into a Motion-JPEG AVI
+   file. Frames are copied into a bounded pool of buffers and encoded by a
+   background thread, so that recording does not slow down the rendering
+   loop unless the encoder cannot keep up. Recording is started with the
+   --video-file parameter, and can be toggled with the 'v' key. Every
+   recording is written to a new numbered file, and continues in a new file
+   when the current one reaches the size supported by AVI players or when the
+   frame size changes.
+ */
+class VideoRecorderPlugin : public ExtensionPlugin
+{
+public:
+    VideoRecorderPlugin(ParametersManager& parametersManager,
+                        KeyboardHandler& keyboardHandler);
+    ~VideoRecorderPlugin();
+
+    /** @copydoc ExtensionPlugin::run */
+    BRAYNS_API bool run(Engine& engine) final;
+
+private:
+    struct Frame
+    {
+        std::vector<uint8_t> data; // Bottom-up rows, as in the frame buffer
+        int32_t pixelFormat;
+        size_t pixelSize;
+    };
+
+    bool _startRecording(const Vector2ui& frameSize);
+    void _stopRecording();
+
+    /** Opens the next unused numbered file and writes its headers */
+    bool _openFile();
+    /** Writes the index and the final headers of the current file */
+    void _closeFile();
+
+    /** Encodes the queued frames until recording stops. Runs in
+     * _encoderThread.
+     */
+    void _encodeFrames();
+    bool _encodeFrame(const Frame& frame);
+
+    void _writeHeaders(uint32_t riffSize, uint32_t moviSize);
+    void _writeIndex();
+    void _write32(uint32_t value);
+    void _write16(uint16_t value);
+    void _writeFourCC(const char* fourCC);
+
+    ParametersManager& _parametersManager;
+    bool _recordingEnabled;
+    bool _recording;
+    tjhandle _compressor;
+
+    std::ofstream _file;
+    std::string _filename;
+    size_t _fileNumber;
+    Vector2ui _frameSize;
+    uint32_t _frameRate;
+    int32_t _quality;
+    uint32_t _nbFrames;
+    uint32_t _maxFrameSize;
+    std::streampos _moviStart;
+    std::vector<std::pair<uint32_t, uint32_t>> _index; // offset, size
+
+    // Bounded pool of frames: the render loop fills free frames while
+    // _encoderThread encodes the pending ones
+    std::vector<Frame> _frames;
+    std::deque<size_t> _freeFrames;
+    std::deque<size_t> _pendingFrames;
+    std::mutex _queueMutex;
+    std::condition_variable _queueCondition;
+    std::thread _encoderThread;
+    bool _stopEncoding;
+    bool _encodingFailed;
+};
+}
+#endif // VIDEORECORDERPLUGIN_H
@@ -26,6 +26,7 @@
 #include <brayns/common/renderer/FrameBuffer.h>
 #include <brayns/common/renderer/Renderer.h>
 #include <brayns/common/scene/Scene.h>
+#include <brayns/common/scene/SpatialIndex.h>
 #include <brayns/common/simulation/AbstractSimulationHandler.h>
 #include <brayns/common/simulation/CADiffusionSimulationHandler.h>
 #include <brayns/common/simulation/SpikeSimulationHandler.h>
@@ -35,6 +36,109 @@
 
 #include <brayns/version.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if BRAYNS_USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace
+{
+/** Converts a float to a IEEE 754 half float, rounding towards zero */
+uint16_t floatToHalf(const float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = (bits >> 16) & 0x8000;
+    const int32_t exponent = int32_t((bits >> 23) & 0xFF) - 127 + 15;
+    const uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (((bits >> 23) & 0xFF) == 0xFF) // Infinity and NaN
+        return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+    if (exponent >= 0x1F) // Overflow
+        return sign | 0x7C00;
+    if (exponent <= 0) // Denormals and underflow
+    {
+        if (exponent < -10)
+            return sign;
+        return sign | ((mantissa | 0x800000) >> (14 - exponent));
+    }
+    return sign | (exponent << 10) | (mantissa >> 13);
+}
+
+#if BRAYNS_USE_ZLIB
+const size_t COMPRESSION_BAND_HEIGHT = 64;
+
+/**
+ * Compresses an image by bands of COMPRESSION_BAND_HEIGHT rows. Each band is
+ * an independent zlib stream, which allows bands to be compressed in
+ * parallel.
+ * @return false if a band could not be compressed
+ */
+bool compressBands(const uint8_t* data, const size_t rowSize,
+                   const size_t height, brayns::uint8_ts& output,
+                   brayns::uints& chunks)
+{
+    const size_t nbBands =
+        (height + COMPRESSION_BAND_HEIGHT - 1) / COMPRESSION_BAND_HEIGHT;
+    std::vector<brayns::uint8_ts> bands(nbBands);
+    std::vector<char> valid(nbBands);
+#pragma omp parallel for
+    for (size_t i = 0; i < nbBands; ++i)
+    {
+        const size_t firstRow = i * COMPRESSION_BAND_HEIGHT;
+        const size_t nbRows =
+            std::min(COMPRESSION_BAND_HEIGHT, height - firstRow);
+        const uLong srcSize = nbRows * rowSize;
+        uLongf dstSize = compressBound(srcSize);
+        bands[i].resize(dstSize);
+        valid[i] = compress2(bands[i].data(), &dstSize,
+                             data + firstRow * rowSize, srcSize,
+                             Z_BEST_SPEED) == Z_OK;
+        bands[i].resize(dstSize);
+    }
+
+    output.clear();
+    chunks.clear();
+    if (std::find(valid.begin(), valid.end(), 0) != valid.end())
+        return false;
+    for (const auto& band : bands)
+    {
+        chunks.push_back(band.size());
+        output.insert(output.end(), band.begin(), band.end());
+    }
+    return true;
+}
+#else
+bool compressBands(const uint8_t*, const size_t, const size_t,
+                   brayns::uint8_ts&, brayns::uints&)
+{
+    return false;
+}
+#endif
+
+::brayns::v1::PickedPrimitive toPickedPrimitive(
+    const brayns::IndexedPrimitive& primitive)
+{
+    ::brayns::v1::PickedPrimitive picked;
+    picked.setModel(primitive.model);
+    picked.setInstance(primitive.instance);
+    // Both enums follow the order of the geometry types
+    picked.setType(static_cast<::brayns::v1::PrimitiveType>(primitive.type));
+    picked.setMaterial(primitive.materialId);
+    picked.setIndex(primitive.index);
+    picked.setGid(primitive.gid);
+    picked.setSection(primitive.sectionId);
+    const float position[3] = {primitive.position.x(), primitive.position.y(),
+                               primitive.position.z()};
+    picked.setPosition(position);
+    picked.setDistance(primitive.distance);
+    return picked;
+}
+}
+
 namespace brayns
 {
 ZeroEQPlugin::ZeroEQPlugin(ParametersManager& parametersManager)
@@ -42,6 +146,11 @@ ZeroEQPlugin::ZeroEQPlugin(ParametersManager& parametersManager)
     , _parametersManager(parametersManager)
     , _compressor(tjInitCompress())
     , _processingImageJpeg(false)
+    , _imageDelta(parametersManager.getApplicationParameters()
+                      .getStreamTileSize(),
+                  parametersManager.getApplicationParameters()
+                      .getStreamKeyframeInterval())
+    , _publishedImageDeltaFrame(0)
     , _dirtyEngine(false)
 {
     _setupHTTPServer();
@@ -111,10 +220,19 @@ bool ZeroEQPlugin::run(Engine& engine)
     }
 
     _forceRendering = false;
-    while (_subscriber.receive(1))
+    for (;;)
     {
+        // Only time the receive calls that processed an event, not the
+        // final timeout
+        const auto start = std::chrono::high_resolution_clock::now();
+        if (!_subscriber.receive(1))
+            break;
+        // The engine may have been recreated by the event
         if (_forceRendering)
             break;
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::high_resolution_clock::now() - start;
+        _engine->getPerformanceCounters().add(counters::HTTP, elapsed.count());
     }
     return !_forceRendering;
 }
@@ -171,6 +289,10 @@ void ZeroEQPlugin::_setupHTTPServer()
     _remoteImageJPEG.registerSerializeCallback(
         std::bind(&ZeroEQPlugin::_requestImageJPEG, this));
 
+    _httpServer->handle(_remoteImageDelta);
+    _remoteImageDelta.registerSerializeCallback(
+        std::bind(&ZeroEQPlugin::_requestImageDelta, this));
+
     _httpServer->handleGET(_remoteFrameBuffers);
     _remoteFrameBuffers.registerSerializeCallback(
         std::bind(&ZeroEQPlugin::_requestFrameBuffers, this));
@@ -232,6 +354,30 @@ void ZeroEQPlugin::_setupHTTPServer()
                            _remoteVolumeHistogram);
     _remoteVolumeHistogram.registerSerializeCallback(
         std::bind(&ZeroEQPlugin::_requestVolumeHistogram, this));
+
+    _httpServer->handleGET(_remoteStatistics);
+    _remoteStatistics.registerSerializeCallback(
+        std::bind(&ZeroEQPlugin::_requestStatistics, this));
+
+    _httpServer->handleGET(_remoteMemory);
+    _remoteMemory.registerSerializeCallback(
+        std::bind(&ZeroEQPlugin::_requestMemory, this));
+
+    _httpServer->handleGET(_remoteProgress);
+    _remoteProgress.registerSerializeCallback(
+        std::bind(&ZeroEQPlugin::_requestProgress, this));
+
+    _httpServer->handle(_remotePick);
+    _remotePick.registerDeserializedCallback(
+        std::bind(&ZeroEQPlugin::_pickUpdated, this));
+
+    _httpServer->handle(_remoteBoxQuery);
+    _remoteBoxQuery.registerDeserializedCallback(
+        std::bind(&ZeroEQPlugin::_boxQueryUpdated, this));
+
+    _httpServer->handle(_remoteSphereQuery);
+    _remoteSphereQuery.registerDeserializedCallback(
+        std::bind(&ZeroEQPlugin::_sphereQueryUpdated, this));
 }
 
 void ZeroEQPlugin::_setupRequests()
@@ -241,6 +387,15 @@ void ZeroEQPlugin::_setupRequests()
         return _publisher.publish(_remoteImageJPEG);
     };
 
+    // Subscribers receive all published images, the delta is computed against
+    // the previously published one
+    _requests[v1::ImageDelta::ZEROBUF_TYPE_IDENTIFIER()] = [&] {
+        _remoteImageDelta.setBaseFrame(_publishedImageDeltaFrame);
+        _requestImageDelta();
+        _publishedImageDeltaFrame = _remoteImageDelta.getFrame();
+        return _publisher.publish(_remoteImageDelta);
+    };
+
     _requests[ ::lexis::render::Frame::ZEROBUF_TYPE_IDENTIFIER()] = [&] {
         _requestFrame();
         return _publisher.publish(_remoteFrame);
@@ -498,18 +653,8 @@ bool ZeroEQPlugin::_requestImageJPEG()
                 resizedColorBuffer = resizedBuffer.data();
             }
 
-            int32_t pixelFormat = TJPF_RGBA;
-            switch (frameBuffer.getFrameBufferFormat())
-            {
-            case FrameBufferFormat::FBF_BGRA_I8:
-                pixelFormat = TJPF_BGRA;
-                break;
-            case FrameBufferFormat::FBF_RGB_I8:
-                pixelFormat = TJPF_RGB;
-                break;
-            default:
-                pixelFormat = TJPF_RGBA;
-            }
+            const int32_t pixelFormat =
+                _getJpegPixelFormat(frameBuffer.getFrameBufferFormat());
 
             unsigned long jpegSize =
                 newFrameSize.x() * newFrameSize.y() * sizeof(unsigned long);
@@ -526,36 +671,188 @@ bool ZeroEQPlugin::_requestImageJPEG()
     return true;
 }
 
+bool ZeroEQPlugin::_requestImageDelta()
+{
+    const auto& appParameters = _parametersManager.getApplicationParameters();
+    const auto& newFrameSize = appParameters.getJpegSize();
+    if (newFrameSize.x() == 0 || newFrameSize.y() == 0)
+    {
+        BRAYNS_ERROR << "Encountered invalid size of image delta: "
+                     << newFrameSize << std::endl;
+        return false;
+    }
+
+    FrameBuffer& frameBuffer = _engine->getFrameBuffer();
+    const auto& frameSize = frameBuffer.getSize();
+    unsigned int* colorBuffer = (unsigned int*)frameBuffer.getColorBuffer();
+    if (!colorBuffer)
+        return false;
+
+    unsigned int* resizedColorBuffer = colorBuffer;
+    uints resizedBuffer;
+    if (frameSize != newFrameSize)
+    {
+        _resizeImage(colorBuffer, frameSize, newFrameSize, resizedBuffer);
+        resizedColorBuffer = resizedBuffer.data();
+    }
+
+    // A tile size of 0 disables delta streaming: every image is a keyframe
+    // made of a single tile
+    const size_t tileSize = appParameters.getStreamTileSize();
+    _imageDelta.setTileSize(tileSize == 0 ? newFrameSize.find_max() : tileSize);
+    _imageDelta.setKeyframeInterval(appParameters.getStreamKeyframeInterval());
+    if (tileSize == 0)
+        _imageDelta.reset();
+
+    const uint8_t* image = reinterpret_cast<uint8_t*>(resizedColorBuffer);
+    const size_t pixelSize = 4;
+    _imageDelta.update(image, newFrameSize, pixelSize);
+
+    // Clients share the delta state, the tiles are computed against the last
+    // frame the requesting client received
+    const size_t baseFrame = _remoteImageDelta.getBaseFrame();
+    const bool keyframe = _imageDelta.needsKeyframe(baseFrame);
+
+    const int32_t pixelFormat =
+        _getJpegPixelFormat(frameBuffer.getFrameBufferFormat());
+    const uint32_t pitch = newFrameSize.x() * pixelSize;
+
+    uints tiles;
+    uints sizes;
+    uint8_ts data;
+    for (const auto& tile : _imageDelta.getTilesSince(baseFrame))
+    {
+        const uint8_t* tileData =
+            image + tile.origin.y() * pitch + tile.origin.x() * pixelSize;
+        unsigned long jpegSize = 0;
+        uint8_t* jpegData = _encodeJpeg(tile.size.x(), tile.size.y(),
+                                        tileData, pixelFormat, jpegSize, pitch);
+        if (!jpegData)
+            return false;
+
+        tiles.push_back(tile.origin.x());
+        tiles.push_back(tile.origin.y());
+        tiles.push_back(tile.size.x());
+        tiles.push_back(tile.size.y());
+        sizes.push_back(jpegSize);
+        data.insert(data.end(), jpegData, jpegData + jpegSize);
+        tjFree(jpegData);
+    }
+
+    _remoteImageDelta.setWidth(newFrameSize.x());
+    _remoteImageDelta.setHeight(newFrameSize.y());
+    _remoteImageDelta.setTileSize(_imageDelta.getTileSize());
+    _remoteImageDelta.setBaseFrame(baseFrame);
+    _remoteImageDelta.setFrame(_imageDelta.getFrame());
+    _remoteImageDelta.setKeyframe(keyframe);
+    _remoteImageDelta.setTiles(tiles);
+    _remoteImageDelta.setSizes(sizes);
+    _remoteImageDelta.setData(data);
+    return true;
+}
+
 bool ZeroEQPlugin::_requestFrameBuffers()
 {
     auto& frameBuffer = _engine->getFrameBuffer();
     const Vector2i frameSize = frameBuffer.getSize();
     const float* depthBuffer = frameBuffer.getDepthBuffer();
+    const uint8_t* colorBuffer = frameBuffer.getColorBuffer();
+    const auto& appParameters = _parametersManager.getApplicationParameters();
+#if BRAYNS_USE_ZLIB
+    const bool compression = appParameters.getFrameBuffersCompression();
+#else
+    const bool compression = false;
+#endif
+    bool compressed = compression;
+    const bool halfFloat = appParameters.getDepthHalfFloat();
+    const Vector2f& depthRange = appParameters.getDepthRange();
+    const size_t width = frameSize.x();
+    const size_t height = frameSize.y();
 
-    _remoteFrameBuffers.setWidth(frameSize.x());
-    _remoteFrameBuffers.setHeight(frameSize.y());
+    uint16_ts depths;
     if (depthBuffer)
     {
-        uint16_ts depths;
-        const size_t size = frameSize.x() * frameSize.y();
-        depths.reserve(size);
-        for (size_t i = 0; i < size; ++i)
-            depths.push_back(std::numeric_limits<uint16_t>::max() *
-                             depthBuffer[i]);
-        _remoteFrameBuffers.setDepth(reinterpret_cast<const uint8_t*>(
-                                         depths.data()),
-                                     depths.size() * sizeof(uint16_t));
+        depths.resize(width * height);
+        const float range = depthRange.y() - depthRange.x();
+        const float scale =
+            range > 0.f ? std::numeric_limits<uint16_t>::max() / range : 0.f;
+#pragma omp parallel for
+        for (size_t i = 0; i < depths.size(); ++i)
+        {
+            if (halfFloat)
+                depths[i] = floatToHalf(depthBuffer[i]);
+            else
+            {
+                const float normalized =
+                    (depthBuffer[i] - depthRange.x()) * scale;
+                depths[i] = static_cast<uint16_t>(
+                    std::min(std::max(normalized, 0.f),
+                             float(std::numeric_limits<uint16_t>::max())));
+            }
+        }
     }
-    else
-        _remoteFrameBuffers.setDepth(0, 0);
+    const size_t depthRowSize = width * sizeof(uint16_t);
+    const size_t colorRowSize = width * frameBuffer.getColorDepth();
 
-    const uint8_t* colorBuffer = frameBuffer.getColorBuffer();
-    if (colorBuffer)
-        _remoteFrameBuffers.setDiffuse(colorBuffer,
-                                       frameSize.x() * frameSize.y() *
-                                           frameBuffer.getColorDepth());
+    // Frame buffers are sent uncompressed rather than with missing bands
+    uint8_ts compressedDepths;
+    uints depthChunks;
+    if (compressed && depthBuffer)
+    {
+        // Delta encoding makes depth much more compressible
+        uint16_ts deltas(depths.size());
+#pragma omp parallel for
+        for (size_t y = 0; y < height; ++y)
+        {
+            uint16_t previous = 0;
+            for (size_t x = 0; x < width; ++x)
+            {
+                const size_t i = y * width + x;
+                deltas[i] = depths[i] - previous;
+                previous = depths[i];
+            }
+        }
+        compressed =
+            compressBands(reinterpret_cast<const uint8_t*>(deltas.data()),
+                          depthRowSize, height, compressedDepths, depthChunks);
+    }
+    uint8_ts compressedColors;
+    uints diffuseChunks;
+    if (compressed && colorBuffer)
+        compressed = compressBands(colorBuffer, colorRowSize, height,
+                                   compressedColors, diffuseChunks);
+    if (compression && !compressed)
+    {
+        BRAYNS_ERROR << "Could not compress the frame buffers, sending them "
+                        "uncompressed"
+                     << std::endl;
+        depthChunks.clear();
+    }
+
+    _remoteFrameBuffers.setWidth(frameSize.x());
+    _remoteFrameBuffers.setHeight(frameSize.y());
+    _remoteFrameBuffers.setDepthHalfFloat(halfFloat);
+    _remoteFrameBuffers.setDepthNear(depthRange.x());
+    _remoteFrameBuffers.setDepthFar(depthRange.y());
+    _remoteFrameBuffers.setCompressed(compressed);
+
+    if (!depthBuffer)
+        _remoteFrameBuffers.setDepth(0, 0);
+    else if (compressed)
+        _remoteFrameBuffers.setDepth(compressedDepths);
     else
+        _remoteFrameBuffers.setDepth(
+            reinterpret_cast<const uint8_t*>(depths.data()),
+            depthRowSize * height);
+    _remoteFrameBuffers.setDepthChunks(depthChunks);
+
+    if (!colorBuffer)
         _remoteFrameBuffers.setDiffuse(0, 0);
+    else if (compressed)
+        _remoteFrameBuffers.setDiffuse(compressedColors);
+    else
+        _remoteFrameBuffers.setDiffuse(colorBuffer, colorRowSize * height);
+    _remoteFrameBuffers.setDiffuseChunks(diffuseChunks);
 
     return true;
 }
@@ -665,70 +962,98 @@ void ZeroEQPlugin::_initializeDataSource()
         geometryParameters.getMetaballsThreshold());
     _remoteDataSource.setMetaballsSamplesFromSoma(
         geometryParameters.getMetaballsSamplesFromSoma());
+
+    // Values the parameters were loaded with, so that only the ones that
+    // change are applied
+    _updateDataSourceValues();
+    _changedDataSourceValues.clear();
+    _dataSourceValues["splash-scene-folder"] =
+        geometryParameters.getSplashSceneFolder();
 }
 
 void ZeroEQPlugin::_dataSourceUpdated()
+{
+    // Only the parameters that changed are applied, so that data sources can
+    // be added or removed without reloading the others
+    _updateDataSourceValues();
+    if (_changedDataSourceValues.empty())
+        return;
+
+    for (const auto& parameter : _changedDataSourceValues)
+        _parametersManager.set(parameter, _dataSourceValues[parameter]);
+    _parametersManager.print();
+
+    strings parameters;
+    parameters.swap(_changedDataSourceValues);
+    if (_engine->updateDataSources && _engine->updateDataSources(parameters))
+        return;
+
+    _dirtyEngine = true;
+    _onChangeEngine();
+}
+
+void ZeroEQPlugin::_updateDataSourceValues()
 {
     auto& geometryParameters = _parametersManager.getGeometryParameters();
 
-    _parametersManager.set("splash-scene-folder",
+    _changeDataSourceValue("splash-scene-folder",
                            ""); // Make sure the splash scene is removed
-    _parametersManager.set("transfer-function-file",
+    _changeDataSourceValue("transfer-function-file",
                            _remoteDataSource.getTransferFunctionFileString());
-    _parametersManager.set("morphology-folder",
+    _changeDataSourceValue("morphology-folder",
                            _remoteDataSource.getMorphologyFolderString());
-    _parametersManager.set("nest-circuit",
+    _changeDataSourceValue("nest-circuit",
                            _remoteDataSource.getNestCircuitString());
-    _parametersManager.set("nest-report",
+    _changeDataSourceValue("nest-report",
                            _remoteDataSource.getNestReportString());
-    _parametersManager.set("pdb-file", _remoteDataSource.getPdbFileString());
-    _parametersManager.set("pdb-folder",
+    _changeDataSourceValue("pdb-file", _remoteDataSource.getPdbFileString());
+    _changeDataSourceValue("pdb-folder",
                            _remoteDataSource.getPdbFolderString());
-    _parametersManager.set("xyzb-file", _remoteDataSource.getXyzbFileString());
-    _parametersManager.set("mesh-folder",
+    _changeDataSourceValue("xyzb-file", _remoteDataSource.getXyzbFileString());
+    _changeDataSourceValue("mesh-folder",
                            _remoteDataSource.getMeshFolderString());
-    _parametersManager.set("circuit-config",
+    _changeDataSourceValue("circuit-config",
                            _remoteDataSource.getCircuitConfigString());
-    _parametersManager.set("load-cache-file",
+    _changeDataSourceValue("load-cache-file",
                            _remoteDataSource.getLoadCacheFileString());
-    _parametersManager.set("save-cache-file",
+    _changeDataSourceValue("save-cache-file",
                            _remoteDataSource.getSaveCacheFileString());
-    _parametersManager.set("radius-multiplier",
+    _changeDataSourceValue("radius-multiplier",
                            std::to_string(
                                _remoteDataSource.getRadiusMultiplier()));
-    _parametersManager.set("radius-correction",
+    _changeDataSourceValue("radius-correction",
                            std::to_string(
                                _remoteDataSource.getRadiusCorrection()));
-    _parametersManager.set("color-scheme",
+    _changeDataSourceValue("color-scheme",
                            geometryParameters.getColorSchemeAsString(
                                static_cast<ColorScheme>(
                                    _remoteDataSource.getColorScheme())));
-    _parametersManager.set("scene-environment",
+    _changeDataSourceValue("scene-environment",
                            geometryParameters.getSceneEnvironmentAsString(
                                static_cast<SceneEnvironment>(
                                    _remoteDataSource.getSceneEnvironment())));
-    _parametersManager.set("geometry-quality",
+    _changeDataSourceValue("geometry-quality",
                            geometryParameters.getGeometryQualityAsString(
                                static_cast<GeometryQuality>(
                                    _remoteDataSource.getGeometryQuality())));
-    _parametersManager.set("target", _remoteDataSource.getTargetString());
-    _parametersManager.set("report", _remoteDataSource.getReportString());
-    _parametersManager.set("non-simulated-cells",
+    _changeDataSourceValue("target", _remoteDataSource.getTargetString());
+    _changeDataSourceValue("report", _remoteDataSource.getReportString());
+    _changeDataSourceValue("non-simulated-cells",
                            std::to_string(
                                _remoteDataSource.getNonSimulatedCells()));
-    _parametersManager.set("start-simulation-time",
+    _changeDataSourceValue("start-simulation-time",
                            std::to_string(
                                _remoteDataSource.getStartSimulationTime()));
-    _parametersManager.set("end-simulation-time",
+    _changeDataSourceValue("end-simulation-time",
                            std::to_string(
                                _remoteDataSource.getEndSimulationTime()));
-    _parametersManager.set(
+    _changeDataSourceValue(
         "simulation-values-range",
         std::to_string(_remoteDataSource.getSimulationValuesRange()[0]) + " " +
             std::to_string(_remoteDataSource.getSimulationValuesRange()[1]));
-    _parametersManager.set("simulation-cache-file",
+    _changeDataSourceValue("simulation-cache-file",
                            _remoteDataSource.getSimulationCacheFileString());
-    _parametersManager.set("nest-cache-file",
+    _changeDataSourceValue("nest-cache-file",
                            _remoteDataSource.getNestCacheFileString());
 
     uint morphologySectionTypes = MST_UNDEFINED;
@@ -753,7 +1078,7 @@ void ZeroEQPlugin::_dataSourceUpdated()
             morphologySectionTypes |= MST_ALL;
         }
     }
-    _parametersManager.set("morphology-section-types",
+    _changeDataSourceValue("morphology-section-types",
                            std::to_string(morphologySectionTypes));
 
     const auto remoteMorphologyLayout = _remoteDataSource.getMorphologyLayout();
@@ -763,52 +1088,58 @@ void ZeroEQPlugin::_dataSourceUpdated()
         " " + std::to_string(remoteMorphologyLayout.getVerticalSpacing());
     layoutAsString +=
         " " + std::to_string(remoteMorphologyLayout.getHorizontalSpacing());
-    _parametersManager.set("morphology-layout", layoutAsString);
+    _changeDataSourceValue("morphology-layout", layoutAsString);
 
-    _parametersManager.set("generate-multiple-models",
+    _changeDataSourceValue("generate-multiple-models",
                            (_remoteDataSource.getGenerateMultipleModels()
                                 ? "1"
                                 : "0"));
-    _parametersManager.set("volume-folder",
+    _changeDataSourceValue("volume-folder",
                            _remoteDataSource.getVolumeFolderString());
-    _parametersManager.set("volume-file",
+    _changeDataSourceValue("volume-file",
                            _remoteDataSource.getVolumeFileString());
-    _parametersManager.set(
+    _changeDataSourceValue(
         "volume-dimensions",
         std::to_string(_remoteDataSource.getVolumeDimensions()[0]) + " " +
             std::to_string(_remoteDataSource.getVolumeDimensions()[1]) + " " +
             std::to_string(_remoteDataSource.getVolumeDimensions()[2]));
-    _parametersManager.set(
+    _changeDataSourceValue(
         "volume-element-spacing",
         std::to_string(_remoteDataSource.getVolumeElementSpacing()[0]) + " " +
             std::to_string(_remoteDataSource.getVolumeElementSpacing()[1]) +
             " " +
             std::to_string(_remoteDataSource.getVolumeElementSpacing()[2]));
-    _parametersManager.set(
+    _changeDataSourceValue(
         "volume-offset",
         std::to_string(_remoteDataSource.getVolumeOffset()[0]) + " " +
             std::to_string(_remoteDataSource.getVolumeOffset()[1]) + " " +
             std::to_string(_remoteDataSource.getVolumeOffset()[2]));
-    _parametersManager.set("environment-map",
+    _changeDataSourceValue("environment-map",
                            _remoteDataSource.getEnvironmentMapString());
 
-    _parametersManager.set("molecular-system-config",
+    _changeDataSourceValue("molecular-system-config",
                            _remoteDataSource.getMolecularSystemConfigString());
 
-    _parametersManager.set("metaballs-grid-size",
+    _changeDataSourceValue("metaballs-grid-size",
                            std::to_string(
                                _remoteDataSource.getMetaballsGridSize()));
-    _parametersManager.set("metaballs-threshold",
+    _changeDataSourceValue("metaballs-threshold",
                            std::to_string(
                                _remoteDataSource.getMetaballsThreshold()));
-    _parametersManager.set(
+    _changeDataSourceValue(
         "metaballs-samples-from-soma",
         std::to_string(_remoteDataSource.getMetaballsSamplesFromSoma()));
 
-    _parametersManager.print();
+}
 
-    _dirtyEngine = true;
-    _onChangeEngine();
+void ZeroEQPlugin::_changeDataSourceValue(const std::string& parameter,
+                                          const std::string& value)
+{
+    auto& currentValue = _dataSourceValues[parameter];
+    if (currentValue == value)
+        return;
+    currentValue = value;
+    _changedDataSourceValues.push_back(parameter);
 }
 
 void ZeroEQPlugin::_initializeSettings()
@@ -877,6 +1208,12 @@ void ZeroEQPlugin::_initializeSettings()
         applicationParameters.getJpegCompression());
     const auto& jpegSize = applicationParameters.getJpegSize();
     _remoteSettings.setJpegSize({jpegSize[0], jpegSize[1]});
+    const auto& depthRange = applicationParameters.getDepthRange();
+    _remoteSettings.setDepthRange({depthRange[0], depthRange[1]});
+    _remoteSettings.setDepthHalfFloat(
+        applicationParameters.getDepthHalfFloat());
+    _remoteSettings.setFrameBuffersCompression(
+        applicationParameters.getFrameBuffersCompression());
 }
 
 void ZeroEQPlugin::_settingsUpdated()
@@ -960,14 +1297,20 @@ void ZeroEQPlugin::_settingsUpdated()
     app.setJpegSize(Vector2ui{_remoteSettings.getJpegSize()});
     app.setJpegCompression(
         std::min(_remoteSettings.getJpegCompression(), 100u));
+    app.setDepthRange(Vector2f{_remoteSettings.getDepthRange()});
+    app.setDepthHalfFloat(_remoteSettings.getDepthHalfFloat());
+    app.setFrameBuffersCompression(
+        _remoteSettings.getFrameBuffersCompression());
 
     if (_engine->name() !=
         _parametersManager.getRenderingParameters().getEngine())
         _onChangeEngine();
     else
     {
+        // Settings that do not affect the image keep the accumulation
         _engine->getRenderer().commit();
-        _engine->getFrameBuffer().clear();
+        if (_engine->getRenderer().getModified())
+            _engine->getFrameBuffer().clear();
     }
 }
 
@@ -1013,9 +1356,11 @@ void ZeroEQPlugin::_frameUpdated()
     {
         auto& scene = _engine->getScene();
         handler->setFrame(scene, _remoteFrame.getCurrent());
-        scene.setSpheresDirty(true);
+        // Only the first frame creates spheres, the following ones update
+        // the serialized centers in place
         scene.serializeGeometry();
         scene.commit();
+        _engine->getFrameBuffer().clear();
     }
 
     _engine->commit();
@@ -1062,6 +1407,114 @@ bool ZeroEQPlugin::_requestVolumeHistogram()
     return true;
 }
 
+bool ZeroEQPlugin::_requestStatistics()
+{
+    if (!_engine)
+        return false;
+
+    auto& remoteCounters = _remoteStatistics.getCounters();
+    remoteCounters.clear();
+    const auto statistics = _engine->getPerformanceCounters().getStatistics();
+    for (const auto& counter : statistics)
+    {
+        ::brayns::v1::Counter c;
+        c.setName(counter.first);
+        c.setLast(counter.second.last);
+        c.setMin(counter.second.min);
+        c.setAverage(counter.second.average);
+        c.setP95(counter.second.p95);
+        c.setCount(counter.second.count);
+        remoteCounters.push_back(c);
+    }
+    return true;
+}
+
+bool ZeroEQPlugin::_requestMemory()
+{
+    if (!_engine)
+        return false;
+
+    auto& registry = _engine->getMemoryRegistry();
+    _engine->updateMemoryUsage();
+
+    auto& owners = _remoteMemory.getOwners();
+    owners.clear();
+    for (const auto& usage : registry.getUsages())
+    {
+        ::brayns::v1::MemoryOwner owner;
+        owner.setName(usage.first);
+        owner.setResident(usage.second.resident);
+        owner.setReserved(usage.second.reserved);
+        owners.push_back(owner);
+    }
+    const auto total = registry.getTotal();
+    _remoteMemory.setBudget(registry.getBudget());
+    _remoteMemory.setResident(total.resident);
+    _remoteMemory.setReserved(total.reserved);
+    return true;
+}
+
+bool ZeroEQPlugin::_requestProgress()
+{
+    if (!_engine)
+        return false;
+
+    _remoteProgress.setOperation(_engine->getLoadingOperation());
+    _remoteProgress.setAmount(_engine->getLoadingProgress());
+    return true;
+}
+
+void ZeroEQPlugin::_pickUpdated()
+{
+    auto& primitives = _remotePick.getPrimitives();
+    primitives.clear();
+
+    Vector3f origin;
+    Vector3f direction;
+    _engine->getCamera().getPrimaryRay(
+        Vector2f(_remotePick.getX(), _remotePick.getY()), origin, direction);
+
+    IndexedPrimitive primitive;
+    if (_engine->getScene().getSpatialIndex().intersect(origin, direction,
+                                                        primitive))
+        primitives.push_back(toPickedPrimitive(primitive));
+}
+
+void ZeroEQPlugin::_boxQueryUpdated()
+{
+    const auto& min = _remoteBoxQuery.getMin();
+    const auto& max = _remoteBoxQuery.getMax();
+    const Boxf box(Vector3f(min[0], min[1], min[2]),
+                   Vector3f(max[0], max[1], max[2]));
+
+    IndexedPrimitives found;
+    const size_t count = _engine->getScene().getSpatialIndex().queryBox(
+        box, _remoteBoxQuery.getMaxPrimitives(), found);
+
+    auto& primitives = _remoteBoxQuery.getPrimitives();
+    primitives.clear();
+    for (const auto& primitive : found)
+        primitives.push_back(toPickedPrimitive(primitive));
+    _remoteBoxQuery.setCount(count);
+}
+
+void ZeroEQPlugin::_sphereQueryUpdated()
+{
+    const auto& center = _remoteSphereQuery.getCenter();
+
+    IndexedPrimitives found;
+    const size_t count = _engine->getScene().getSpatialIndex().querySphere(
+        Vector3f(center[0], center[1], center[2]),
+        _remoteSphereQuery.getRadius(), _remoteSphereQuery.getMaxPrimitives(),
+        found);
+
+    auto& primitives = _remoteSphereQuery.getPrimitives();
+    primitives.clear();
+    for (const auto& primitive : found)
+        primitives.push_back(toPickedPrimitive(primitive));
+    _remoteSphereQuery.setCount(count);
+}
+
 void ZeroEQPlugin::_clipPlanesUpdated()
 {
     const auto& bounds = _engine->getScene().getWorldBounds();
@@ -1107,17 +1560,20 @@ bool ZeroEQPlugin::_requestClipPlanes()
 uint8_t* ZeroEQPlugin::_encodeJpeg(const uint32_t width, const uint32_t height,
                                    const uint8_t* rawData,
                                    const int32_t pixelFormat,
-                                   unsigned long& dataSize)
+                                   unsigned long& dataSize,
+                                   const uint32_t pitch)
 {
     uint8_t* tjSrcBuffer = const_cast<uint8_t*>(rawData);
     const int32_t color_components = 4; // Color Depth
-    const int32_t tjPitch = width * color_components;
+    const int32_t tjPitch = pitch == 0 ? width * color_components : pitch;
     const int32_t tjPixelFormat = pixelFormat;
 
     uint8_t* tjJpegBuf = 0;
     const int32_t tjJpegSubsamp = TJSAMP_444;
     const int32_t tjFlags = TJXOP_ROT180;
 
+    PerformanceCounters::ScopedTimer timer(_engine->getPerformanceCounters(),
+                                           counters::JPEG_ENCODING);
     const int32_t success = tjCompress2(
         _compressor, tjSrcBuffer, width, tjPitch, height, tjPixelFormat,
         &tjJpegBuf, &dataSize, tjJpegSubsamp,
@@ -1131,4 +1587,17 @@ uint8_t* ZeroEQPlugin::_encodeJpeg(const uint32_t width, const uint32_t height,
     }
     return static_cast<uint8_t*>(tjJpegBuf);
 }
+
+int32_t ZeroEQPlugin::_getJpegPixelFormat(const FrameBufferFormat format) const
+{
+    switch (format)
+    {
+    case FrameBufferFormat::FBF_BGRA_I8:
+        return TJPF_BGRA;
+    case FrameBufferFormat::FBF_RGB_I8:
+        return TJPF_RGB;
+    default:
+        return TJPF_RGBA;
+    }
+}
 }
@@ -24,6 +24,7 @@
 #include "ExtensionPlugin.h"
 
 #include <brayns/api.h>
+#include <brayns/common/utils/ImageDelta.h>
 #include <turbojpeg.h>
 #include <zeroeq/http/server.h>
 #include <zeroeq/zeroeq.h>
@@ -36,10 +37,15 @@
 #include <lexis/render/viewport.h>
 
 #include <zerobuf/render/frameBuffers.h>
+#include <zerobuf/render/imageDelta.h>
+#include <zerobuf/render/memory.h>
 #include <zerobuf/render/parameters.h>
+#include <zerobuf/render/picking.h>
+#include <zerobuf/render/progress.h>
 #include <zerobuf/render/reset.h>
 #include <zerobuf/render/scene.h>
 #include <zerobuf/render/spikes.h>
+#include <zerobuf/render/statistics.h>
 
 namespace brayns
 {
@@ -125,6 +131,13 @@ private:
      */
     bool _requestImageJPEG();
 
+    /**
+     * @brief This method is called when the tiles that changed since the last
+     * streamed image are requested by a ZeroEQ event
+     * @return True if the method was successful, false otherwise
+     */
+    bool _requestImageDelta();
+
     /**
      * @brief This method is called when frame buffers is requested by a ZeroEQ
      * event
@@ -150,6 +163,14 @@ private:
      */
     void _dataSourceUpdated();
 
+    /**
+     * @brief Converts the data source into parameter values, and records the
+     * parameters whose value changed
+     */
+    void _updateDataSourceValues();
+    void _changeDataSourceValue(const std::string& parameter,
+                                const std::string& value);
+
     /**
      * @brief This method initializes data sources according to default
      * application parameters
@@ -201,6 +222,45 @@ private:
      */
     bool _requestVolumeHistogram();
 
+    /**
+     * @brief This method is called when the performance counters are requested
+     * by a ZeroEQ event
+     * @return True if the method was successful, false otherwise
+     */
+    bool _requestStatistics();
+
+    /**
+     * @brief This method is called when the memory usage is requested by a
+     * ZeroEQ event
+     * @return True if the method was successful, false otherwise
+     */
+    bool _requestMemory();
+
+    /**
+     * @brief This method is called when the progress of the data loading is
+     * requested by a ZeroEQ event
+     * @return True if the method was successful, false otherwise
+     */
+    bool _requestProgress();
+
+    /**
+     * @brief This method is called when the point to pick is updated by a
+     * ZeroEQ event
+     */
+    void _pickUpdated();
+
+    /**
+     * @brief This method is called when the box to query is updated by a
+     * ZeroEQ event
+     */
+    void _boxQueryUpdated();
+
+    /**
+     * @brief This method is called when the sphere to query is updated by a
+     * ZeroEQ event
+     */
+    void _sphereQueryUpdated();
+
     /**
      * @brief This method is called when the clip planes are updated by a ZeroEQ
      * event
@@ -231,11 +291,18 @@ private:
      * @param rawData Source buffer
      * @param pixelFormat pixel format of rawData
      * @param dataSize Returned buffer size
+     * @param pitch Size of a row of rawData in bytes, 0 for width * 4
      * @return Destination buffer
      */
     uint8_t* _encodeJpeg(const uint32_t width, const uint32_t height,
                          const uint8_t* rawData, const int32_t pixelFormat,
-                         unsigned long& dataSize);
+                         unsigned long& dataSize, const uint32_t pitch = 0);
+
+    /**
+     * @brief Returns the libjpeg-turbo pixel format matching the given frame
+     * buffer format
+     */
+    int32_t _getJpegPixelFormat(FrameBufferFormat format) const;
 
     void _onNewEngine();
     void _onChangeEngine();
@@ -250,6 +317,8 @@ private:
     typedef std::map<::zeroeq::uint128_t, RequestFunc> RequestFuncs;
     RequestFuncs _requests;
     bool _processingImageJpeg;
+    ImageDelta _imageDelta;
+    uint64_t _publishedImageDeltaFrame;
 
     ::lexis::render::Frame _remoteFrame;
     ::lexis::render::ImageJPEG _remoteImageJPEG;
@@ -260,12 +329,21 @@ private:
     ::lexis::render::MaterialLUT _remoteMaterialLUT;
 
     ::brayns::v1::DataSource _remoteDataSource;
+    std::map<std::string, std::string> _dataSourceValues;
+    strings _changedDataSourceValues;
     ::brayns::v1::Settings _remoteSettings;
     ::brayns::v1::Spikes _remoteSpikes;
     ::brayns::v1::FrameBuffers _remoteFrameBuffers;
+    ::brayns::v1::ImageDelta _remoteImageDelta;
     ::brayns::v1::Material _remoteMaterial;
+    ::brayns::v1::Memory _remoteMemory;
+    ::brayns::v1::Progress _remoteProgress;
+    ::brayns::v1::Pick _remotePick;
+    ::brayns::v1::BoxQuery _remoteBoxQuery;
+    ::brayns::v1::SphereQuery _remoteSphereQuery;
     ::brayns::v1::ResetCamera _remoteResetCamera;
     ::brayns::v1::Scene _remoteScene;
+    ::brayns::v1::Statistics _remoteStatistics;
 
     bool _forceRendering = false;
     bool _dirtyEngine;
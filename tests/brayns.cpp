@@ -172,3 +172,21 @@ BOOST_AUTO_TEST_CASE(render_two_frames_and_compare_they_are_same)
                                   fb.getColorBuffer() + bytes);
     fb.unmap();
 }
+
+BOOST_AUTO_TEST_CASE(moving_camera_lowers_resolution)
+{
+    // A frame rate that cannot be reached at full resolution
+    const char* argv[] = {"brayns", "--target-fps", "100000"};
+    brayns::Brayns brayns(3, argv);
+
+    auto& engine = brayns.getEngine();
+    auto& fb = engine.getFrameBuffer();
+    brayns.render();
+    brayns.render();
+    BOOST_CHECK_EQUAL(fb.getScale(), 1.f);
+
+    auto& camera = engine.getCamera();
+    camera.setPosition(camera.getPosition() + brayns::Vector3f(0.f, 0.f, 1.f));
+    brayns.render();
+    BOOST_CHECK_LT(fb.getScale(), 1.f);
+}
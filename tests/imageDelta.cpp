@@ -0,0 +1,103 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/utils/ImageDelta.h>
+
+#define BOOST_TEST_MODULE imageDelta
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+const brayns::Vector2ui imageSize(100, 70);
+const size_t pixelSize = 4;
+}
+
+BOOST_AUTO_TEST_CASE(first_image_is_keyframe)
+{
+    brayns::ImageDelta delta(32, 0);
+    brayns::uint8_ts image(imageSize.x() * imageSize.y() * pixelSize, 0);
+
+    BOOST_CHECK(delta.update(image.data(), imageSize, pixelSize));
+    BOOST_CHECK_EQUAL(delta.getTiles().size(), 4 * 3);
+
+    BOOST_CHECK(!delta.update(image.data(), imageSize, pixelSize));
+    BOOST_CHECK(delta.getTiles().empty());
+    BOOST_CHECK_EQUAL(delta.getFrame(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(dirty_tiles)
+{
+    brayns::ImageDelta delta(32, 0);
+    brayns::uint8_ts image(imageSize.x() * imageSize.y() * pixelSize, 0);
+    delta.update(image.data(), imageSize, pixelSize);
+
+    // Change one pixel in the last, partial tile
+    image[(65 * imageSize.x() + 99) * pixelSize] = 255;
+    BOOST_CHECK(!delta.update(image.data(), imageSize, pixelSize));
+    BOOST_REQUIRE_EQUAL(delta.getTiles().size(), 1);
+    const auto& tile = delta.getTiles()[0];
+    BOOST_CHECK_EQUAL(tile.origin, brayns::Vector2ui(96, 64));
+    BOOST_CHECK_EQUAL(tile.size, brayns::Vector2ui(4, 6));
+}
+
+BOOST_AUTO_TEST_CASE(keyframes)
+{
+    brayns::ImageDelta delta(32, 3);
+    brayns::uint8_ts image(imageSize.x() * imageSize.y() * pixelSize, 0);
+
+    BOOST_CHECK(delta.update(image.data(), imageSize, pixelSize));
+    BOOST_CHECK(!delta.update(image.data(), imageSize, pixelSize));
+    BOOST_CHECK(!delta.update(image.data(), imageSize, pixelSize));
+    BOOST_CHECK(delta.update(image.data(), imageSize, pixelSize));
+
+    delta.reset();
+    BOOST_CHECK(delta.update(image.data(), imageSize, pixelSize));
+
+    const brayns::Vector2ui newSize(50, 50);
+    BOOST_CHECK(delta.update(image.data(), newSize, pixelSize));
+}
+
+BOOST_AUTO_TEST_CASE(tiles_since_frame)
+{
+    brayns::ImageDelta delta(32, 0);
+    brayns::uint8_ts image(imageSize.x() * imageSize.y() * pixelSize, 0);
+    delta.update(image.data(), imageSize, pixelSize);
+
+    // Frame 2 changes the first tile, frame 3 the last one
+    image[0] = 255;
+    delta.update(image.data(), imageSize, pixelSize);
+    image[(65 * imageSize.x() + 99) * pixelSize] = 255;
+    delta.update(image.data(), imageSize, pixelSize);
+
+    BOOST_CHECK(!delta.needsKeyframe(1));
+    BOOST_CHECK_EQUAL(delta.getTilesSince(1).size(), 2);
+    BOOST_CHECK_EQUAL(delta.getTilesSince(2).size(), 1);
+    BOOST_CHECK(delta.getTilesSince(3).empty());
+
+    // Clients without image, or with an unknown one, get a keyframe
+    BOOST_CHECK(delta.needsKeyframe(0));
+    BOOST_CHECK_EQUAL(delta.getTilesSince(0).size(), 4 * 3);
+    BOOST_CHECK(delta.needsKeyframe(4));
+
+    delta.reset();
+    delta.update(image.data(), imageSize, pixelSize);
+    BOOST_CHECK(delta.needsKeyframe(3));
+    BOOST_CHECK(!delta.needsKeyframe(4));
+}
@@ -0,0 +1,176 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/scene/Scene.h>
+#include <brayns/io/MeshLoader.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#define BOOST_TEST_MODULE meshLoader
+#include <boost/test/unit_test.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace
+{
+/** Scene holding geometry only, without any engine counterpart */
+class TestScene : public brayns::Scene
+{
+public:
+    TestScene(brayns::ParametersManager& parametersManager)
+        : brayns::Scene(brayns::Renderers(), parametersManager)
+    {
+        setMaterials(brayns::MT_DEFAULT, brayns::NB_MAX_MATERIALS);
+    }
+
+    void commit() final {}
+    void commitMaterials(const bool) final {}
+    void commitLights() final {}
+    void buildGeometry() final {}
+    uint64_t serializeGeometry() final { return 0; }
+    void commitSimulationData() final {}
+    void commitVolumeData() final {}
+    void commitTransferFunctionData() final {}
+    void saveSceneToCacheFile() final {}
+    bool isVolumeSupported(const std::string&) const final { return false; }
+};
+
+const size_t MATERIAL = 1;
+
+/**
+ * Quad made of two triangles. The second triangle gives the shared corner
+ * (1, 1, 0) a texture coordinate that only differs from the one of the first
+ * triangle by much less than the precision of half floats, so that the corner
+ * is only welded when texture coordinates are quantized.
+ */
+const char* const OBJ_FILE =
+    "v 0 0 0\n"
+    "v 1 0 0\n"
+    "v 1 1 0\n"
+    "v 0 1 0\n"
+    "vt 0 0\n"
+    "vt 1 0\n"
+    "vt 1 1\n"
+    "vt 0 1\n"
+    "vt 1.0001 1\n"
+    "vn 0 0 1\n"
+    "f 1/1/1 2/2/1 3/3/1\n"
+    "f 1/1/1 3/5/1 4/4/1\n";
+
+struct MeshFile
+{
+    MeshFile()
+        : folder(boost::filesystem::temp_directory_path() /
+                 boost::filesystem::unique_path("%%%%-%%%%"))
+        , filename((folder / "quad.obj").string())
+        , cacheFile(filename + ".meshcache")
+    {
+        boost::filesystem::create_directories(folder);
+        std::ofstream file(filename);
+        file << OBJ_FILE;
+    }
+
+    ~MeshFile() { boost::filesystem::remove_all(folder); }
+
+    void setQuantization(const bool quantize)
+    {
+        const char* argv[] = {"meshLoader", "--mesh-quantization",
+                              quantize ? "true" : "false"};
+        BOOST_REQUIRE(geometryParameters.parse(3, argv));
+    }
+
+    brayns::TrianglesMesh import()
+    {
+        brayns::ParametersManager parametersManager;
+        TestScene scene(parametersManager);
+        brayns::MeshLoader loader(geometryParameters);
+        BOOST_REQUIRE(loader.importMeshFromFile(
+            filename, scene, brayns::MeshQuality::low,
+            brayns::Vector3f(0.f, 0.f, 0.f), brayns::Vector3f(1.f, 1.f, 1.f),
+            MATERIAL));
+        BOOST_REQUIRE_EQUAL(scene.getTriangleMeshes().size(), 1);
+        return scene.getTriangleMeshes()[MATERIAL];
+    }
+
+    const boost::filesystem::path folder;
+    const std::string filename;
+    const std::string cacheFile;
+    brayns::GeometryParameters geometryParameters;
+};
+
+void checkEqual(brayns::TrianglesMesh& mesh, brayns::TrianglesMesh& expected)
+{
+    BOOST_CHECK(mesh.getVertices() == expected.getVertices());
+    BOOST_CHECK(mesh.getNormals() == expected.getNormals());
+    BOOST_CHECK(mesh.getTextureCoordinates() ==
+                expected.getTextureCoordinates());
+    BOOST_CHECK(mesh.getColors() == expected.getColors());
+    BOOST_CHECK(mesh.getIndices() == expected.getIndices());
+}
+}
+
+BOOST_FIXTURE_TEST_CASE(weld_and_read_back, MeshFile)
+{
+    auto imported = import();
+    BOOST_REQUIRE(boost::filesystem::exists(cacheFile));
+
+    // The corner with two texture coordinates is not welded
+    BOOST_CHECK_EQUAL(imported.getVertices().size(), 5);
+    BOOST_CHECK_EQUAL(imported.getNormals().size(), 5);
+    BOOST_CHECK_EQUAL(imported.getTextureCoordinates().size(), 5);
+    BOOST_CHECK_EQUAL(imported.getIndices().size(), 2);
+
+    auto cached = import();
+    checkEqual(cached, imported);
+}
+
+BOOST_FIXTURE_TEST_CASE(quantize_and_read_back, MeshFile)
+{
+    // Caches of other import options are not reused
+    import();
+    setQuantization(true);
+    auto imported = import();
+
+    BOOST_CHECK_EQUAL(imported.getVertices().size(), 4);
+    BOOST_CHECK_EQUAL(imported.getIndices().size(), 2);
+    for (const auto& textureCoordinate : imported.getTextureCoordinates())
+        BOOST_CHECK(textureCoordinate.x() == 0.f ||
+                    textureCoordinate.x() == 1.f);
+
+    // Quantized attributes read back from the cache are the welded ones
+    auto cached = import();
+    checkEqual(cached, imported);
+}
+
+BOOST_FIXTURE_TEST_CASE(reject_truncated_cache, MeshFile)
+{
+    auto imported = import();
+    const uint64_t cacheSize = boost::filesystem::file_size(cacheFile);
+
+    for (const auto size : {cacheSize / 2, cacheSize - 1, uint64_t(8)})
+    {
+        boost::filesystem::resize_file(cacheFile, size);
+        auto reimported = import();
+        checkEqual(reimported, imported);
+        // The truncated cache is replaced by a complete one
+        BOOST_CHECK_EQUAL(boost::filesystem::file_size(cacheFile), cacheSize);
+    }
+}
@@ -0,0 +1,110 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/utils/PerformanceCounters.h>
+
+#define BOOST_TEST_MODULE performanceCounters
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+
+namespace
+{
+const std::string COUNTER = "counter";
+
+brayns::CounterStatistics getStatistics(
+    const brayns::PerformanceCounters& counters)
+{
+    const auto statistics = counters.getStatistics();
+    BOOST_REQUIRE_EQUAL(statistics.size(), 1);
+    BOOST_REQUIRE_EQUAL(statistics.begin()->first, COUNTER);
+    return statistics.begin()->second;
+}
+}
+
+BOOST_AUTO_TEST_CASE(default_window)
+{
+    // Only the last 128 samples, 73 to 200, are kept
+    brayns::PerformanceCounters counters;
+    for (size_t i = 1; i <= 200; ++i)
+        counters.add(COUNTER, i);
+
+    const auto statistics = getStatistics(counters);
+    BOOST_CHECK_EQUAL(statistics.count, 200);
+    BOOST_CHECK_EQUAL(statistics.last, 200.0);
+    BOOST_CHECK_EQUAL(statistics.min, 73.0);
+    BOOST_CHECK_CLOSE(statistics.average, 136.5, 1e-9);
+    // 122nd of the 128 samples
+    BOOST_CHECK_EQUAL(statistics.p95, 194.0);
+}
+
+BOOST_AUTO_TEST_CASE(partial_window)
+{
+    brayns::PerformanceCounters counters;
+    counters.add(COUNTER, 100.0);
+    auto statistics = getStatistics(counters);
+    BOOST_CHECK_EQUAL(statistics.count, 1);
+    BOOST_CHECK_EQUAL(statistics.min, 100.0);
+    BOOST_CHECK_EQUAL(statistics.average, 100.0);
+    BOOST_CHECK_EQUAL(statistics.p95, 100.0);
+
+    // 1 to 100, the percentile not depending on the order of the samples
+    std::vector<double> samples;
+    for (size_t i = 1; i < 100; ++i)
+        samples.push_back(i);
+    std::reverse(samples.begin(), samples.begin() + 50);
+    for (const auto sample : samples)
+        counters.add(COUNTER, sample);
+
+    statistics = getStatistics(counters);
+    BOOST_CHECK_EQUAL(statistics.count, 100);
+    BOOST_CHECK_EQUAL(statistics.last, 99.0);
+    BOOST_CHECK_EQUAL(statistics.min, 1.0);
+    BOOST_CHECK_CLOSE(statistics.average, 50.5, 1e-9);
+    BOOST_CHECK_EQUAL(statistics.p95, 95.0);
+}
+
+BOOST_AUTO_TEST_CASE(custom_window)
+{
+    brayns::PerformanceCounters counters(4);
+    for (size_t i = 10; i > 0; --i)
+        counters.add(COUNTER, i);
+
+    const auto statistics = getStatistics(counters);
+    BOOST_CHECK_EQUAL(statistics.count, 10);
+    BOOST_CHECK_EQUAL(statistics.last, 1.0);
+    BOOST_CHECK_EQUAL(statistics.min, 1.0);
+    BOOST_CHECK_CLOSE(statistics.average, 2.5, 1e-9);
+    BOOST_CHECK_EQUAL(statistics.p95, 4.0);
+}
+
+BOOST_AUTO_TEST_CASE(scoped_timer_and_clear)
+{
+    brayns::PerformanceCounters counters;
+    {
+        brayns::PerformanceCounters::ScopedTimer timer(counters, COUNTER);
+    }
+    const auto statistics = getStatistics(counters);
+    BOOST_CHECK_EQUAL(statistics.count, 1);
+    BOOST_CHECK_GE(statistics.last, 0.0);
+
+    counters.clear();
+    BOOST_CHECK(counters.getStatistics().empty());
+}
@@ -0,0 +1,141 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/common/scene/Scene.h>
+#include <brayns/io/ProteinLoader.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#define BOOST_TEST_MODULE proteinLoader
+#include <boost/test/unit_test.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace
+{
+/** Scene holding geometry only, without any engine counterpart */
+class TestScene : public brayns::Scene
+{
+public:
+    TestScene(brayns::ParametersManager& parametersManager)
+        : brayns::Scene(brayns::Renderers(), parametersManager)
+    {
+        setMaterials(brayns::MT_DEFAULT, brayns::NB_MAX_MATERIALS);
+    }
+
+    void commit() final {}
+    void commitMaterials(const bool) final {}
+    void commitLights() final {}
+    void buildGeometry() final {}
+    uint64_t serializeGeometry() final { return 0; }
+    void commitSimulationData() final {}
+    void commitVolumeData() final {}
+    void commitTransferFunctionData() final {}
+    void saveSceneToCacheFile() final {}
+    bool isVolumeSupported(const std::string&) const final { return false; }
+};
+
+// Color map indices and radii of the elements used by the test file
+const size_t MATERIAL_UNKNOWN = 0;
+const size_t MATERIAL_CARBON = 5;
+const size_t MATERIAL_NITROGEN = 6;
+const size_t MATERIAL_IRON = 25;
+const size_t MATERIAL_ZINC = 29;
+
+/** Fixed column records, some without the element column (76-77) */
+const char* const PDB_FILE =
+    "HEADER    TEST PROTEIN\n"
+    "REMARK   1 ATOMS WITH AND WITHOUT ELEMENT SYMBOLS\n"
+    "ATOM      1  N   GLY A   1       1.000   2.000   3.000  1.00 20.00"
+    "           N\n"
+    "HETATM    2 FE   HEM A   2       4.500  -5.250   6.750  1.00 20.00"
+    "          FE\n"
+    "ATOM      3  CA  GLY B   3       7.000   8.000   9.000  1.00 20.00\n"
+    "TER       4      GLY B   3\n"
+    "HETATM    4 ZN    ZN B   4      -1.500   0.000   0.250  1.00 20.00\n"
+    "HETATM    5  X1  UNK C   5       0.000   0.000  -2.000  1.00 20.00"
+    "          XX\n"
+    "END";
+
+struct ProteinFile
+{
+    ProteinFile()
+        : filename((boost::filesystem::temp_directory_path() /
+                    boost::filesystem::unique_path("%%%%-%%%%.pdb"))
+                       .string())
+        , scene(parametersManager)
+        , loader(parametersManager.getGeometryParameters())
+    {
+        std::ofstream file(filename);
+        file << PDB_FILE;
+    }
+
+    ~ProteinFile() { boost::filesystem::remove(filename); }
+
+    void checkAtom(const size_t materialId, const brayns::Vector3f& position,
+                   const float radius)
+    {
+        const auto& spheres = scene.getSpheres()[materialId];
+        BOOST_REQUIRE_EQUAL(spheres.size(), 1);
+        // Positions are converted from nanometers, radii from angstrom
+        const auto& center = spheres[0]->getCenter();
+        for (size_t i = 0; i < 3; ++i)
+            BOOST_CHECK_CLOSE(center[i] + 1.f, 0.01f * position[i] + 1.f,
+                              1e-4f);
+        BOOST_CHECK_CLOSE(spheres[0]->getRadius(), 0.0001f * radius, 1e-4f);
+    }
+
+    const std::string filename;
+    brayns::ParametersManager parametersManager;
+    TestScene scene;
+    brayns::ProteinLoader loader;
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(parse_atom_records, ProteinFile)
+{
+    BOOST_REQUIRE(loader.importPDBFile(filename,
+                                       brayns::Vector3f(0.f, 0.f, 0.f), 0,
+                                       scene));
+
+    size_t nbSpheres = 0;
+    for (const auto& spheres : scene.getSpheres())
+        nbSpheres += spheres.second.size();
+    BOOST_CHECK_EQUAL(nbSpheres, 5);
+
+    checkAtom(MATERIAL_NITROGEN, brayns::Vector3f(1.f, 2.f, 3.f), 56.f);
+    // Two letter element of a HETATM record
+    checkAtom(MATERIAL_IRON, brayns::Vector3f(4.5f, -5.25f, 6.75f), 156.f);
+    // Missing element column, taken from the atom name
+    checkAtom(MATERIAL_CARBON, brayns::Vector3f(7.f, 8.f, 9.f), 67.f);
+    checkAtom(MATERIAL_ZINC, brayns::Vector3f(-1.5f, 0.f, 0.25f), 142.f);
+    // Unknown element
+    checkAtom(MATERIAL_UNKNOWN, brayns::Vector3f(0.f, 0.f, -2.f), 25.f);
+}
+
+BOOST_FIXTURE_TEST_CASE(parse_missing_file, ProteinFile)
+{
+    BOOST_CHECK(!loader.importPDBFile(filename + ".missing",
+                                      brayns::Vector3f(0.f, 0.f, 0.f), 0,
+                                      scene));
+    BOOST_CHECK(scene.getSpheres().empty());
+}
@@ -0,0 +1,264 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/camera/Camera.h>
+#include <brayns/common/geometry/Cylinder.h>
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/common/scene/Scene.h>
+#include <brayns/common/scene/SpatialIndex.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#define BOOST_TEST_MODULE spatialIndex
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+
+namespace
+{
+/** Scene holding geometry only, without any engine counterpart */
+class TestScene : public brayns::Scene
+{
+public:
+    TestScene(brayns::ParametersManager& parametersManager)
+        : brayns::Scene(brayns::Renderers(), parametersManager)
+    {
+    }
+
+    void commit() final {}
+    void commitMaterials(const bool) final {}
+    void commitLights() final {}
+    void buildGeometry() final {}
+    uint64_t serializeGeometry() final { return 0; }
+    void commitSimulationData() final {}
+    void commitVolumeData() final {}
+    void commitTransferFunctionData() final {}
+    void saveSceneToCacheFile() final {}
+    bool isVolumeSupported(const std::string&) const final { return false; }
+};
+
+class TestCamera : public brayns::Camera
+{
+public:
+    TestCamera()
+        : brayns::Camera(brayns::CameraType::perspective)
+    {
+    }
+
+    void commit() final {}
+    void setEnvironmentMap(const bool) final {}
+};
+
+brayns::SpherePtr createSphere(const size_t materialId,
+                               const brayns::Vector3f& center,
+                               const uint32_t gid, const uint32_t sectionId)
+{
+    auto sphere =
+        std::make_shared<brayns::Sphere>(materialId, center, 1.f, 0.f, 0.f);
+    sphere->setCellSection(gid, sectionId);
+    return sphere;
+}
+
+/**
+ * Two cells: the first one has two spheres of radius 1 at x = 0 and x = 5,
+ * the second one a sphere at x = 10 and a cylinder of radius 0.5 from
+ * (0, 5, 0) to (10, 5, 0)
+ */
+struct Fixture
+{
+    Fixture()
+        : scene(parametersManager)
+    {
+        brayns::Boxf bounds;
+        brayns::Spheres cell1{createSphere(0, brayns::Vector3f(0, 0, 0), 1, 0),
+                              createSphere(0, brayns::Vector3f(5, 0, 0), 1, 3)};
+        scene.addSpheres(0, std::move(cell1), bounds);
+        brayns::Spheres cell2{
+            createSphere(1, brayns::Vector3f(10, 0, 0), 2, 7)};
+        scene.addSpheres(1, std::move(cell2), bounds);
+
+        auto cylinder = std::make_shared<brayns::Cylinder>(
+            1, brayns::Vector3f(0, 5, 0), brayns::Vector3f(10, 5, 0), 0.5f, 0.f,
+            0.f);
+        cylinder->setCellSection(2, 8);
+        scene.getCylinders()[1].push_back(cylinder);
+    }
+
+    brayns::ParametersManager parametersManager;
+    TestScene scene;
+};
+
+bool bySection(const brayns::IndexedPrimitive& a,
+               const brayns::IndexedPrimitive& b)
+{
+    return a.sectionId < b.sectionId;
+}
+}
+
+BOOST_FIXTURE_TEST_CASE(box_query, Fixture)
+{
+    brayns::IndexedPrimitives primitives;
+    const brayns::Boxf box(brayns::Vector3f(-2, -2, -2),
+                           brayns::Vector3f(6, 2, 2));
+    BOOST_CHECK_EQUAL(scene.getSpatialIndex().queryBox(box, 10, primitives),
+                      2);
+    BOOST_REQUIRE_EQUAL(primitives.size(), 2);
+
+    std::sort(primitives.begin(), primitives.end(), bySection);
+    BOOST_CHECK_EQUAL(primitives[0].type, brayns::GT_SPHERE);
+    BOOST_CHECK_EQUAL(primitives[0].materialId, 0);
+    BOOST_CHECK_EQUAL(primitives[0].gid, 1);
+    BOOST_CHECK_EQUAL(primitives[0].sectionId, 0);
+    BOOST_CHECK(primitives[0].model.empty());
+    BOOST_CHECK_EQUAL(primitives[1].gid, 1);
+    BOOST_CHECK_EQUAL(primitives[1].sectionId, 3);
+    BOOST_CHECK_EQUAL(primitives[1].index, 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(box_query_limits_returned_primitives, Fixture)
+{
+    brayns::IndexedPrimitives primitives;
+    const brayns::Boxf box(brayns::Vector3f(-10, -10, -10),
+                           brayns::Vector3f(20, 20, 20));
+    BOOST_CHECK_EQUAL(scene.getSpatialIndex().queryBox(box, 2, primitives),
+                      4);
+    BOOST_CHECK_EQUAL(primitives.size(), 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(sphere_query, Fixture)
+{
+    auto& spatialIndex = scene.getSpatialIndex();
+    brayns::IndexedPrimitives primitives;
+    BOOST_CHECK_EQUAL(spatialIndex.querySphere(brayns::Vector3f(10, 0, 0), 1.5f,
+                                               10, primitives),
+                      1);
+    BOOST_REQUIRE_EQUAL(primitives.size(), 1);
+    BOOST_CHECK_EQUAL(primitives[0].materialId, 1);
+    BOOST_CHECK_EQUAL(primitives[0].gid, 2);
+    BOOST_CHECK_EQUAL(primitives[0].sectionId, 7);
+
+    // Between the second sphere of the first cell and the cylinder
+    primitives.clear();
+    BOOST_CHECK_EQUAL(spatialIndex.querySphere(brayns::Vector3f(5, 3, 0), 2.2f,
+                                               10, primitives),
+                      2);
+    BOOST_REQUIRE_EQUAL(primitives.size(), 2);
+    std::sort(primitives.begin(), primitives.end(), bySection);
+    BOOST_CHECK_EQUAL(primitives[0].type, brayns::GT_SPHERE);
+    BOOST_CHECK_EQUAL(primitives[0].gid, 1);
+    BOOST_CHECK_EQUAL(primitives[0].sectionId, 3);
+    BOOST_CHECK_EQUAL(primitives[1].type, brayns::GT_CYLINDER);
+    BOOST_CHECK_EQUAL(primitives[1].gid, 2);
+    BOOST_CHECK_EQUAL(primitives[1].sectionId, 8);
+
+    primitives.clear();
+    BOOST_CHECK_EQUAL(spatialIndex.querySphere(brayns::Vector3f(0, -10, 0), 1.f,
+                                               10, primitives),
+                      0);
+    BOOST_CHECK(primitives.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(picking_returns_closest_primitive, Fixture)
+{
+    auto& spatialIndex = scene.getSpatialIndex();
+    brayns::IndexedPrimitive primitive;
+    BOOST_REQUIRE(spatialIndex.intersect(brayns::Vector3f(-10, 0, 0),
+                                         brayns::Vector3f(1, 0, 0), primitive));
+    BOOST_CHECK_EQUAL(primitive.type, brayns::GT_SPHERE);
+    BOOST_CHECK_EQUAL(primitive.gid, 1);
+    BOOST_CHECK_EQUAL(primitive.sectionId, 0);
+    BOOST_CHECK_CLOSE(primitive.distance, 9.f, 1e-3f);
+    BOOST_CHECK_CLOSE(primitive.position.x(), -1.f, 1e-3f);
+
+    BOOST_REQUIRE(spatialIndex.intersect(brayns::Vector3f(20, 0, 0),
+                                         brayns::Vector3f(-2, 0, 0),
+                                         primitive));
+    BOOST_CHECK_EQUAL(primitive.gid, 2);
+    BOOST_CHECK_EQUAL(primitive.sectionId, 7);
+    BOOST_CHECK_CLOSE(primitive.distance, 9.f, 1e-3f);
+
+    BOOST_REQUIRE(spatialIndex.intersect(brayns::Vector3f(5, 20, 0),
+                                         brayns::Vector3f(0, -1, 0),
+                                         primitive));
+    BOOST_CHECK_EQUAL(primitive.type, brayns::GT_CYLINDER);
+    BOOST_CHECK_EQUAL(primitive.gid, 2);
+    BOOST_CHECK_EQUAL(primitive.sectionId, 8);
+    BOOST_CHECK_CLOSE(primitive.distance, 14.5f, 1e-3f);
+
+    BOOST_CHECK(!spatialIndex.intersect(brayns::Vector3f(0, -10, 0),
+                                        brayns::Vector3f(1, 0, 0), primitive));
+}
+
+BOOST_FIXTURE_TEST_CASE(picking_through_camera, Fixture)
+{
+    TestCamera camera;
+    camera.set(brayns::Vector3f(5, 0, 20), brayns::Vector3f(5, 0, 0),
+               brayns::Vector3f(0, 1, 0));
+
+    brayns::Vector3f origin, direction;
+    camera.getPrimaryRay(brayns::Vector2f(0.5f, 0.5f), origin, direction);
+
+    brayns::IndexedPrimitive primitive;
+    BOOST_REQUIRE(
+        scene.getSpatialIndex().intersect(origin, direction, primitive));
+    BOOST_CHECK_EQUAL(primitive.gid, 1);
+    BOOST_CHECK_EQUAL(primitive.sectionId, 3);
+    BOOST_CHECK_CLOSE(primitive.distance, 19.f, 1e-3f);
+}
+
+BOOST_FIXTURE_TEST_CASE(picking_instanced_model, Fixture)
+{
+    auto& model = scene.getInstancedModel("cell");
+    model.getSpheres()[0].push_back(
+        createSphere(0, brayns::Vector3f(0, 0, 0), 3, 2));
+    model.getBounds().merge(brayns::Vector3f(-1, -1, -1));
+    model.getBounds().merge(brayns::Vector3f(1, 1, 1));
+    brayns::Matrix4f transformation;
+    transformation.setTranslation(brayns::Vector3f(0, 0, -20));
+    scene.addInstance("cell", brayns::Matrix4f::IDENTITY);
+    scene.addInstance("cell", transformation);
+
+    brayns::IndexedPrimitive primitive;
+    BOOST_REQUIRE(scene.getSpatialIndex().intersect(
+        brayns::Vector3f(0, 0, -30), brayns::Vector3f(0, 0, 1), primitive));
+    BOOST_CHECK_EQUAL(primitive.model, "cell");
+    BOOST_CHECK_EQUAL(primitive.instance, 1);
+    BOOST_CHECK_EQUAL(primitive.gid, 3);
+    BOOST_CHECK_EQUAL(primitive.sectionId, 2);
+    BOOST_CHECK_CLOSE(primitive.distance, 9.f, 1e-3f);
+    BOOST_CHECK_CLOSE(primitive.position.z(), -21.f, 1e-3f);
+}
+
+BOOST_FIXTURE_TEST_CASE(index_follows_geometry_changes, Fixture)
+{
+    auto& spatialIndex = scene.getSpatialIndex();
+    brayns::IndexedPrimitive primitive;
+    BOOST_CHECK(!spatialIndex.intersect(brayns::Vector3f(0, -10, 0),
+                                        brayns::Vector3f(1, 0, 0), primitive));
+
+    brayns::Boxf bounds;
+    brayns::Spheres spheres{createSphere(0, brayns::Vector3f(5, -10, 0), 4, 1)};
+    scene.addSpheres(0, std::move(spheres), bounds);
+
+    BOOST_REQUIRE(spatialIndex.intersect(brayns::Vector3f(0, -10, 0),
+                                         brayns::Vector3f(1, 0, 0), primitive));
+    BOOST_CHECK_EQUAL(primitive.gid, 4);
+    BOOST_CHECK_EQUAL(primitive.sectionId, 1);
+    BOOST_CHECK_EQUAL(primitive.index, 2);
+}
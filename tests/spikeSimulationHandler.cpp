@@ -0,0 +1,137 @@
+/* Copyright (c) 2015-2017, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/simulation/SpikeSimulationHandler.h>
+#include <brayns/parameters/GeometryParameters.h>
+
+#define BOOST_TEST_MODULE spikeSimulationHandler
+#include <boost/test/unit_test.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+const uint64_t NB_FRAMES = 60;
+const uint64_t NB_NEURONS = 16;
+const int64_t DECAY_FRAMES = std::ceil(1.f / brayns::SPIKE_DECAY_PER_FRAME);
+
+/**
+ * Spikes sorted by time, with neurons spiking at different rates, a neuron
+ * outside of the frame and spikes after the last frame
+ */
+brayns::SpikeEvents createSpikes()
+{
+    brayns::SpikeEvents spikes;
+    for (uint64_t frame = 0; frame < NB_FRAMES + 5; ++frame)
+    {
+        spikes.push_back({frame + 0.25f, uint32_t(frame * 3 % NB_NEURONS)});
+        if (frame % 7 == 0)
+            spikes.push_back({frame + 0.5f, uint32_t(NB_NEURONS + 1)});
+        if (frame % 4 == 0)
+            spikes.push_back({frame + 0.75f, uint32_t(frame % 5)});
+    }
+    return spikes;
+}
+
+/** Last spike frame of every neuron, among the spikes still visible */
+brayns::floats getExpectedFrame(const brayns::SpikeEvents& spikes,
+                                const int64_t frame)
+{
+    brayns::floats data(NB_NEURONS, -1.f);
+    for (const auto& spike : spikes)
+        if (spike.frame >= frame - DECAY_FRAMES && spike.frame < frame + 1 &&
+            spike.gid < NB_NEURONS)
+            data[spike.gid] = spike.frame;
+    return data;
+}
+
+struct SpikeCache
+{
+    SpikeCache()
+        : filename((boost::filesystem::temp_directory_path() /
+                    boost::filesystem::unique_path("%%%%-%%%%.spikes"))
+                       .string())
+        , spikes(createSpikes())
+        , handler(geometryParameters)
+    {
+        brayns::SpikeSimulationHandler writer(geometryParameters);
+        writer.setNbFrames(NB_FRAMES);
+        writer.setFrameSize(NB_NEURONS);
+        BOOST_REQUIRE(writer.writeCacheFile(filename, spikes));
+        BOOST_REQUIRE(handler.attachSimulationToCacheFile(filename));
+    }
+
+    ~SpikeCache() { boost::filesystem::remove(filename); }
+
+    /**
+     * Checks the frame derived by the handler from its previous frame against
+     * a frame built from scratch by another handler, and against the spikes
+     */
+    void checkFrame(const uint64_t timestamp)
+    {
+        handler.setTimestamp(timestamp);
+        const float* data = static_cast<float*>(handler.getFrameData());
+        BOOST_REQUIRE(data);
+
+        brayns::SpikeSimulationHandler rebuilt(geometryParameters);
+        BOOST_REQUIRE(rebuilt.attachSimulationToCacheFile(filename));
+        rebuilt.setTimestamp(timestamp);
+        const float* rebuiltData =
+            static_cast<float*>(rebuilt.getFrameData());
+        BOOST_REQUIRE(rebuiltData);
+        BOOST_CHECK_EQUAL(
+            std::memcmp(data, rebuiltData, NB_NEURONS * sizeof(float)), 0);
+
+        const auto expected = getExpectedFrame(spikes, timestamp % NB_FRAMES);
+        BOOST_CHECK_EQUAL_COLLECTIONS(data, data + NB_NEURONS,
+                                      expected.begin(), expected.end());
+    }
+
+    const std::string filename;
+    const brayns::SpikeEvents spikes;
+    brayns::GeometryParameters geometryParameters;
+    brayns::SpikeSimulationHandler handler;
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(read_cache_header, SpikeCache)
+{
+    BOOST_CHECK_EQUAL(handler.getNbFrames(), NB_FRAMES);
+    BOOST_CHECK_EQUAL(handler.getFrameSize(), NB_NEURONS);
+}
+
+BOOST_FIXTURE_TEST_CASE(play_forward, SpikeCache)
+{
+    for (uint64_t frame = 0; frame < NB_FRAMES; ++frame)
+        checkFrame(frame);
+    // Back to the first frame
+    checkFrame(NB_FRAMES);
+}
+
+BOOST_FIXTURE_TEST_CASE(seek, SpikeCache)
+{
+    // Forward within the visible spikes, forward beyond them, backward and
+    // again forward after seeking back
+    for (const uint64_t frame : {3, 7, 12, 35, 38, 20, 2, 5, 59, 61})
+        checkFrame(frame);
+}